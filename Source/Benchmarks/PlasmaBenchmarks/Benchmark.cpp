@@ -0,0 +1,239 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+static volatile uint sBenchmarkSink = 0;
+
+void BenchmarkSink(uint value)
+{
+  sBenchmarkSink = sBenchmarkSink + value;
+}
+
+// BenchmarkSettings
+
+BenchmarkSettings::BenchmarkSettings() :
+    mOutputFile("BenchmarkResults.json"),
+    mSamples(20),
+    mWarmupRuns(2)
+{
+}
+
+void BenchmarkSettings::ReadCommandLine()
+{
+  mOutputFile = Environment::GetValue<String>("out", mOutputFile);
+  mFilter = Environment::GetValue<String>("filter", mFilter);
+  mSamples = Environment::GetValue<uint>("samples", mSamples);
+  mWarmupRuns = Environment::GetValue<uint>("warmup", mWarmupRuns);
+
+  if (mSamples == 0)
+    mSamples = 1;
+}
+
+// BenchmarkResult
+
+BenchmarkResult::BenchmarkResult() : mOperations(0), mMin(0.0), mMean(0.0), mMax(0.0)
+{
+}
+
+void BenchmarkResult::Finish()
+{
+  if (mSamples.Empty())
+    return;
+
+  Sort(mSamples.All());
+
+  double total = 0.0;
+  forRange (double sample, mSamples.All())
+    total += sample;
+
+  mMin = mSamples.Front();
+  mMax = mSamples.Back();
+  mMean = total / mSamples.Size();
+}
+
+double BenchmarkResult::GetPercentile(double percent) const
+{
+  if (mSamples.Empty())
+    return 0.0;
+
+  // Nearest rank, so a percentile is always one of the recorded samples
+  double position = percent / 100.0 * mSamples.Size();
+  size_t rank = (size_t)position;
+  if ((double)rank < position)
+    ++rank;
+
+  size_t index = Math::Clamp(rank, (size_t)1, mSamples.Size()) - 1;
+  return mSamples[index];
+}
+
+// Benchmark
+
+Benchmark::Benchmark(StringParam category, StringParam name, uint operations) :
+    mCategory(category),
+    mName(name),
+    mOperations(operations)
+{
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+bool Benchmark::Setup(String& skipReason)
+{
+  return true;
+}
+
+void Benchmark::Teardown()
+{
+}
+
+double Benchmark::MeasureSample()
+{
+  Timer timer;
+  Run();
+  return timer.UpdateAndGetTime() * 1000.0;
+}
+
+// BenchmarkRunner
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkSettings& settings) : mSettings(settings)
+{
+}
+
+void BenchmarkRunner::Add(Benchmark* benchmark)
+{
+  mBenchmarks.PushBack(benchmark);
+}
+
+void BenchmarkRunner::AddResult(StringParam category, StringParam name, uint operations, double milliseconds)
+{
+  if (!PassesFilter(category, name))
+    return;
+
+  BenchmarkResult& result = mResults.PushBack();
+  result.mCategory = category;
+  result.mName = name;
+  result.mOperations = operations;
+  result.mSamples.PushBack(milliseconds);
+  result.Finish();
+}
+
+void BenchmarkRunner::RunAll()
+{
+  forRange (Benchmark* benchmark, mBenchmarks.All())
+  {
+    if (PassesFilter(benchmark->mCategory, benchmark->mName))
+      RunBenchmark(benchmark);
+  }
+}
+
+void BenchmarkRunner::RunBenchmark(Benchmark* benchmark)
+{
+  ZoneScoped;
+  PlasmaPrint("Benchmark %s.%s\n", benchmark->mCategory.c_str(), benchmark->mName.c_str());
+
+  BenchmarkResult& result = mResults.PushBack();
+  result.mCategory = benchmark->mCategory;
+  result.mName = benchmark->mName;
+  result.mOperations = benchmark->mOperations;
+
+  if (!benchmark->Setup(result.mSkipReason))
+  {
+    PlasmaPrint("  Skipped: %s\n", result.mSkipReason.c_str());
+    benchmark->Teardown();
+    return;
+  }
+
+  for (uint i = 0; i < mSettings.mWarmupRuns; ++i)
+    benchmark->MeasureSample();
+
+  result.mSamples.Reserve(mSettings.mSamples);
+  for (uint i = 0; i < mSettings.mSamples; ++i)
+    result.mSamples.PushBack(benchmark->MeasureSample());
+
+  benchmark->Teardown();
+
+  result.Finish();
+  PlasmaPrint("  min %.3fms p50 %.3fms p99 %.3fms\n", result.mMin, result.GetPercentile(50.0), result.GetPercentile(99.0));
+}
+
+bool BenchmarkRunner::PassesFilter(StringParam category, StringParam name)
+{
+  if (mSettings.mFilter.Empty())
+    return true;
+
+  return BuildString(category, ".", name).Contains(mSettings.mFilter);
+}
+
+String BenchmarkRunner::ToJson()
+{
+  Lightning::JsonBuilder builder;
+  builder.Begin(Lightning::JsonType::Object);
+
+  builder.Key("build");
+  builder.Value(GetBuildVersionName());
+  builder.Key("samples");
+  builder.Value(mSettings.mSamples);
+  builder.Key("warmup");
+  builder.Value(mSettings.mWarmupRuns);
+
+  builder.Key("results");
+  builder.Begin(Lightning::JsonType::ArrayMultiLine);
+  forRange (BenchmarkResult& result, mResults.All())
+  {
+    builder.Begin(Lightning::JsonType::Object);
+    builder.Key("category");
+    builder.Value(result.mCategory);
+    builder.Key("name");
+    builder.Value(result.mName);
+    builder.Key("operations");
+    builder.Value(result.mOperations);
+
+    if (!result.mSkipReason.Empty())
+    {
+      builder.Key("skipped");
+      builder.Value(result.mSkipReason);
+    }
+    else
+    {
+      builder.Key("samples");
+      builder.Value((uint)result.mSamples.Size());
+      builder.Key("minMs");
+      builder.Value(result.mMin);
+      builder.Key("meanMs");
+      builder.Value(result.mMean);
+      builder.Key("p50Ms");
+      builder.Value(result.GetPercentile(50.0));
+      builder.Key("p90Ms");
+      builder.Value(result.GetPercentile(90.0));
+      builder.Key("p99Ms");
+      builder.Value(result.GetPercentile(99.0));
+      builder.Key("maxMs");
+      builder.Value(result.mMax);
+    }
+    builder.End();
+  }
+  builder.End();
+
+  builder.End();
+  return builder.ToString();
+}
+
+bool BenchmarkRunner::WriteResults()
+{
+  String json = ToJson();
+  size_t written = WriteToFile(mSettings.mOutputFile.c_str(), (const ::byte*)json.Data(), json.SizeInBytes());
+  if (written != json.SizeInBytes())
+  {
+    PlasmaPrint("Failed to write benchmark results to '%s'\n", mSettings.mOutputFile.c_str());
+    return false;
+  }
+
+  PlasmaPrint("Wrote %d benchmark results to '%s'\n", (int)mResults.Size(), mSettings.mOutputFile.c_str());
+  return true;
+}
+
+} // namespace Plasma
@@ -0,0 +1,105 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+/// Benchmark run settings, read from the command line:
+/// -out [file] -filter [text] -samples [count] -warmup [count]
+class BenchmarkSettings
+{
+public:
+  BenchmarkSettings();
+
+  void ReadCommandLine();
+
+  // Where the JSON results are written.
+  String mOutputFile;
+  // Only benchmarks whose "Category.Name" contains this are run.
+  String mFilter;
+  // Timed runs per benchmark.
+  uint mSamples;
+  // Untimed runs before the timed runs.
+  uint mWarmupRuns;
+};
+
+/// Timings of one benchmark in milliseconds per sample.
+class BenchmarkResult
+{
+public:
+  BenchmarkResult();
+
+  // Sorts the samples and computes the statistics.
+  void Finish();
+  // Nearest rank percentile (the samples must be finished).
+  double GetPercentile(double percent) const;
+
+  String mCategory;
+  String mName;
+  // How many operations a single sample performed.
+  uint mOperations;
+  // Set when the benchmark could not run (no samples are recorded).
+  String mSkipReason;
+  Array<double> mSamples;
+  double mMin;
+  double mMean;
+  double mMax;
+};
+
+/// A single benchmark scenario. Setup creates whatever the scenario needs,
+/// Run is timed once per sample and Teardown destroys what Setup created.
+class Benchmark
+{
+public:
+  Benchmark(StringParam category, StringParam name, uint operations);
+  virtual ~Benchmark();
+
+  // Returns false with a reason if the scenario can't run here.
+  virtual bool Setup(String& skipReason);
+  virtual void Run() = 0;
+  virtual void Teardown();
+  // Returns one sample in milliseconds (times a single Run by default).
+  virtual double MeasureSample();
+
+  String mCategory;
+  String mName;
+  // How many operations (inserts, bodies, queries, ...) a single Run performs.
+  uint mOperations;
+};
+
+/// Runs every added benchmark and writes the results as JSON.
+class BenchmarkRunner
+{
+public:
+  BenchmarkRunner(const BenchmarkSettings& settings);
+
+  // The runner takes ownership of the benchmark.
+  void Add(Benchmark* benchmark);
+  // Records a single timing that was measured elsewhere (e.g. during startup).
+  void AddResult(StringParam category, StringParam name, uint operations, double milliseconds);
+
+  void RunAll();
+
+  String ToJson();
+  // Returns false if the results file could not be written.
+  bool WriteResults();
+
+  BenchmarkSettings mSettings;
+  OwnedArray<Benchmark*> mBenchmarks;
+  Array<BenchmarkResult> mResults;
+
+private:
+  bool PassesFilter(StringParam category, StringParam name);
+  void RunBenchmark(Benchmark* benchmark);
+};
+
+// Keeps the optimizer from removing work whose result is otherwise unused.
+void BenchmarkSink(uint value);
+
+// Each adds the benchmarks defined in its *Benchmarks.cpp file.
+void AddCoreBenchmarks(BenchmarkRunner& runner);
+void AddPhysicsBenchmarks(BenchmarkRunner& runner);
+void AddNetworkingBenchmarks(BenchmarkRunner& runner);
+void AddSoundBenchmarks(BenchmarkRunner& runner);
+
+} // namespace Plasma
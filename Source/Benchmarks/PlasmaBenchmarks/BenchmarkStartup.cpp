@@ -0,0 +1,73 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+BenchmarkStartup::BenchmarkStartup() : mRunner(nullptr)
+{
+}
+
+BenchmarkStartup::~BenchmarkStartup()
+{
+  SafeDelete(mRunner);
+}
+
+void BenchmarkStartup::UserInitialize()
+{
+  Debugger::Enabled = false;
+
+  BenchmarkSettings settings;
+  settings.ReadCommandLine();
+  mRunner = new BenchmarkRunner(settings);
+
+  // The renderer (which content uploads through) still needs a window, so
+  // create a small one that is never shown.
+  mWindowSize = IntVec2(320, 240);
+  mMinimumWindowSize = IntVec2(320, 240);
+  mWindowCentered = false;
+  mWindowState = WindowState::Windowed;
+  mWindowStyle = (WindowStyleFlags::Enum)(WindowStyleFlags::MainWindow | WindowStyleFlags::NotVisible);
+  mUseSplashScreen = false;
+}
+
+void BenchmarkStartup::UserStartup()
+{
+  Array<String> coreLibs;
+
+  coreLibs.PushBack("FragmentCore");
+  coreLibs.PushBack("Loading");
+  coreLibs.PushBack("PlasmaCore");
+
+  PL::gContentSystem->EnumerateLibraries();
+  PL::gContentSystem->PlasmaCoreLibraryNames = coreLibs;
+
+  // Loading happens once per run, so each library is a single sample
+  forRange (String& libraryName, coreLibs.All())
+  {
+    Timer timer;
+    LoadContentLibrary(libraryName);
+    double milliseconds = timer.UpdateAndGetTime() * 1000.0;
+
+    ResourceLibrary* library = PL::gResources->GetResourceLibrary(libraryName);
+    uint resourceCount = library ? (uint)library->Resources.Size() : 0;
+    mRunner->AddResult("Resources", BuildString("LoadPackage.", libraryName), resourceCount, milliseconds);
+  }
+}
+
+void BenchmarkStartup::UserCreation()
+{
+  AddCoreBenchmarks(*mRunner);
+  AddPhysicsBenchmarks(*mRunner);
+  AddNetworkingBenchmarks(*mRunner);
+  AddSoundBenchmarks(*mRunner);
+
+  mRunner->RunAll();
+
+  sReturnCode = mRunner->WriteResults() ? 0 : 1;
+
+  // Let the engine shut down normally after its next update
+  PL::gEngine->Terminate();
+}
+
+} // namespace Plasma
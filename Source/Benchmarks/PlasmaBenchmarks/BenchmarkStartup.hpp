@@ -0,0 +1,25 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+/// Starts the engine without a visible window, runs every benchmark once the
+/// core content is loaded, writes the results and then shuts down.
+/// The return code is 0 if the results were written.
+class BenchmarkStartup : public PlasmaStartup
+{
+public:
+  BenchmarkStartup();
+  ~BenchmarkStartup();
+
+protected:
+  void UserInitialize() override;
+  void UserStartup() override;
+  void UserCreation() override;
+
+private:
+  BenchmarkRunner* mRunner;
+};
+
+} // namespace Plasma
@@ -0,0 +1,426 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+const uint cContainerCount = 100000;
+const uint cAllocationCount = 100000;
+// How many allocations each churn loop keeps alive at once.
+const uint cLiveAllocationCount = 256;
+const uint cScratchAllocationCount = 10000;
+const uint cStringAppendCount = 10000;
+const uint cScriptLoopCount = 1000000;
+const uint cSerializedCogCount = 1000;
+
+// Containers
+
+class ArrayPushBackBenchmark : public Benchmark
+{
+public:
+  ArrayPushBackBenchmark() : Benchmark("Containers", "Array.PushBack", cContainerCount)
+  {
+  }
+
+  void Run() override
+  {
+    Array<uint> values;
+    for (uint i = 0; i < cContainerCount; ++i)
+      values.PushBack(i);
+    BenchmarkSink(values.Back());
+  }
+};
+
+class ArrayIterateBenchmark : public Benchmark
+{
+public:
+  ArrayIterateBenchmark() : Benchmark("Containers", "Array.Iterate", cContainerCount)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    mValues.Resize(cContainerCount);
+    for (uint i = 0; i < cContainerCount; ++i)
+      mValues[i] = i;
+    return true;
+  }
+
+  void Run() override
+  {
+    uint total = 0;
+    forRange (uint value, mValues.All())
+      total += value;
+    BenchmarkSink(total);
+  }
+
+  void Teardown() override
+  {
+    mValues.Clear();
+  }
+
+  Array<uint> mValues;
+};
+
+// The same random keys are used for every map type so they can be compared.
+static void GenerateKeys(Array<uint>& keys, uint count, int seed)
+{
+  Math::Random random(seed);
+  keys.Resize(count);
+  for (uint i = 0; i < count; ++i)
+    keys[i] = random.Uint32();
+}
+
+template <typename MapType>
+class MapInsertBenchmark : public Benchmark
+{
+public:
+  MapInsertBenchmark(StringParam name) : Benchmark("Containers", name, cContainerCount)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    GenerateKeys(mKeys, cContainerCount, 1);
+    return true;
+  }
+
+  void Run() override
+  {
+    MapType map;
+    forRange (uint key, mKeys.All())
+      map.Insert(key, key);
+    BenchmarkSink((uint)map.Size());
+  }
+
+  void Teardown() override
+  {
+    mKeys.Clear();
+  }
+
+  Array<uint> mKeys;
+};
+
+// Half of the lookups hit and half miss.
+template <typename MapType>
+class MapFindBenchmark : public Benchmark
+{
+public:
+  MapFindBenchmark(StringParam name) : Benchmark("Containers", name, cContainerCount * 2)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    GenerateKeys(mKeys, cContainerCount, 1);
+    GenerateKeys(mMissingKeys, cContainerCount, 2);
+    forRange (uint key, mKeys.All())
+      mMap.Insert(key, key);
+    return true;
+  }
+
+  void Run() override
+  {
+    uint found = 0;
+    for (uint i = 0; i < cContainerCount; ++i)
+    {
+      if (mMap.FindPointer(mKeys[i]) != nullptr)
+        ++found;
+      if (mMap.FindPointer(mMissingKeys[i]) != nullptr)
+        ++found;
+    }
+    BenchmarkSink(found);
+  }
+
+  void Teardown() override
+  {
+    mMap.Clear();
+    mKeys.Clear();
+    mMissingKeys.Clear();
+  }
+
+  MapType mMap;
+  Array<uint> mKeys;
+  Array<uint> mMissingKeys;
+};
+
+class StringBuilderBenchmark : public Benchmark
+{
+public:
+  StringBuilderBenchmark() : Benchmark("Containers", "StringBuilder.Append", cStringAppendCount)
+  {
+  }
+
+  void Run() override
+  {
+    StringBuilder builder;
+    for (uint i = 0; i < cStringAppendCount; ++i)
+      builder.AppendFormat("%u,", i);
+    String result = builder.ToString();
+    BenchmarkSink((uint)result.SizeInBytes());
+  }
+};
+
+// Memory
+
+// Allocates and frees random sizes while keeping a fixed number alive. Goes
+// through the global heap (and so the SizeClassAllocator) like engine containers do.
+static uint ChurnAllocations(const Array<uint>& sizes, const Array<uint>& slots, uint begin, uint end)
+{
+  Memory::Heap* heap = Memory::GetGlobalHeap();
+  MemPtr live[cLiveAllocationCount] = {};
+  uint liveSizes[cLiveAllocationCount] = {};
+  for (uint i = begin; i < end; ++i)
+  {
+    uint slot = slots[i];
+    if (live[slot] != nullptr)
+      heap->Deallocate(live[slot], liveSizes[slot]);
+    live[slot] = heap->Allocate(sizes[i]);
+    liveSizes[slot] = sizes[i];
+  }
+
+  for (uint i = 0; i < cLiveAllocationCount; ++i)
+  {
+    if (live[i] != nullptr)
+      heap->Deallocate(live[i], liveSizes[i]);
+  }
+  return end - begin;
+}
+
+class AllocatorChurnBenchmark : public Benchmark
+{
+public:
+  AllocatorChurnBenchmark(StringParam name, bool parallel) :
+      Benchmark("Memory", name, cAllocationCount),
+      mParallel(parallel)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    Math::Random random(3);
+    mSizes.Resize(cAllocationCount);
+    mSlots.Resize(cAllocationCount);
+    for (uint i = 0; i < cAllocationCount; ++i)
+    {
+      mSizes[i] = (uint)random.IntRangeInIn(8, 1024);
+      mSlots[i] = (uint)random.IntRangeInEx(0, cLiveAllocationCount);
+    }
+    return true;
+  }
+
+  void Run() override
+  {
+    if (mParallel)
+      PL::gJobs->ParallelFor(0, cAllocationCount, *this);
+    else
+      BenchmarkSink(ChurnAllocations(mSizes, mSlots, 0, cAllocationCount));
+  }
+
+  void Teardown() override
+  {
+    mSizes.Clear();
+    mSlots.Clear();
+  }
+
+  // Called on every worker for a chunk of the allocations.
+  void operator()(uint begin, uint end)
+  {
+    ChurnAllocations(mSizes, mSlots, begin, end);
+  }
+
+  bool mParallel;
+  Array<uint> mSizes;
+  Array<uint> mSlots;
+};
+
+// Allocates small blocks and frees them in reverse, as per frame scratch
+// memory is used. Compares the frame arena against the regular heap.
+class ScratchAllocationBenchmark : public Benchmark
+{
+public:
+  ScratchAllocationBenchmark(StringParam name, bool frameArena) :
+      Benchmark("Memory", name, cScratchAllocationCount),
+      mFrameArena(frameArena)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    mAllocations.Resize(cScratchAllocationCount);
+    return true;
+  }
+
+  void Run() override
+  {
+    const size_t size = 64;
+    Memory::Heap* heap = Memory::GetGlobalHeap();
+    for (uint i = 0; i < cScratchAllocationCount; ++i)
+      mAllocations[i] = mFrameArena ? FrameArena::Allocate(size) : heap->Allocate(size);
+
+    for (uint i = cScratchAllocationCount; i > 0; --i)
+    {
+      if (mFrameArena)
+        FrameArena::Deallocate(mAllocations[i - 1], size);
+      else
+        heap->Deallocate(mAllocations[i - 1], size);
+    }
+  }
+
+  void Teardown() override
+  {
+    mAllocations.Clear();
+  }
+
+  bool mFrameArena;
+  Array<MemPtr> mAllocations;
+};
+
+// Lightning
+
+class ScriptLoopBenchmark : public Benchmark
+{
+public:
+  ScriptLoopBenchmark() : Benchmark("Lightning", "VmLoop", cScriptLoopCount), mState(nullptr), mFunction(nullptr)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    String code = "class BenchmarkLoop\n"
+                  "{\n"
+                  "  [Static]\n"
+                  "  function Run(count : Integer) : Integer\n"
+                  "  {\n"
+                  "    var total = 0;\n"
+                  "    for (var i = 0; i < count; ++i)\n"
+                  "      total += i % 7;\n"
+                  "    return total;\n"
+                  "  }\n"
+                  "}\n";
+
+    String errors;
+    Project project;
+    EventConnect(&project, Events::CompilationError, OutputErrorStringCallback, &errors);
+    project.AddCodeFromString(code);
+
+    Module dependencies;
+    mLibrary = project.Compile("BenchmarkLoop", dependencies, EvaluationMode::Project);
+    if (mLibrary == nullptr)
+    {
+      skipReason = BuildString("Failed to compile the benchmark script: ", errors);
+      return false;
+    }
+
+    dependencies.PushBack(mLibrary);
+    mState = dependencies.Link();
+
+    BoundType* type = mLibrary->BoundTypes.FindValue("BenchmarkLoop", nullptr);
+    Array<Type*> parameters;
+    parameters.PushBack(LightningTypeId(int));
+    mFunction = type->FindFunction("Run", parameters, LightningTypeId(int), FindMemberOptions::Static);
+    return true;
+  }
+
+  void Run() override
+  {
+    Call call(mFunction, mState);
+    call.Set(0, (int)cScriptLoopCount);
+    ExceptionReport report;
+    call.Invoke(report);
+    BenchmarkSink((uint)call.Get<int>(Call::Return));
+  }
+
+  void Teardown() override
+  {
+    SafeDelete(mState);
+    mFunction = nullptr;
+    mLibrary = nullptr;
+  }
+
+  LibraryRef mLibrary;
+  ExecutableState* mState;
+  Function* mFunction;
+};
+
+// Serialization
+
+// Saves a space full of cubes to a data tree string (or parses that string).
+class DataTreeBenchmark : public Benchmark
+{
+public:
+  DataTreeBenchmark(StringParam name, bool parse) :
+      Benchmark("Serialization", name, cSerializedCogCount),
+      mParse(parse),
+      mSpace(nullptr)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    mSpace = PL::gFactory->CreateSpace(CoreArchetypes::DefaultSpace, CreationFlags::Default, nullptr);
+    for (uint i = 0; i < cSerializedCogCount; ++i)
+      mSpace->CreateAt(CoreArchetypes::Cube, Vec3(real(i), 0, 0));
+
+    mText = Save();
+    return true;
+  }
+
+  void Run() override
+  {
+    if (!mParse)
+    {
+      BenchmarkSink((uint)Save().SizeInBytes());
+      return;
+    }
+
+    Status status;
+    DataTreeLoader loader;
+    loader.OpenBuffer(status, mText);
+    BenchmarkSink(status.Succeeded());
+  }
+
+  void Teardown() override
+  {
+    if (mSpace)
+      mSpace->Destroy();
+    PL::gTracker->ClearDeletedObjects();
+    mSpace = nullptr;
+    mText.Clear();
+  }
+
+  String Save()
+  {
+    TextSaver saver;
+    saver.OpenBuffer();
+    CogSerialization::SaveSpaceToStream(saver, mSpace);
+    return saver.GetString();
+  }
+
+  bool mParse;
+  Space* mSpace;
+  String mText;
+};
+
+void AddCoreBenchmarks(BenchmarkRunner& runner)
+{
+  runner.Add(new ArrayPushBackBenchmark());
+  runner.Add(new ArrayIterateBenchmark());
+  runner.Add(new MapInsertBenchmark<HashMap<uint, uint>>("HashMap.Insert"));
+  runner.Add(new MapInsertBenchmark<FlatHashMap<uint, uint>>("FlatHashMap.Insert"));
+  runner.Add(new MapFindBenchmark<HashMap<uint, uint>>("HashMap.Find"));
+  runner.Add(new MapFindBenchmark<FlatHashMap<uint, uint>>("FlatHashMap.Find"));
+  runner.Add(new StringBuilderBenchmark());
+
+  runner.Add(new AllocatorChurnBenchmark("AllocatorChurn", false));
+  runner.Add(new AllocatorChurnBenchmark("AllocatorChurn.Parallel", true));
+  runner.Add(new ScratchAllocationBenchmark("Scratch.Heap", false));
+  runner.Add(new ScratchAllocationBenchmark("Scratch.FrameArena", true));
+
+  runner.Add(new ScriptLoopBenchmark());
+
+  runner.Add(new DataTreeBenchmark("DataTree.Save", false));
+  runner.Add(new DataTreeBenchmark("DataTree.Parse", true));
+}
+
+} // namespace Plasma
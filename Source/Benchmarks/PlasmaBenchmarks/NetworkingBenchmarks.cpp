@@ -0,0 +1,78 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+const uint cReplicaPropertyCount = 10000;
+// One in this many properties changes between sweeps.
+const uint cChangedPropertyInterval = 10;
+
+// Sweeps Vec3 replica properties for changes the way a replicator does every
+// frame (compare each against its last value, then observe the changed ones).
+class ChangeDetectionBenchmark : public Benchmark
+{
+public:
+  ChangeDetectionBenchmark() :
+      Benchmark("Networking", "ReplicaProperty.ChangeDetection", cReplicaPropertyCount),
+      mPropertyType(nullptr),
+      mFrame(0)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    mPropertyType = new ReplicaPropertyType(
+        "Vec3", NativeTypeOf(Vec3), SerializeKnownExtendedVariant, GetDataValue<Vec3>, SetDataValue<Vec3>);
+
+    // The values must not move once properties point at them
+    mValues.Resize(cReplicaPropertyCount, Vec3::cZero);
+    mProperties.Reserve(cReplicaPropertyCount);
+    for (uint i = 0; i < cReplicaPropertyCount; ++i)
+    {
+      ReplicaProperty* property = new ReplicaProperty(String::Format("Property%u", i), mPropertyType, Variant(&mValues[i]));
+      property->UpdateLastValue(true);
+      mProperties.PushBack(property);
+    }
+    return true;
+  }
+
+  void Run() override
+  {
+    // Move a different set of values before every sweep (the writes are
+    // trivial next to the sweep itself)
+    ++mFrame;
+    for (uint i = mFrame % cChangedPropertyInterval; i < cReplicaPropertyCount; i += cChangedPropertyInterval)
+      mValues[i].x += real(1);
+
+    uint changed = 0;
+    forRange (ReplicaProperty* property, mProperties.All())
+    {
+      if (property->HasChanged())
+      {
+        property->UpdateLastValue(false);
+        ++changed;
+      }
+    }
+    BenchmarkSink(changed);
+  }
+
+  void Teardown() override
+  {
+    DeleteObjectsInContainer(mProperties);
+    SafeDelete(mPropertyType);
+    mValues.Clear();
+  }
+
+  ReplicaPropertyType* mPropertyType;
+  Array<ReplicaProperty*> mProperties;
+  Array<Vec3> mValues;
+  uint mFrame;
+};
+
+void AddNetworkingBenchmarks(BenchmarkRunner& runner)
+{
+  runner.Add(new ChangeDetectionBenchmark());
+}
+
+} // namespace Plasma
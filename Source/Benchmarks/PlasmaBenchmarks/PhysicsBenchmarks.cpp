@@ -0,0 +1,193 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// The pile is a grid of columns cPileWidth x cPileWidth wide and cPileHeight tall.
+const uint cPileWidth = 25;
+const uint cPileHeight = 16;
+const uint cPileBodyCount = cPileWidth * cPileWidth * cPileHeight;
+const uint cQueryBodyCount = 10000;
+const uint cQueryCount = 1000;
+// Queried bodies are scattered in a cube this wide around the origin.
+const real cQueryExtent = real(200);
+const real cTimestep = real(1.0 / 60.0);
+
+// Base for benchmarks that need a space with physics in it.
+class PhysicsBenchmark : public Benchmark
+{
+public:
+  PhysicsBenchmark(StringParam name, uint operations) :
+      Benchmark("Physics", name, operations),
+      mSpace(nullptr),
+      mPhysicsSpace(nullptr)
+  {
+  }
+
+  void CreateSpace()
+  {
+    mSpace = PL::gFactory->CreateSpace(CoreArchetypes::DefaultSpace, CreationFlags::Default, nullptr);
+    mPhysicsSpace = mSpace->has(PhysicsSpace);
+  }
+
+  Cog* CreateStaticCube(Vec3Param position, Vec3Param scale)
+  {
+    Cog* cube = mSpace->CreateAt(CoreArchetypes::Cube, position, scale);
+    cube->has(RigidBody)->SetDynamicState(RigidBodyDynamicState::Static);
+    return cube;
+  }
+
+  // Runs a single physics update (including broadphase insertion of new bodies).
+  void Step()
+  {
+    UpdateEvent updateEvent(cTimestep, real(1) / cTimestep, 0, 0);
+    mPhysicsSpace->SystemLogicUpdate(&updateEvent);
+  }
+
+  void Teardown() override
+  {
+    if (mSpace)
+      mSpace->Destroy();
+    PL::gTracker->ClearDeletedObjects();
+    mSpace = nullptr;
+    mPhysicsSpace = nullptr;
+  }
+
+  Space* mSpace;
+  PhysicsSpace* mPhysicsSpace;
+};
+
+// Steps a pile of boxes resting on a static ground. The warmup steps let the
+// pile start settling, so samples include broadphase, contacts and islands.
+class PileBenchmark : public PhysicsBenchmark
+{
+public:
+  PileBenchmark(StringParam name, PhysicsSolverType::Enum solverType) :
+      PhysicsBenchmark(name, cPileBodyCount),
+      mSolverType(solverType)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    CreateSpace();
+
+    HandleOf<PhysicsSolverConfig> config = mPhysicsSpace->GetPhysicsSolverConfig()->RuntimeClone();
+    config->SetSolverType(mSolverType);
+    mPhysicsSpace->SetPhysicsSolverConfig(config);
+
+    real groundSize = real(cPileWidth * 4);
+    CreateStaticCube(Vec3(0, -0.5f, 0), Vec3(groundSize, 1, groundSize));
+
+    real spacing = real(1.05);
+    real offset = spacing * real(cPileWidth) * real(0.5);
+    for (uint y = 0; y < cPileHeight; ++y)
+    {
+      for (uint z = 0; z < cPileWidth; ++z)
+      {
+        for (uint x = 0; x < cPileWidth; ++x)
+        {
+          Vec3 position(x * spacing - offset, real(0.55) + y * spacing, z * spacing - offset);
+          mSpace->CreateAt(CoreArchetypes::Cube, position);
+        }
+      }
+    }
+
+    // Insert everything into the broadphase before sampling
+    Step();
+    return true;
+  }
+
+  void Run() override
+  {
+    Step();
+  }
+
+  PhysicsSolverType::Enum mSolverType;
+};
+
+// Static boxes scattered at random for broadphase queries.
+class QueryBenchmark : public PhysicsBenchmark
+{
+public:
+  QueryBenchmark(StringParam name, bool castRays) : PhysicsBenchmark(name, cQueryCount), mCastRays(castRays)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    CreateSpace();
+
+    Math::Random random(4);
+    real halfExtent = cQueryExtent * real(0.5);
+    for (uint i = 0; i < cQueryBodyCount; ++i)
+    {
+      Vec3 position(random.FloatRange(-halfExtent, halfExtent),
+                    random.FloatRange(-halfExtent, halfExtent),
+                    random.FloatRange(-halfExtent, halfExtent));
+      CreateStaticCube(position, Vec3(1, 1, 1));
+    }
+    mPhysicsSpace->FlushPhysicsQueue();
+
+    // Rays start inside the cube and point in random directions
+    mPoints.Resize(cQueryCount);
+    mDirections.Resize(cQueryCount);
+    for (uint i = 0; i < cQueryCount; ++i)
+    {
+      mPoints[i] = Vec3(random.FloatRange(-halfExtent, halfExtent),
+                        random.FloatRange(-halfExtent, halfExtent),
+                        random.FloatRange(-halfExtent, halfExtent));
+      mDirections[i] = random.PointOnUnitSphere();
+    }
+    return true;
+  }
+
+  void Run() override
+  {
+    uint hits = 0;
+    if (mCastRays)
+    {
+      CastResults results(4);
+      for (uint i = 0; i < cQueryCount; ++i)
+      {
+        results.Clear();
+        mPhysicsSpace->CastRay(Ray(mPoints[i], mDirections[i]), results);
+        hits += (uint)results.Size();
+      }
+    }
+    else
+    {
+      CastResults results(32);
+      for (uint i = 0; i < cQueryCount; ++i)
+      {
+        results.Clear();
+        mPhysicsSpace->CastAabb(Aabb(mPoints[i], Vec3(4, 4, 4)), results);
+        hits += (uint)results.Size();
+      }
+    }
+    BenchmarkSink(hits);
+  }
+
+  void Teardown() override
+  {
+    PhysicsBenchmark::Teardown();
+    mPoints.Clear();
+    mDirections.Clear();
+  }
+
+  bool mCastRays;
+  Array<Vec3> mPoints;
+  Array<Vec3> mDirections;
+};
+
+void AddPhysicsBenchmarks(BenchmarkRunner& runner)
+{
+  runner.Add(new PileBenchmark("Pile10k.Step", PhysicsSolverType::Basic));
+  runner.Add(new PileBenchmark("Pile10k.Step.Normal", PhysicsSolverType::Normal));
+  runner.Add(new PileBenchmark("Pile10k.Step.Simd", PhysicsSolverType::Simd));
+  runner.Add(new QueryBenchmark("Broadphase.CastRay", true));
+  runner.Add(new QueryBenchmark("Broadphase.CastAabb", false));
+}
+
+} // namespace Plasma
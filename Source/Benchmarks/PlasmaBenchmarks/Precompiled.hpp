@@ -0,0 +1,7 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+#include "Core/Startup/StartupStandard.hpp"
+
+#include "Benchmark.hpp"
+#include "BenchmarkStartup.hpp"
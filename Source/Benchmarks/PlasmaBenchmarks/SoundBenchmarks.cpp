@@ -0,0 +1,111 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+const uint cSoundEmitterCount = 128;
+// How long to wait for the mix thread before deciding it isn't running.
+const double cMixTimeout = 1.0;
+
+// Mixing happens on the mix thread at the rate the output device asks for it,
+// so instead of timing a call this samples how long each new mix took.
+class EmitterMixBenchmark : public Benchmark
+{
+public:
+  EmitterMixBenchmark() : Benchmark("Sound", "Mix.Emitters", cSoundEmitterCount), mSpace(nullptr), mWasMuted(false)
+  {
+  }
+
+  bool Setup(String& skipReason) override
+  {
+    if (!ThreadingEnabled)
+    {
+      skipReason = "Audio is only mixed on a thread when threading is enabled";
+      return false;
+    }
+
+    // Everything is still mixed, just not heard
+    mWasMuted = PL::gSound->GetMuteAllAudio();
+    PL::gSound->SetMuteAllAudio(true);
+
+    mSpace = PL::gFactory->CreateSpace(CoreArchetypes::DefaultSpace, CreationFlags::Default, nullptr);
+    Cog* listener = mSpace->CreateAt(CoreArchetypes::Transform, Vec3::cZero);
+    listener->AddComponentByName("SoundListener");
+
+    Math::Random random(5);
+    for (uint i = 0; i < cSoundEmitterCount; ++i)
+    {
+      Cog* cog = mSpace->CreateAt(CoreArchetypes::Transform, random.PointInUnitSphere() * real(10));
+      cog->AddComponentByName("SoundEmitter");
+      SoundEmitter* emitter = cog->has(SoundEmitter);
+
+      GeneratedWaveNode* wave = SoundSystem::GeneratedWaveNode();
+      wave->SetWaveFrequency(random.FloatRange(110.0f, 880.0f));
+      wave->SetVolume(0.1f);
+      emitter->GetInputNode()->AddInputNode(wave);
+      wave->Play();
+      mWaves.PushBack(wave);
+    }
+
+    if (WaitForMix() < 0.0)
+    {
+      skipReason = "The mix thread is not running (no audio output device?)";
+      return false;
+    }
+    return true;
+  }
+
+  void Run() override
+  {
+  }
+
+  double MeasureSample() override
+  {
+    double seconds = WaitForMix();
+    return seconds < 0.0 ? 0.0 : seconds * 1000.0;
+  }
+
+  void Teardown() override
+  {
+    forRange (HandleOf<GeneratedWaveNode>& wave, mWaves.All())
+      wave->Stop();
+    mWaves.Clear();
+
+    if (mSpace)
+      mSpace->Destroy();
+    PL::gTracker->ClearDeletedObjects();
+    mSpace = nullptr;
+
+    PL::gSound->SetMuteAllAudio(mWasMuted);
+  }
+
+  // Waits for a mix that started after this call and returns how long it took
+  // in seconds, or -1 if no mix happened in time.
+  double WaitForMix()
+  {
+    AudioMixer& mixer = PL::gSound->Mixer;
+    int start = mixer.GetMixCount();
+
+    // The mix in progress may have started before the call
+    Timer timer;
+    while (mixer.GetMixCount() < start + 2)
+    {
+      if (timer.UpdateAndGetTime() > cMixTimeout)
+        return -1.0;
+      Os::Sleep(1);
+    }
+    return mixer.GetLastMixTime();
+  }
+
+  Space* mSpace;
+  Array<HandleOf<GeneratedWaveNode>> mWaves;
+  bool mWasMuted;
+};
+
+void AddSoundBenchmarks(BenchmarkRunner& runner)
+{
+  runner.Add(new EmitterMixBenchmark());
+}
+
+} // namespace Plasma
@@ -15,6 +15,8 @@ const String sEditorGuid = "51392222-AEDE-4530-8749-9DFAB5725FD7";
 const String sEditorName = "Editor";
 const String sLauncherGuid = "7489829B-8A03-4B26-B3AC-FDDC6668BAF7";
 const String sLauncherName = "Launcher";
+const String sBenchmarksGuid = "C10B71AA-2E46-4ABC-8E95-57533E85C900";
+const String sBenchmarksName = "Benchmarks";
 
 
 String GetEditorFullName()
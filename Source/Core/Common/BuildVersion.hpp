@@ -11,6 +11,8 @@ extern const String sEditorGuid;
 extern const String sEditorName;
 extern const String sLauncherGuid;
 extern const String sLauncherName;
+extern const String sBenchmarksGuid;
+extern const String sBenchmarksName;
 
 String GetEditorFullName();
 String GetEditorExecutableFileName();
@@ -94,13 +94,16 @@ typedef double MaxAlignmentType;
 #include "Hashing.hpp"
 #include "HashMap.hpp"
 #include "HashSet.hpp"
+#include "FlatHashMap.hpp"
 #include "SlotMap.hpp"
 #include "Block.hpp"
 #include "Graph.hpp"
+#include "SizeClassAllocator.hpp"
 #include "Heap.hpp"
 #include "LocalStackAllocator.hpp"
 #include "Memory.hpp"
 #include "Pool.hpp"
+#include "FrameArena.hpp"
 #include "Stack.hpp"
 #include "Permuter.hpp"
 #include "Rune.hpp"
@@ -219,6 +222,7 @@ namespace Plasma
 #include "OsHandle.hpp"
 #include "Thread.hpp"
 #include "ThreadSync.hpp"
+#include "MpscQueue.hpp"
 #include "CrashHandler.hpp"
 #include "Debug.hpp"
 #include "DebugSymbolInformation.hpp"
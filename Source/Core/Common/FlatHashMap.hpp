@@ -0,0 +1,772 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+#include "ContainerCommon.hpp"
+#include "Hashing.hpp"
+#include "Allocator.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define PlasmaFlatHashSse2
+#  include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace Plasma
+{
+
+// Number of control bytes tested at once while probing.
+const size_t cFlatHashGroupWidth = 16;
+// Control byte of an empty slot. Full slots store the low 7 bits of the hash.
+const ::byte cFlatHashEmpty = 0x80;
+
+// Index of the lowest set bit in a non zero mask.
+inline size_t FlatHashLowestBit(u32 mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return (size_t)index;
+#elif defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_ctz(mask);
+#else
+  size_t index = 0;
+  while ((mask & 1) == 0)
+  {
+    mask >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+// Spreads the bits of a hash so that both the slot index (high bits)
+// and the control byte (low 7 bits) are usable even for identity hashes.
+inline u64 FlatHashMix(size_t hash)
+{
+  u64 mixed = (u64)hash * 0x9E3779B97F4A7C15ull;
+  return mixed ^ (mixed >> 32);
+}
+
+// Bit i of the result is set if control[i] == value.
+inline u32 FlatHashMatch(const ::byte* control, ::byte value)
+{
+#if defined(PlasmaFlatHashSse2)
+  __m128i group = _mm_loadu_si128((const __m128i*)control);
+  return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)value)));
+#else
+  u32 mask = 0;
+  for (size_t i = 0; i < cFlatHashGroupWidth; ++i)
+    mask |= (u32)(control[i] == value) << i;
+  return mask;
+#endif
+}
+
+// Bit i of the result is set if slot i is empty.
+inline u32 FlatHashMatchEmpty(const ::byte* control)
+{
+#if defined(PlasmaFlatHashSse2)
+  // Only empty control bytes have the high bit set.
+  return (u32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)control));
+#else
+  return FlatHashMatch(control, cFlatHashEmpty);
+#endif
+}
+
+/// Flat Hash Map is an open addressing Associative Hashed Container.
+// Keys and values are stored in a single slot array next to an array of
+// control bytes (the low 7 bits of each slot's hash or cFlatHashEmpty).
+// Lookups compare 16 control bytes at a time and only touch the slots whose
+// control byte matches. Slots are linearly probed, so erasing shifts the
+// following entries back instead of leaving tombstones. Exposes the same
+// range API as HashMap so a map can switch by changing its typedef. As with
+// HashMap, inserting and erasing invalidates ranges and value pointers.
+template <typename KeyType,
+          typename DataType,
+          typename Hasher = HashPolicy<KeyType>,
+          typename Allocator = DefaultAllocator>
+class PlasmaSharedTemplate FlatHashMap : public AllocationContainer<Allocator>
+{
+public:
+  typedef KeyType key_type;
+  typedef DataType data_type;
+  typedef FlatHashMap<KeyType, DataType, Hasher, Allocator> this_type;
+  typedef Pair<KeyType, DataType> value_type;
+  typedef Pair<KeyType, DataType> pair;
+  typedef size_t size_type;
+  typedef data_type& reference;
+  typedef AllocationContainer<Allocator> base_type;
+  using base_type::mAllocator;
+
+  struct InsertResult
+  {
+    bool mIsNewInsert;
+    value_type* mValue;
+
+    InsertResult(bool newInsert, value_type* value) : mIsNewInsert(newInsert), mValue(value)
+    {
+    }
+
+    operator bool() const
+    {
+      return mIsNewInsert;
+    }
+  };
+
+  // Range over every full slot.
+  struct range
+  {
+    typedef typename this_type::value_type value_type;
+    typedef value_type& FrontResult;
+
+    range() : mBegin(nullptr), mEnd(nullptr), mControl(nullptr), mSize(0)
+    {
+    }
+
+    range(value_type* rbegin, value_type* rend, const ::byte* control, size_t size) :
+        mBegin(rbegin),
+        mEnd(rend),
+        mControl(control),
+        mSize(size)
+    {
+      SkipEmpty();
+    }
+
+    bool Empty()
+    {
+      return mBegin == mEnd;
+    }
+
+    value_type& Front()
+    {
+      return *mBegin;
+    }
+
+    void PopFront()
+    {
+      ErrorIf(Empty(), "Popped an empty range.");
+      ++mBegin;
+      ++mControl;
+      --mSize;
+      SkipEmpty();
+    }
+
+    size_t Length()
+    {
+      return mSize;
+    }
+
+    size_type Size()
+    {
+      return Length();
+    }
+
+    range& All()
+    {
+      return *this;
+    }
+
+    range begin()
+    {
+      return *this;
+    }
+    range end()
+    {
+      return range(mEnd, mEnd, nullptr, 0);
+    }
+
+    bool operator==(const range& rhs) const
+    {
+      return mBegin == rhs.mBegin && mEnd == rhs.mEnd;
+    }
+    bool operator!=(const range& rhs) const
+    {
+      return !(*this == rhs);
+    }
+    range& operator++()
+    {
+      PopFront();
+      return *this;
+    }
+    value_type& operator*()
+    {
+      return Front();
+    }
+
+  private:
+    void SkipEmpty()
+    {
+      while (mBegin != mEnd && *mControl == cFlatHashEmpty)
+      {
+        ++mBegin;
+        ++mControl;
+      }
+    }
+
+    value_type* mBegin;
+    value_type* mEnd;
+    const ::byte* mControl;
+    size_t mSize;
+  };
+
+  struct valuerange
+  {
+    typedef data_type value_type;
+    typedef reference FrontResult;
+
+    range r;
+    valuerange()
+    {
+    }
+    valuerange(const range& _r) : r(_r)
+    {
+    }
+    bool Empty()
+    {
+      return r.Empty();
+    }
+    void PopFront()
+    {
+      return r.PopFront();
+    }
+    size_type Size()
+    {
+      return r.Size();
+    }
+    size_type Length()
+    {
+      return r.Size();
+    }
+    reference Front()
+    {
+      return r.Front().second;
+    }
+    valuerange& All()
+    {
+      return *this;
+    }
+
+    // C++ iterator/range interface
+    valuerange begin()
+    {
+      return *this;
+    }
+    valuerange end()
+    {
+      return valuerange(r.end());
+    }
+    bool operator==(const valuerange& rhs) const
+    {
+      return r == rhs.r;
+    }
+    bool operator!=(const valuerange& rhs) const
+    {
+      return r != rhs.r;
+    }
+    valuerange& operator++()
+    {
+      r.PopFront();
+      return *this;
+    }
+    reference operator*()
+    {
+      return Front();
+    }
+  };
+
+  struct keyrange
+  {
+    typedef key_type value_type;
+    typedef value_type& FrontResult;
+
+    range r;
+    keyrange()
+    {
+    }
+    keyrange(const range& _r) : r(_r)
+    {
+    }
+    bool Empty()
+    {
+      return r.Empty();
+    }
+    void PopFront()
+    {
+      return r.PopFront();
+    }
+    size_type Size()
+    {
+      return r.Size();
+    }
+    size_type Length()
+    {
+      return r.Size();
+    }
+    value_type& Front()
+    {
+      return r.Front().first;
+    }
+    keyrange& All()
+    {
+      return *this;
+    }
+
+    // C++ iterator/range interface
+    keyrange begin()
+    {
+      return *this;
+    }
+    keyrange end()
+    {
+      return keyrange(r.end());
+    }
+    bool operator==(const keyrange& rhs) const
+    {
+      return r == rhs.r;
+    }
+    bool operator!=(const keyrange& rhs) const
+    {
+      return r != rhs.r;
+    }
+    keyrange& operator++()
+    {
+      r.PopFront();
+      return *this;
+    }
+    value_type& operator*()
+    {
+      return Front();
+    }
+  };
+
+  FlatHashMap() : mControl(nullptr), mSlots(nullptr), mCapacity(0), mSize(0)
+  {
+  }
+
+  FlatHashMap(const std::initializer_list<pair>& initList) : mControl(nullptr), mSlots(nullptr), mCapacity(0), mSize(0)
+  {
+    for (auto&& value : initList)
+      Insert(value);
+  }
+
+  FlatHashMap(const FlatHashMap& other) : mControl(nullptr), mSlots(nullptr), mCapacity(0), mSize(0)
+  {
+    *this = other;
+  }
+
+  ~FlatHashMap()
+  {
+    Deallocate();
+  }
+
+  void operator=(const FlatHashMap& other)
+  {
+    if (this == &other)
+      return;
+
+    Clear();
+    Reserve(other.Size());
+    range r = other.All();
+    while (!r.Empty())
+    {
+      Insert(r.Front());
+      r.PopFront();
+    }
+  }
+
+  ///////Container Global Modify//////////////////
+
+  /// Grows the table so that it can hold count entries without rehashing.
+  void Reserve(size_type count)
+  {
+    size_type capacity = mCapacity;
+    if (capacity == 0)
+      capacity = cFlatHashGroupWidth;
+    while (!FitsInCapacity(count, capacity))
+      capacity *= 2;
+
+    if (capacity != mCapacity)
+      Rehash(capacity);
+  }
+
+  /// Destroy all elements.
+  void Clear()
+  {
+    if (mSize != 0)
+      DestructSlots();
+    if (mControl != nullptr)
+      memset(mControl, cFlatHashEmpty, mCapacity + cFlatHashGroupWidth);
+    mSize = 0;
+  }
+
+  /// Destroy all elements and frees all memory.
+  void Deallocate()
+  {
+    if (mControl != nullptr)
+    {
+      DestructSlots();
+      mAllocator.Deallocate(mControl, AllocationSize(mCapacity));
+    }
+
+    mControl = nullptr;
+    mSlots = nullptr;
+    mCapacity = 0;
+    mSize = 0;
+  }
+
+  void Swap(this_type& other)
+  {
+    Plasma::Swap(mControl, other.mControl);
+    Plasma::Swap(mSlots, other.mSlots);
+    Plasma::Swap(mCapacity, other.mCapacity);
+    Plasma::Swap(mSize, other.mSize);
+    Plasma::Swap(mHasher, other.mHasher);
+  }
+
+  range All() const
+  {
+    return range(mSlots, mSlots + mCapacity, mControl, mSize);
+  }
+
+  range begin() const
+  {
+    return All();
+  }
+
+  range end() const
+  {
+    return All().end();
+  }
+
+  /// range of all the values in the map.
+  valuerange Values() const
+  {
+    return valuerange(All());
+  }
+
+  /// range of all the keys in the map.
+  keyrange Keys() const
+  {
+    return keyrange(All());
+  }
+
+  //////////Information Functions///////////
+  size_type BucketCount() const
+  {
+    return mCapacity;
+  }
+  size_type Size() const
+  {
+    return mSize;
+  }
+  bool Empty() const
+  {
+    return mSize == 0;
+  }
+  float LoadFactor() const
+  {
+    return float(mSize) / float(mCapacity);
+  }
+
+  ////////////Insertion///////////////////////
+
+  data_type& operator[](const key_type& key)
+  {
+    return InsertInternal(value_type(key, data_type()), false).mValue->second;
+  }
+
+  InsertResult Insert(const value_type& datapair)
+  {
+    return InsertInternal(datapair, true);
+  }
+
+  InsertResult Insert(const key_type& key, const data_type& value)
+  {
+    return InsertInternal(value_type(key, value), true);
+  }
+
+  void Insert(range pair_range)
+  {
+    for (; !pair_range.Empty(); pair_range.PopFront())
+      InsertInternal(pair_range.Front(), true);
+  }
+
+  bool InsertOrError(const value_type& datapair)
+  {
+    InsertResult result = InsertInternal(datapair, false);
+    ErrorIf(result.mIsNewInsert == false, "Double Insert, value was not inserted!");
+    return result.mIsNewInsert;
+  }
+
+  bool InsertOrError(const key_type& key, const data_type& value)
+  {
+    return InsertOrError(value_type(key, value));
+  }
+
+  InsertResult InsertNoOverwrite(const value_type& datapair)
+  {
+    return InsertInternal(datapair, false);
+  }
+
+  InsertResult InsertNoOverwrite(const key_type& key, const data_type& value)
+  {
+    return InsertInternal(value_type(key, value), false);
+  }
+
+  ////////Find//////////////////////////////
+
+  /// Finds a key using another type that hashes and compares equal to it,
+  /// e.g. a StringRange against String keys (without building a String).
+  template <typename searchType, typename searchHasher>
+  range FindAs(const searchType& searchKey, searchHasher keyHasher = HashPolicy<searchType>()) const
+  {
+    return SlotRange(FindIndex(searchKey, keyHasher));
+  }
+
+  range Find(const key_type& searchKey) const
+  {
+    return SlotRange(FindIndex(searchKey, mHasher));
+  }
+
+  bool TryGetValue(const key_type& searchKey, data_type& valueOut) const
+  {
+    size_type index = FindIndex(searchKey, mHasher);
+    if (index == cInvalidIndex)
+      return false;
+
+    valueOut = mSlots[index].second;
+    return true;
+  }
+
+  data_type FindValue(const key_type& searchKey, const data_type& ifNotFound) const
+  {
+    size_type index = FindIndex(searchKey, mHasher);
+    if (index == cInvalidIndex)
+      return ifNotFound;
+    return mSlots[index].second;
+  }
+
+  // Returns a pointer to the value if found, or null if not found
+  data_type* FindPointer(const key_type& searchKey, data_type* ifNotFound = nullptr) const
+  {
+    size_type index = FindIndex(searchKey, mHasher);
+    if (index == cInvalidIndex)
+      return ifNotFound;
+    return &mSlots[index].second;
+  }
+
+  bool ContainsKey(const key_type& searchKey) const
+  {
+    return FindIndex(searchKey, mHasher) != cInvalidIndex;
+  }
+
+  size_t Count(const key_type& searchKey) const
+  {
+    return ContainsKey(searchKey) ? 1 : 0;
+  }
+
+  ///////Erasing//////////////////////////
+
+  bool Erase(const key_type& searchKey)
+  {
+    size_type index = FindIndex(searchKey, mHasher);
+    if (index == cInvalidIndex)
+      return false;
+
+    EraseSlot(index);
+    return true;
+  }
+
+private:
+  static const size_type cInvalidIndex = (size_type)-1;
+
+  // Keeps the load factor at or below 7/8.
+  static bool FitsInCapacity(size_type count, size_type capacity)
+  {
+    return count * 8 <= capacity * 7;
+  }
+
+  // The control bytes (with a mirrored copy of the first group at the end so
+  // a group can be loaded at any index) followed by the slots.
+  static size_type ControlSize(size_type capacity)
+  {
+    size_type alignment = alignof(value_type) > cFlatHashGroupWidth ? alignof(value_type) : cFlatHashGroupWidth;
+    return (capacity + cFlatHashGroupWidth + alignment - 1) & ~(alignment - 1);
+  }
+
+  static size_type AllocationSize(size_type capacity)
+  {
+    return ControlSize(capacity) + capacity * sizeof(value_type);
+  }
+
+  range SlotRange(size_type index) const
+  {
+    if (index == cInvalidIndex)
+      return range();
+    return range(mSlots + index, mSlots + index + 1, mControl + index, 1);
+  }
+
+  size_type Mask() const
+  {
+    return mCapacity - 1;
+  }
+
+  size_type HomeIndex(u64 mixedHash) const
+  {
+    return (size_type)(mixedHash >> 7) & Mask();
+  }
+
+  static ::byte ControlByte(u64 mixedHash)
+  {
+    return (::byte)(mixedHash & 0x7F);
+  }
+
+  void SetControl(size_type index, ::byte value)
+  {
+    mControl[index] = value;
+    if (index < cFlatHashGroupWidth)
+      mControl[mCapacity + index] = value;
+  }
+
+  template <typename searchType, typename searchHasherType>
+  size_type FindIndex(const searchType& searchKey, searchHasherType searchHasher) const
+  {
+    if (mSize == 0)
+      return cInvalidIndex;
+
+    u64 hash = FlatHashMix(searchHasher(searchKey));
+    ::byte control = ControlByte(hash);
+    size_type mask = Mask();
+    size_type position = HomeIndex(hash);
+
+    // The load factor guarantees an empty slot, which ends the search.
+    for (;;)
+    {
+      const ::byte* group = mControl + position;
+      u32 matches = FlatHashMatch(group, control);
+      while (matches != 0)
+      {
+        size_type index = (position + FlatHashLowestBit(matches)) & mask;
+        if (searchHasher.Equal(searchKey, mSlots[index].first))
+          return index;
+        matches &= matches - 1;
+      }
+
+      if (FlatHashMatchEmpty(group) != 0)
+        return cInvalidIndex;
+
+      position = (position + cFlatHashGroupWidth) & mask;
+    }
+  }
+
+  // First empty slot at or after the hash's home slot.
+  size_type FindEmptyIndex(u64 hash) const
+  {
+    size_type mask = Mask();
+    size_type position = HomeIndex(hash);
+    for (;;)
+    {
+      u32 empty = FlatHashMatchEmpty(mControl + position);
+      if (empty != 0)
+        return (position + FlatHashLowestBit(empty)) & mask;
+      position = (position + cFlatHashGroupWidth) & mask;
+    }
+  }
+
+  InsertResult InsertInternal(const value_type& value, bool overwrite)
+  {
+    size_type index = FindIndex(value.first, mHasher);
+    if (index != cInvalidIndex)
+    {
+      if (overwrite)
+        mSlots[index] = value;
+      return InsertResult(false, mSlots + index);
+    }
+
+    // Only grow for keys that are actually new
+    if (mCapacity == 0 || !FitsInCapacity(mSize + 1, mCapacity))
+      Rehash(mCapacity == 0 ? cFlatHashGroupWidth : mCapacity * 2);
+
+    u64 hash = FlatHashMix(mHasher(value.first));
+    index = FindEmptyIndex(hash);
+    new (mSlots + index) value_type(value);
+    SetControl(index, ControlByte(hash));
+    ++mSize;
+    return InsertResult(true, mSlots + index);
+  }
+
+  // Removes the slot and shifts back any following entries that were
+  // displaced past it, so no tombstones are needed.
+  void EraseSlot(size_type hole)
+  {
+    size_type mask = Mask();
+    mSlots[hole].~value_type();
+
+    size_type next = (hole + 1) & mask;
+    while (mControl[next] != cFlatHashEmpty)
+    {
+      size_type home = HomeIndex(FlatHashMix(mHasher(mSlots[next].first)));
+
+      // The entry can fill the hole if its home is not between the hole and
+      // the entry (it would then be found before reaching the hole).
+      if (((next - home) & mask) >= ((next - hole) & mask))
+      {
+        MoveWithoutDestructionOperator<value_type>::MoveWithoutDestruction(mSlots + hole, mSlots + next);
+        SetControl(hole, mControl[next]);
+        hole = next;
+      }
+
+      next = (next + 1) & mask;
+    }
+
+    SetControl(hole, cFlatHashEmpty);
+    --mSize;
+  }
+
+  void Rehash(size_type newCapacity)
+  {
+    ::byte* oldControl = mControl;
+    value_type* oldSlots = mSlots;
+    size_type oldCapacity = mCapacity;
+
+    ::byte* memory = (::byte*)mAllocator.Allocate(AllocationSize(newCapacity));
+    mControl = memory;
+    mSlots = (value_type*)(memory + ControlSize(newCapacity));
+    mCapacity = newCapacity;
+    memset(mControl, cFlatHashEmpty, newCapacity + cFlatHashGroupWidth);
+
+    // Keys are unique so they can be placed without comparing
+    for (size_type i = 0; i < oldCapacity; ++i)
+    {
+      if (oldControl[i] == cFlatHashEmpty)
+        continue;
+
+      u64 hash = FlatHashMix(mHasher(oldSlots[i].first));
+      size_type index = FindEmptyIndex(hash);
+      MoveWithoutDestructionOperator<value_type>::MoveWithoutDestruction(mSlots + index, oldSlots + i);
+      SetControl(index, ControlByte(hash));
+    }
+
+    if (oldControl != nullptr)
+      mAllocator.Deallocate(oldControl, AllocationSize(oldCapacity));
+  }
+
+  void DestructSlots()
+  {
+    for (size_type i = 0; i < mCapacity; ++i)
+    {
+      if (mControl[i] != cFlatHashEmpty)
+        mSlots[i].~value_type();
+    }
+  }
+
+  ::byte* mControl;
+  value_type* mSlots;
+  size_type mCapacity;
+  size_type mSize;
+  Hasher mHasher;
+};
+
+} // namespace Plasma
@@ -0,0 +1,153 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// Every allocation is preceded by a header (which keeps the memory 16 byte
+// aligned) so that it can be released on any thread.
+struct FrameAllocationHeader
+{
+  FrameArena* mArena;
+  size_t mSize;
+};
+
+const size_t cFrameArenaAlignment = 16;
+const size_t cFrameArenaHeaderSize = 16;
+const size_t cFrameArenaChunkSize = 64 * 1024;
+
+volatile s32 gFrameArenaFrame;
+volatile s64 gFrameArenaHighWaterMark;
+volatile s64 gFrameArenaLastHighWaterMark;
+PlasmaThreadLocal FrameArena* gThreadFrameArena;
+
+inline size_t AlignFrameSize(size_t size)
+{
+  return (size + cFrameArenaAlignment - 1) & ~(cFrameArenaAlignment - 1);
+}
+
+FrameArena* FrameArena::GetThreadArena()
+{
+  FrameArena* arena = gThreadFrameArena;
+  if (arena == nullptr)
+  {
+    // Never freed, allocations may outlive the thread that made them.
+    arena = new (plAllocate(sizeof(FrameArena))) FrameArena();
+    arena->mChunks = nullptr;
+    arena->mCurrent = nullptr;
+    arena->mEnd = nullptr;
+    arena->mUsed = 0;
+    arena->mCapacity = 0;
+    arena->mFrame = AtomicLoad(&gFrameArenaFrame);
+    gThreadFrameArena = arena;
+  }
+  return arena;
+}
+
+void FrameArena::NextFrame()
+{
+  s64 highWaterMark = AtomicExchange(&gFrameArenaHighWaterMark, 0);
+  AtomicStore(&gFrameArenaLastHighWaterMark, highWaterMark);
+  TracyPlot("FrameArena High Water", (int64_t)highWaterMark);
+
+  AtomicPreIncrement(&gFrameArenaFrame);
+}
+
+size_t FrameArena::GetHighWaterMark()
+{
+  return (size_t)AtomicLoad(&gFrameArenaLastHighWaterMark);
+}
+
+MemPtr FrameArena::Allocate(size_t numberOfBytes)
+{
+  return GetThreadArena()->AllocateInternal(numberOfBytes);
+}
+
+void FrameArena::Deallocate(MemPtr ptr, size_t numberOfBytes)
+{
+  if (ptr == nullptr)
+    return;
+
+  FrameAllocationHeader* header = (FrameAllocationHeader*)((::byte*)ptr - cFrameArenaHeaderSize);
+  FrameArena* arena = header->mArena;
+
+  // Roll back the last allocation so growing scratch arrays reuse the space.
+  if (arena == gThreadFrameArena && (::byte*)ptr + header->mSize == arena->mCurrent)
+  {
+    arena->mCurrent = (::byte*)header;
+    arena->mUsed -= header->mSize + cFrameArenaHeaderSize;
+  }
+
+  --arena->mLive;
+}
+
+MemPtr FrameArena::AllocateInternal(size_t numberOfBytes)
+{
+  if (mFrame != AtomicLoad(&gFrameArenaFrame) && mLive == 0)
+    Reset();
+
+  size_t size = AlignFrameSize(numberOfBytes);
+  size_t totalSize = size + cFrameArenaHeaderSize;
+  if ((size_t)(mEnd - mCurrent) < totalSize)
+    AddChunk(totalSize);
+
+  FrameAllocationHeader* header = (FrameAllocationHeader*)mCurrent;
+  header->mArena = this;
+  header->mSize = size;
+  mCurrent += totalSize;
+  mUsed += totalSize;
+  ++mLive;
+
+  // Raise the global high-water mark (only ever read for stats).
+  s64 used = (s64)mUsed;
+  s64 highWaterMark = AtomicLoad(&gFrameArenaHighWaterMark);
+  while (used > highWaterMark)
+  {
+    if (AtomicCompareExchange(&gFrameArenaHighWaterMark, used, highWaterMark))
+      break;
+    highWaterMark = AtomicLoad(&gFrameArenaHighWaterMark);
+  }
+
+  return (::byte*)header + cFrameArenaHeaderSize;
+}
+
+void FrameArena::Reset()
+{
+  mFrame = AtomicLoad(&gFrameArenaFrame);
+  mUsed = 0;
+
+  // If the last frames needed more than one chunk, replace them
+  // with a single chunk that can hold all of it.
+  if (mChunks != nullptr && mChunks->mNext != nullptr)
+  {
+    size_t capacity = mCapacity;
+    while (mChunks != nullptr)
+    {
+      Chunk* next = mChunks->mNext;
+      plDeallocate(mChunks);
+      mChunks = next;
+    }
+    mCapacity = 0;
+    AddChunk(capacity);
+    return;
+  }
+
+  if (mChunks != nullptr)
+    mCurrent = (::byte*)mChunks + cFrameArenaHeaderSize;
+}
+
+void FrameArena::AddChunk(size_t minimumSize)
+{
+  size_t size = Math::Max(minimumSize, cFrameArenaChunkSize);
+  Chunk* chunk = (Chunk*)plAllocate(size + cFrameArenaHeaderSize);
+  chunk->mNext = mChunks;
+  chunk->mSize = size;
+  mChunks = chunk;
+  mCapacity += size;
+
+  // The remainder of the previous chunk is wasted until the next reset.
+  mCurrent = (::byte*)chunk + cFrameArenaHeaderSize;
+  mEnd = mCurrent + size;
+}
+
+} // namespace Plasma
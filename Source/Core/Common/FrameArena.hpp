@@ -0,0 +1,75 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+#include "Graph.hpp"
+
+namespace Plasma
+{
+
+/// Linear (bump) allocator for memory that only lives for the current frame.
+/// Every thread has its own arena so allocating never takes a lock. Freeing
+/// only counts the allocation as released (the most recent allocation on the
+/// owning thread is rolled back). Once every allocation from a previous frame
+/// has been released the arena resets itself on the next allocation, merging
+/// its chunks into one that fits the largest frame seen so far.
+/// Memory that is never released keeps its arena from resetting.
+class PlasmaShared FrameArena
+{
+public:
+  // Returns the arena of the calling thread (created on first use).
+  static FrameArena* GetThreadArena();
+
+  // Called by the engine at the start of every frame.
+  // Reports the high-water mark of the last frame to the profiler.
+  static void NextFrame();
+
+  // The most bytes used by any arena during the last frame.
+  static size_t GetHighWaterMark();
+
+  // Always allocates from the calling thread's arena.
+  static MemPtr Allocate(size_t numberOfBytes);
+  // Can be called from any thread.
+  static void Deallocate(MemPtr ptr, size_t numberOfBytes);
+
+private:
+  struct Chunk
+  {
+    Chunk* mNext;
+    size_t mSize;
+  };
+
+  MemPtr AllocateInternal(size_t numberOfBytes);
+  void Reset();
+  void AddChunk(size_t minimumSize);
+
+  // Chunks in the order they were allocated (most recent first).
+  Chunk* mChunks;
+  ::byte* mCurrent;
+  ::byte* mEnd;
+  // Bytes handed out since the last reset.
+  size_t mUsed;
+  // Total size of every chunk.
+  size_t mCapacity;
+  // Allocations that haven't been released yet.
+  Atomic<s32> mLive;
+  // The frame of the last reset.
+  s32 mFrame;
+};
+
+/// Allocator for containers (Array, HashMap, ...) whose memory only lives
+/// for the current frame, e.g. Array<Type, FrameAllocator> scratch.
+/// The container must be destroyed (or deallocated) before the end of the frame.
+class PlasmaShared FrameAllocator : public Memory::StandardMemory
+{
+public:
+  MemPtr Allocate(size_t numberOfBytes)
+  {
+    return FrameArena::Allocate(numberOfBytes);
+  }
+
+  void Deallocate(MemPtr ptr, size_t numberOfBytes)
+  {
+    FrameArena::Deallocate(ptr, numberOfBytes);
+  }
+};
+
+} // namespace Plasma
@@ -29,6 +29,12 @@ void* plAllocate(size_t numberOfBytes)
 
 void plDeallocate(void* ptr)
 {
+#if !defined(UseMemoryDebugger) && !defined(UseMemoryTracker)
+  // Memory from a Heap may have come from the small object allocator.
+  if (Memory::SizeClassAllocator::TryDeallocate(ptr))
+    return;
+#endif
+
   TracyFree(ptr);
 #ifdef UseMemoryDebugger
   DebugDeallocate(ptr, AllocationType_Direct);
@@ -192,6 +198,42 @@ Graph::Graph(cstr name, Graph* parent) : Name(name), mParent(parent)
     parent->Children.PushBack(this);
 }
 
+// The counters are reinterpreted as signed integers of the same size for the atomic operations.
+typedef EXACT_INT(BYTES_TO_BITS(sizeof(MemCounterType))) AtomicMemCounterType;
+
+inline MemCounterType CounterFetchAdd(MemCounterType* counter, MemCounterType value)
+{
+  return (MemCounterType)AtomicFetchAdd((volatile AtomicMemCounterType*)counter, (AtomicMemCounterType)value);
+}
+
+void Graph::DeltaDedicated(MemCounterType bytes)
+{
+  CounterFetchAdd(&mData.BytesDedicated, bytes);
+}
+
+void Graph::AddAllocation(MemCounterType bytes)
+{
+  CounterFetchAdd(&mData.Active, 1);
+  CounterFetchAdd(&mData.Allocations, 1);
+  MemCounterType allocated = CounterFetchAdd(&mData.BytesAllocated, bytes) + bytes;
+
+  // Raise the peak unless another thread already raised it past us.
+  volatile AtomicMemCounterType* peak = (volatile AtomicMemCounterType*)&mData.PeakAllocated;
+  AtomicMemCounterType current = AtomicLoad(peak);
+  while ((MemCounterType)current < allocated)
+  {
+    if (AtomicCompareExchange(peak, (AtomicMemCounterType)allocated, current))
+      break;
+    current = AtomicLoad(peak);
+  }
+}
+
+void Graph::RemoveAllocation(MemCounterType bytes)
+{
+  CounterFetchAdd(&mData.Active, (MemCounterType)-1);
+  CounterFetchAdd(&mData.BytesAllocated, (MemCounterType)0 - bytes);
+}
+
 void Graph::PrintHeader(size_t flags)
 {
   // DebugPrint("%-*s", maxTabs*tabSize, "Name" );
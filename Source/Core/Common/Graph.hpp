@@ -55,25 +55,11 @@ public:
 
   Graph(cstr name, Graph* parent);
 
-  void DeltaDedicated(MemCounterType bytes)
-  {
-    mData.BytesDedicated += bytes;
-  }
-
-  void AddAllocation(MemCounterType bytes)
-  {
-    ++mData.Active;
-    ++mData.Allocations;
-    mData.BytesAllocated += bytes;
-    if (mData.BytesAllocated > mData.PeakAllocated)
-      mData.PeakAllocated = mData.BytesAllocated;
-  }
-
-  void RemoveAllocation(MemCounterType bytes)
-  {
-    --mData.Active;
-    mData.BytesAllocated -= bytes;
-  }
+  // The statistics are updated atomically so that allocators
+  // can be used from multiple threads without a lock.
+  void DeltaDedicated(MemCounterType bytes);
+  void AddAllocation(MemCounterType bytes);
+  void RemoveAllocation(MemCounterType bytes);
 
   typedef InListBaseLink<Graph>::range RangeType;
   RangeType GetChildren()
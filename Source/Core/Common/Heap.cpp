@@ -14,6 +14,10 @@ Heap::Heap(cstr name, Graph* parent) : Graph(name, parent)
 MemPtr Heap::Allocate(size_t numberOfBytes)
 {
   AddAllocation(numberOfBytes);
+#if !defined(UseMemoryDebugger) && !defined(UseMemoryTracker)
+  if (SizeClassAllocator::IsSmall(numberOfBytes))
+    return SizeClassAllocator::Allocate(numberOfBytes);
+#endif
   MemPtr mem = plAllocate(numberOfBytes);
   return mem;
 }
@@ -21,6 +25,7 @@ MemPtr Heap::Allocate(size_t numberOfBytes)
 void Heap::Deallocate(MemPtr ptr, size_t numberOfBytes)
 {
   RemoveAllocation(numberOfBytes);
+  // Returns small blocks to the SizeClassAllocator.
   plDeallocate(ptr);
 }
 
@@ -1,6 +1,7 @@
 // MIT Licensed (see LICENSE.md).
 #pragma once
 #include "Graph.hpp"
+#include "SizeClassAllocator.hpp"
 
 namespace Plasma
 {
@@ -9,8 +10,9 @@ namespace Memory
 
 class HeapPrivate;
 
-/// Heap allocator. The heap allocator allocates memory directly from the
-/// system heap using malloc and free.
+/// Heap allocator. Small allocations come from the thread caching
+/// SizeClassAllocator, larger ones directly from the system heap using malloc
+/// and free. Safe to use from multiple threads.
 class PlasmaShared Heap : public Graph
 {
 public:
@@ -0,0 +1,322 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+const size_t cMpscCacheLineSize = 64;
+
+/// Unbounded lock-free queue for many producer threads and one consumer thread.
+/// Push never blocks and never fails (each push allocates one node). Only one
+/// thread may Pop/Drain at a time. A pop may briefly see the queue as empty
+/// while a producer is between its two steps; the item shows up on a later pop.
+template <typename T>
+class MpscQueue
+{
+public:
+  typedef T value_type;
+
+  MpscQueue()
+  {
+    Node* stub = AllocateNode();
+    mHead = stub;
+    mTail = stub;
+  }
+
+  ~MpscQueue()
+  {
+    Clear();
+    FreeNode(mTail);
+  }
+
+  /// Safe to call from any thread.
+  void Push(const T& value)
+  {
+    Node* node = AllocateNode();
+    new (node->GetValue()) T(value);
+    PushNode(node);
+  }
+
+  void Push(MoveReference<T> value)
+  {
+    Node* node = AllocateNode();
+    new (node->GetValue()) T(PlasmaMove(*value));
+    PushNode(node);
+  }
+
+  /// Consumer thread only. Returns the oldest ready item, or null if nothing
+  /// was ready. The item stays valid until PopFront.
+  T* Front()
+  {
+    Node* next = (Node*)AtomicLoad((void* volatile*)&mTail->mNext);
+    if (next == nullptr)
+      return nullptr;
+    return next->GetValue();
+  }
+
+  /// Consumer thread only. Destroys the item returned by Front.
+  void PopFront()
+  {
+    Node* tail = mTail;
+    Node* next = (Node*)AtomicLoad((void* volatile*)&tail->mNext);
+    ErrorIf(next == nullptr, "Popped an empty queue.");
+
+    // The next node becomes the new stub once its value is destroyed
+    next->GetValue()->~T();
+    mTail = next;
+    FreeNode(tail);
+  }
+
+  /// Consumer thread only. Returns false if nothing was ready.
+  bool Pop(T& result)
+  {
+    T* value = Front();
+    if (value == nullptr)
+      return false;
+
+    result = *value;
+    PopFront();
+    return true;
+  }
+
+  /// Consumer thread only. Copies everything currently queued onto the back of
+  /// the array and returns how many items were added.
+  template <typename ArrayType>
+  size_t Drain(ArrayType& results)
+  {
+    size_t count = 0;
+    while (T* value = Front())
+    {
+      results.PushBack(*value);
+      PopFront();
+      ++count;
+    }
+    return count;
+  }
+
+  /// Consumer thread only. Destroys everything currently queued.
+  void Clear()
+  {
+    while (Front() != nullptr)
+      PopFront();
+  }
+
+  /// Consumer thread only (producers may have items in flight).
+  bool Empty()
+  {
+    return AtomicLoad((void* volatile*)&mTail->mNext) == nullptr;
+  }
+
+private:
+  MpscQueue(const MpscQueue&);
+  void operator=(const MpscQueue&);
+
+  struct Node
+  {
+    T* GetValue()
+    {
+      return (T*)mValue;
+    }
+
+    Node* volatile mNext;
+    alignas(T) ::byte mValue[sizeof(T)];
+  };
+
+  static Node* AllocateNode()
+  {
+    Node* node = (Node*)plAllocate(sizeof(Node));
+    node->mNext = nullptr;
+    return node;
+  }
+
+  static void FreeNode(Node* node)
+  {
+    plDeallocate(node);
+  }
+
+  void PushNode(Node* node)
+  {
+    // Claim the head, then link the previous head to the new node. The consumer
+    // cannot read past the previous head until the link is stored.
+    Node* previous = (Node*)AtomicExchange((void* volatile*)&mHead, node);
+    AtomicStore((void* volatile*)&previous->mNext, node);
+  }
+
+  // Producers write the head and the consumer reads the tail, so keep them on
+  // separate cache lines.
+  Node* volatile mHead;
+  ::byte mPadding[cMpscCacheLineSize - sizeof(Node*)];
+  Node* mTail;
+};
+
+/// Fixed capacity lock-free queue for many producer threads and one consumer
+/// thread. No allocation happens after construction. TryPush fails (instead of
+/// blocking) when the queue is full. The capacity is rounded up to a power of 2.
+template <typename T>
+class BoundedMpscQueue
+{
+public:
+  typedef T value_type;
+
+  BoundedMpscQueue(size_t capacity)
+  {
+    ErrorIf(capacity == 0, "Bounded queue capacity must be at least 1.");
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+
+    mMask = size - 1;
+    mCells = (Cell*)plAllocate(sizeof(Cell) * size);
+    for (size_t i = 0; i < size; ++i)
+      mCells[i].mSequence = (s64)i;
+
+    mEnqueuePosition = 0;
+    mDequeuePosition = 0;
+  }
+
+  ~BoundedMpscQueue()
+  {
+    Clear();
+    plDeallocate(mCells);
+  }
+
+  /// Safe to call from any thread. Returns false if the queue is full.
+  bool TryPush(const T& value)
+  {
+    Cell* cell = ClaimCell();
+    if (cell == nullptr)
+      return false;
+
+    new (cell->GetValue()) T(value);
+    PublishCell(cell);
+    return true;
+  }
+
+  bool TryPush(MoveReference<T> value)
+  {
+    Cell* cell = ClaimCell();
+    if (cell == nullptr)
+      return false;
+
+    new (cell->GetValue()) T(PlasmaMove(*value));
+    PublishCell(cell);
+    return true;
+  }
+
+  /// Consumer thread only. Returns the oldest ready item, or null if nothing
+  /// was ready. The item stays valid until PopFront.
+  T* Front()
+  {
+    Cell& cell = mCells[mDequeuePosition & mMask];
+    if (AtomicLoad(&cell.mSequence) != mDequeuePosition + 1)
+      return nullptr;
+    return cell.GetValue();
+  }
+
+  /// Consumer thread only. Destroys the item returned by Front.
+  void PopFront()
+  {
+    s64 position = mDequeuePosition;
+    Cell& cell = mCells[position & mMask];
+    ErrorIf(AtomicLoad(&cell.mSequence) != position + 1, "Popped an empty queue.");
+    cell.GetValue()->~T();
+
+    // Hand the cell back to producers for the next lap around the ring
+    AtomicStore(&cell.mSequence, position + (s64)mMask + 1);
+    mDequeuePosition = position + 1;
+  }
+
+  /// Consumer thread only. Returns false if nothing was ready.
+  bool Pop(T& result)
+  {
+    T* value = Front();
+    if (value == nullptr)
+      return false;
+
+    result = *value;
+    PopFront();
+    return true;
+  }
+
+  /// Consumer thread only. Copies everything currently queued onto the back of
+  /// the array and returns how many items were added.
+  template <typename ArrayType>
+  size_t Drain(ArrayType& results)
+  {
+    size_t count = 0;
+    while (T* value = Front())
+    {
+      results.PushBack(*value);
+      PopFront();
+      ++count;
+    }
+    return count;
+  }
+
+  /// Consumer thread only. Destroys everything currently queued.
+  void Clear()
+  {
+    while (Front() != nullptr)
+      PopFront();
+  }
+
+  size_t Capacity()
+  {
+    return mMask + 1;
+  }
+
+private:
+  BoundedMpscQueue(const BoundedMpscQueue&);
+  void operator=(const BoundedMpscQueue&);
+
+  struct Cell
+  {
+    T* GetValue()
+    {
+      return (T*)mValue;
+    }
+
+    // Equal to the position when free for that position's producer, and to
+    // position + 1 once the value is written for the consumer.
+    volatile s64 mSequence;
+    alignas(T) ::byte mValue[sizeof(T)];
+  };
+
+  Cell* ClaimCell()
+  {
+    s64 position = AtomicLoad(&mEnqueuePosition);
+    for (;;)
+    {
+      Cell* cell = &mCells[position & mMask];
+      s64 difference = AtomicLoad(&cell->mSequence) - position;
+
+      if (difference == 0)
+      {
+        if (AtomicCompareExchange(&mEnqueuePosition, position + 1, position))
+          return cell;
+      }
+      // The consumer has not freed this cell from the last lap yet
+      else if (difference < 0)
+      {
+        return nullptr;
+      }
+
+      // Another producer took the position
+      position = AtomicLoad(&mEnqueuePosition);
+    }
+  }
+
+  void PublishCell(Cell* cell)
+  {
+    AtomicStore(&cell->mSequence, AtomicLoad(&cell->mSequence) + 1);
+  }
+
+  Cell* mCells;
+  size_t mMask;
+  ::byte mPadding0[cMpscCacheLineSize - sizeof(Cell*) - sizeof(size_t)];
+  volatile s64 mEnqueuePosition;
+  ::byte mPadding1[cMpscCacheLineSize - sizeof(s64)];
+  s64 mDequeuePosition;
+};
+
+} // namespace Plasma
@@ -51,7 +51,9 @@ MemPtr Pool::Allocate(size_t numberOfBytes)
   // Allocate memory by pop a block off the free list.
   ErrorIf(numberOfBytes > mBlockSize, "Allocation is large than block size.");
   AddAllocation(mBlockSize);
+  mLock.Lock();
   auto ptr = PopOnFreeList();
+  mLock.Unlock();
   //TracyAlloc(ptr, numberOfBytes);
   return ptr;
 }
@@ -70,7 +72,9 @@ void Pool::Deallocate(MemPtr ptr, size_t /*numberOfBytes*/)
 
   // Deallocate memory by push a block on the free list.
   RemoveAllocation(mBlockSize);
+  mLock.Lock();
   PushOnFreeList(ptr);
+  mLock.Unlock();
 
   //TracyFree(ptr);
 }
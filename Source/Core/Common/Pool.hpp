@@ -2,6 +2,7 @@
 #pragma once
 #include "Array.hpp"
 #include "Graph.hpp"
+#include "SpinLock.hpp"
 
 namespace Plasma
 {
@@ -13,7 +14,8 @@ namespace Memory
 /// intrusively singly linked list of free blocks. Every time an allocation
 /// is made the next free block is popped of the list. Every time an allocation
 /// is freed the memory is push back onto the front of the list. When their are
-/// no more free blocks new pages are allocated.
+/// no more free blocks new pages are allocated. The free list is protected by
+/// a spin lock so a pool can be shared between threads.
 class Pool : public Graph
 {
 public:
@@ -51,6 +53,7 @@ public:
   void CleanUp();
 
 private:
+  SpinLock mLock;
   FreeBlock* mNextFreeBlock;
   size_t mBlockSize;
   size_t mBlocksPerPage;
@@ -0,0 +1,351 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+namespace Memory
+{
+
+// Everything in this file is plain old data that is zero initialized, so the
+// allocator can be used during static initialization (before any constructors run).
+// The only exception is ThreadCacheReleaser, which has no constructor.
+
+struct SmallBlock
+{
+  SmallBlock* mNext;
+  // Only used on the first block of a magazine stored in the depot.
+  SmallBlock* mNextMagazine;
+};
+
+// The free blocks of one size class owned by a single thread.
+struct ThreadMagazine
+{
+  SmallBlock* mHead;
+  size_t mCount;
+};
+
+struct ThreadCache
+{
+  ThreadMagazine mMagazines[SizeClassAllocator::cSizeClassCount];
+};
+
+// Shared between all threads and protected by mLock.
+struct CentralDepot
+{
+  volatile s32 mLock;
+  // Full magazines (each is a batch of blocks) given back by threads.
+  SmallBlock* mFullMagazines;
+  // Blocks left over from the partial magazines of threads that exited,
+  // turned into full magazines once there are enough of them.
+  SmallBlock* mLooseBlocks;
+  size_t mLooseCount;
+  // The remainder of the last page that hasn't been handed out yet.
+  ::byte* mPageCurrent;
+  ::byte* mPageEnd;
+};
+
+// Every page only contains blocks of a single size class and is aligned
+// to its size, so the page (and size class) of any block can be found
+// from its address.
+const uint cSmallPageShift = 16;
+const size_t cSmallPageSize = (size_t)1 << cSmallPageShift;
+// Pages are allocated from the system in groups to amortize the alignment.
+const size_t cPagesPerSuperblock = 16;
+// A magazine holds roughly this many bytes worth of blocks.
+const size_t cMagazineBytes = 8 * 1024;
+
+// Maps a page to its size class (plus one, zero means not ours). Two levels
+// covering a 48 bit address space: the top level is indexed by address bits
+// 32 to 47 and each leaf by bits 16 to 31. Leaves are created on demand.
+const uint cPageMapLeafBits = 32 - cSmallPageShift;
+const size_t cPageMapLeafSize = (size_t)1 << cPageMapLeafBits;
+const size_t cPageMapRootSize = (size_t)1 << 16;
+u8* volatile gPageMap[cPageMapRootSize];
+
+CentralDepot gDepots[SizeClassAllocator::cSizeClassCount];
+// Protects the page map and the current superblock.
+volatile s32 gPageLock;
+::byte* gSuperblockCurrent;
+::byte* gSuperblockEnd;
+volatile s64 gSmallDedicatedBytes;
+PlasmaThreadLocal ThreadCache* gThreadCache;
+
+void ReleaseThreadCache();
+
+// Gives the thread's cache back when the thread exits (thread_local rather
+// than PlasmaThreadLocal so that the destructor runs).
+struct ThreadCacheReleaser
+{
+  ~ThreadCacheReleaser()
+  {
+    ReleaseThreadCache();
+  }
+
+  bool mRegistered;
+};
+
+thread_local ThreadCacheReleaser gThreadCacheReleaser;
+
+void LockSmallAllocator(volatile s32* lock)
+{
+  while (!AtomicCompareExchange(lock, 1, 0))
+    ;
+}
+
+void UnlockSmallAllocator(volatile s32* lock)
+{
+  AtomicStore(lock, 0);
+}
+
+size_t GetBatchSize(uint sizeClass)
+{
+  size_t count = cMagazineBytes / SizeClassAllocator::GetClassSize(sizeClass);
+  return Math::Clamp(count, (size_t)4, (size_t)64);
+}
+
+ThreadCache* GetThreadCache()
+{
+  ThreadCache* cache = gThreadCache;
+  if (cache == nullptr)
+  {
+    // Blocks are freed into the cache of whichever thread frees them,
+    // so the cache only holds blocks this thread owns right now.
+    cache = (ThreadCache*)plAllocate(sizeof(ThreadCache));
+    memset(cache, 0, sizeof(ThreadCache));
+    AtomicFetchAdd(&gSmallDedicatedBytes, (s64)sizeof(ThreadCache));
+    gThreadCache = cache;
+    // Touching the releaser registers its destructor for this thread.
+    gThreadCacheReleaser.mRegistered = true;
+  }
+  return cache;
+}
+
+// Returns the size class (plus one) of the page the pointer lives in, or 0.
+uint LookupPage(MemPtr ptr)
+{
+  u64 address = (u64)(uintptr_t)ptr;
+  if (address >> 48)
+    return 0;
+
+  u8* leaf = gPageMap[(size_t)(address >> 32)];
+  if (leaf == nullptr)
+    return 0;
+  return leaf[(size_t)(address >> cSmallPageShift) & (cPageMapLeafSize - 1)];
+}
+
+// Allocates a page for the size class and records it in the page map.
+::byte* AllocatePage(uint sizeClass)
+{
+  LockSmallAllocator(&gPageLock);
+
+  if (gSuperblockCurrent == gSuperblockEnd)
+  {
+    // Over allocate by a page so the pages can be aligned.
+    size_t superblockSize = cSmallPageSize * (cPagesPerSuperblock + 1);
+    uintptr_t memory = (uintptr_t)plAllocate(superblockSize);
+    AtomicFetchAdd(&gSmallDedicatedBytes, (s64)superblockSize);
+
+    uintptr_t aligned = (memory + cSmallPageSize - 1) & ~(uintptr_t)(cSmallPageSize - 1);
+    gSuperblockCurrent = (::byte*)aligned;
+    gSuperblockEnd = gSuperblockCurrent + cSmallPageSize * cPagesPerSuperblock;
+  }
+
+  ::byte* page = gSuperblockCurrent;
+  gSuperblockCurrent += cSmallPageSize;
+
+  u64 address = (u64)(uintptr_t)page;
+  ErrorIf(address >> 48, "Small object page is outside of the address range covered by the page map.");
+
+  size_t rootIndex = (size_t)(address >> 32);
+  u8* leaf = gPageMap[rootIndex];
+  if (leaf == nullptr)
+  {
+    leaf = (u8*)plAllocate(cPageMapLeafSize);
+    memset(leaf, 0, cPageMapLeafSize);
+    AtomicFetchAdd(&gSmallDedicatedBytes, (s64)cPageMapLeafSize);
+    AtomicStore((void* volatile*)&gPageMap[rootIndex], leaf);
+  }
+  leaf[(size_t)(address >> cSmallPageShift) & (cPageMapLeafSize - 1)] = (u8)(sizeClass + 1);
+
+  UnlockSmallAllocator(&gPageLock);
+  return page;
+}
+
+// Fills the empty magazine with a batch of blocks from the depot.
+void RefillMagazine(ThreadMagazine& magazine, uint sizeClass)
+{
+  size_t classSize = SizeClassAllocator::GetClassSize(sizeClass);
+  size_t batchSize = GetBatchSize(sizeClass);
+  CentralDepot& depot = gDepots[sizeClass];
+
+  LockSmallAllocator(&depot.mLock);
+
+  // Prefer a full magazine given back by another thread.
+  if (SmallBlock* full = depot.mFullMagazines)
+  {
+    depot.mFullMagazines = full->mNextMagazine;
+    UnlockSmallAllocator(&depot.mLock);
+    magazine.mHead = full;
+    magazine.mCount = batchSize;
+    return;
+  }
+
+  // Otherwise carve a new batch (which may be smaller at the end of a page).
+  if (depot.mPageCurrent + classSize > depot.mPageEnd)
+  {
+    depot.mPageCurrent = AllocatePage(sizeClass);
+    depot.mPageEnd = depot.mPageCurrent + cSmallPageSize;
+  }
+
+  size_t count = Math::Min(batchSize, (size_t)(depot.mPageEnd - depot.mPageCurrent) / classSize);
+  ::byte* batch = depot.mPageCurrent;
+  depot.mPageCurrent += classSize * count;
+  UnlockSmallAllocator(&depot.mLock);
+
+  // Link the blocks together outside of the lock.
+  for (size_t i = 0; i < count - 1; ++i)
+    ((SmallBlock*)(batch + classSize * i))->mNext = (SmallBlock*)(batch + classSize * (i + 1));
+  ((SmallBlock*)(batch + classSize * (count - 1)))->mNext = nullptr;
+
+  magazine.mHead = (SmallBlock*)batch;
+  magazine.mCount = count;
+}
+
+// Gives a full batch of blocks from the magazine back to the depot.
+void FlushMagazine(ThreadMagazine& magazine, uint sizeClass)
+{
+  size_t batchSize = GetBatchSize(sizeClass);
+
+  SmallBlock* first = magazine.mHead;
+  SmallBlock* last = first;
+  for (size_t i = 1; i < batchSize; ++i)
+    last = last->mNext;
+
+  magazine.mHead = last->mNext;
+  magazine.mCount -= batchSize;
+  last->mNext = nullptr;
+
+  CentralDepot& depot = gDepots[sizeClass];
+  LockSmallAllocator(&depot.mLock);
+  first->mNextMagazine = depot.mFullMagazines;
+  depot.mFullMagazines = first;
+  UnlockSmallAllocator(&depot.mLock);
+}
+
+// Gives every block in the thread's magazines back to the depots and frees the cache.
+void ReleaseThreadCache()
+{
+  ThreadCache* cache = gThreadCache;
+  if (cache == nullptr)
+    return;
+  gThreadCache = nullptr;
+
+  for (uint sizeClass = 0; sizeClass < SizeClassAllocator::cSizeClassCount; ++sizeClass)
+  {
+    ThreadMagazine& magazine = cache->mMagazines[sizeClass];
+    size_t batchSize = GetBatchSize(sizeClass);
+    while (magazine.mCount >= batchSize)
+      FlushMagazine(magazine, sizeClass);
+
+    if (magazine.mCount == 0)
+      continue;
+
+    // Move the rest onto the depot's loose blocks and make full
+    // magazines out of them once there are enough.
+    SmallBlock* last = magazine.mHead;
+    while (last->mNext != nullptr)
+      last = last->mNext;
+
+    CentralDepot& depot = gDepots[sizeClass];
+    LockSmallAllocator(&depot.mLock);
+    last->mNext = depot.mLooseBlocks;
+    depot.mLooseBlocks = magazine.mHead;
+    depot.mLooseCount += magazine.mCount;
+    while (depot.mLooseCount >= batchSize)
+    {
+      SmallBlock* first = depot.mLooseBlocks;
+      SmallBlock* batchLast = first;
+      for (size_t i = 1; i < batchSize; ++i)
+        batchLast = batchLast->mNext;
+      depot.mLooseBlocks = batchLast->mNext;
+      depot.mLooseCount -= batchSize;
+      batchLast->mNext = nullptr;
+
+      first->mNextMagazine = depot.mFullMagazines;
+      depot.mFullMagazines = first;
+    }
+    UnlockSmallAllocator(&depot.mLock);
+  }
+
+  plDeallocate(cache);
+  AtomicFetchAdd(&gSmallDedicatedBytes, -(s64)sizeof(ThreadCache));
+}
+
+MemPtr SizeClassAllocator::Allocate(size_t numberOfBytes)
+{
+  uint sizeClass = GetSizeClass(numberOfBytes);
+  ThreadMagazine& magazine = GetThreadCache()->mMagazines[sizeClass];
+
+  if (magazine.mHead == nullptr)
+    RefillMagazine(magazine, sizeClass);
+
+  SmallBlock* block = magazine.mHead;
+  magazine.mHead = block->mNext;
+  --magazine.mCount;
+  return block;
+}
+
+bool SizeClassAllocator::TryDeallocate(MemPtr ptr)
+{
+  uint pageClass = LookupPage(ptr);
+  if (pageClass == 0)
+    return false;
+
+  uint sizeClass = pageClass - 1;
+  ThreadMagazine& magazine = GetThreadCache()->mMagazines[sizeClass];
+
+  SmallBlock* block = (SmallBlock*)ptr;
+  block->mNext = magazine.mHead;
+  magazine.mHead = block;
+  ++magazine.mCount;
+
+  // Keep up to two batches so that alternating allocations
+  // and frees don't keep going to the depot.
+  if (magazine.mCount >= GetBatchSize(sizeClass) * 2)
+    FlushMagazine(magazine, sizeClass);
+  return true;
+}
+
+uint SizeClassAllocator::GetSizeClass(size_t numberOfBytes)
+{
+  ErrorIf(!IsSmall(numberOfBytes), "Size is not handled by the small object allocator.");
+
+  // Classes are spaced 16 bytes apart up to 128, then 32 up to 256,
+  // 64 up to 512 and 128 up to 1024 (at most 20% wasted per block).
+  if (numberOfBytes <= 128)
+    return (uint)((numberOfBytes + 15) >> 4) - 1;
+  if (numberOfBytes <= 256)
+    return 7 + (uint)((numberOfBytes - 128 + 31) >> 5);
+  if (numberOfBytes <= 512)
+    return 11 + (uint)((numberOfBytes - 256 + 63) >> 6);
+  return 15 + (uint)((numberOfBytes - 512 + 127) >> 7);
+}
+
+size_t SizeClassAllocator::GetClassSize(uint sizeClass)
+{
+  if (sizeClass < 8)
+    return (sizeClass + 1) * 16;
+  if (sizeClass < 12)
+    return 128 + (sizeClass - 7) * 32;
+  if (sizeClass < 16)
+    return 256 + (sizeClass - 11) * 64;
+  return 512 + (sizeClass - 15) * 128;
+}
+
+size_t SizeClassAllocator::GetDedicatedBytes()
+{
+  return (size_t)AtomicLoad(&gSmallDedicatedBytes);
+}
+
+} // namespace Memory
+} // namespace Plasma
@@ -0,0 +1,46 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+namespace Memory
+{
+
+/// Thread caching allocator for small objects. Allocations are rounded up to
+/// one of a fixed set of size classes. Every thread keeps its own free list
+/// (magazine) of blocks per size class so that the common allocate / free path
+/// takes no locks. When a thread runs out of blocks (or has too many) it
+/// exchanges a whole magazine with a central depot for that size class, which
+/// also carves new blocks out of pages allocated from the system heap.
+/// Blocks are identified by the page they live in, so they may be freed on any
+/// thread, with any size and through plDeallocate.
+/// When a thread exits its cached blocks are given back to the depots.
+/// Pages are never given back to the system, freed blocks are reused instead.
+class PlasmaShared SizeClassAllocator
+{
+public:
+  // Allocations larger than this go to the system heap.
+  static const size_t cMaxSmallSize = 1024;
+  static const uint cSizeClassCount = 20;
+
+  // Returns whether the size should use this allocator.
+  static bool IsSmall(size_t numberOfBytes)
+  {
+    return numberOfBytes != 0 && numberOfBytes <= cMaxSmallSize;
+  }
+
+  // Blocks are at least 16 byte aligned.
+  static MemPtr Allocate(size_t numberOfBytes);
+
+  // Returns false (and does nothing) if the memory wasn't allocated by this allocator.
+  static bool TryDeallocate(MemPtr ptr);
+
+  static uint GetSizeClass(size_t numberOfBytes);
+  static size_t GetClassSize(uint sizeClass);
+
+  // Total bytes allocated from the system for pages and thread caches.
+  static size_t GetDedicatedBytes();
+};
+
+} // namespace Memory
+} // namespace Plasma
@@ -381,10 +381,11 @@ unsigned AudioFileEncoder::Resample(unsigned fileSampleRate,
 
     // Delete the buffer of input data
     delete[] buffersPerChannel[i];
-    // Set the buffer to the data in the array
-    buffersPerChannel[i] = newSamples.Data();
-    // Release the data from the array
-    newSamples.ReleaseData();
+    // Copy the data into a buffer that can be deleted like the original
+    // (the array's memory comes from the heap and can't be used with delete[])
+    buffersPerChannel[i] = new float[newSamples.Size()];
+    memcpy(buffersPerChannel[i], newSamples.Data(), newSamples.Size() * sizeof(float));
+    newSamples.Clear();
   }
 
   return newFrames;
@@ -105,7 +105,7 @@ void PhysicsMeshProcessor::WriteAabbTree(VertexPositionArray& vertices, IndexArr
 {
   // Build the Aabb-Tree
   StaticAabbTree<uint> aabbTree;
-  aabbTree.SetPartitionMethod(PartitionMethods::MinimizeVolumeSum);
+  aabbTree.SetPartitionMethod(PartitionMethods::BinnedSurfaceAreaHeuristic);
 
   // Dummy proxy. They will not be needed.
   BroadPhaseProxy proxy;
@@ -125,9 +125,10 @@ void PhysicsMeshProcessor::WriteAabbTree(VertexPositionArray& vertices, IndexArr
     aabb.Expand(p1);
     aabb.Expand(p2);
 
-    // Create the broad phase data.
+    // Create the broad phase data. The client data is the triangle
+    // index, the same as when PhysicsMesh generates the tree.
     BaseBroadPhaseData<uint> data;
-    data.mClientData = i;
+    data.mClientData = i / 3;
     data.mAabb = aabb;
 
     // Insert it into the tree
@@ -160,6 +160,9 @@ void Engine::Update()
     ZoneScoped;
     ProfileScopeFunction();
 
+    // Lets the frame arenas reset once last frame's scratch memory is released.
+    FrameArena::NextFrame();
+
     PL::gTracker->ClearDeletedObjects();
 
     PL::gJobs->RunJobsTimeSliced();
@@ -57,6 +57,7 @@ private:
 #include "ComponentMeta.hpp"
 #include "CogMetaComposition.hpp"
 #include "CogMeta.hpp"
+#include "UpdateRegistry.hpp"
 #include "Space.hpp"
 #include "DocumentResource.hpp"
 #include "LightningResource.hpp"
@@ -4,11 +4,14 @@
 namespace Plasma
 {
 
+// The worker that owns the current thread (null on non-worker threads).
+PlasmaThreadLocal JobWorker* gCurrentJobWorker = nullptr;
+
 LightningDefineType(Job, builder, type)
 {
 }
 
-Job::Job() : mRunCount(0)
+Job::Job() : mRunCount(0), mWorker(nullptr)
 {
 }
 
@@ -32,38 +35,297 @@ void Job::ExecuteAsyncEnd()
   PL::gJobs->JobComplete(this);
 }
 
+Task::Task() : mDependencies(0), mDependencyCount(0), mCounter(nullptr)
+{
+}
+
+Task::~Task()
+{
+}
+
+TaskCounter::TaskCounter() : mCount(0), mWaiter(nullptr)
+{
+}
+
+bool TaskCounter::IsComplete()
+{
+  return (mCount & ~cWaitingFlag) == 0;
+}
+
+TaskGraph::~TaskGraph()
+{
+  Clear();
+}
+
+Task* TaskGraph::Add(Task* task)
+{
+  mTasks.PushBack(task);
+  return task;
+}
+
+void TaskGraph::AddDependency(Task* task, Task* dependsOn)
+{
+  dependsOn->mContinuations.PushBack(task);
+  ++task->mDependencyCount;
+}
+
+void TaskGraph::Run()
+{
+  if (mTasks.Empty())
+    return;
+
+  // Count every task up front, continuations are queued without touching the counter.
+  TaskCounter counter;
+  counter.mCount = (s32)mTasks.Size();
+  forRange (Task* task, mTasks.All())
+  {
+    task->mDependencies = task->mDependencyCount;
+    task->mCounter = &counter;
+  }
+
+  forRange (Task* task, mTasks.All())
+  {
+    if (task->mDependencyCount == 0)
+      PL::gJobs->QueueTask(task);
+  }
+
+  PL::gJobs->WaitAndHelp(counter);
+}
+
+void TaskGraph::Clear()
+{
+  mTasks.Clear();
+  DeleteObjectsInContainer(mOwnedTasks);
+}
+
+TaskQueue::TaskQueue() : mFront(0)
+{
+}
+
+bool TaskQueue::Empty()
+{
+  return mFront == mTasks.Size();
+}
+
+void TaskQueue::PushBack(Task* task)
+{
+  mTasks.PushBack(task);
+}
+
+Task* TaskQueue::PopBack()
+{
+  if (Empty())
+    return nullptr;
+
+  Task* task = mTasks.Back();
+  mTasks.PopBack();
+
+  if (Empty())
+    Clear();
+  return task;
+}
+
+Task* TaskQueue::PopFront()
+{
+  if (Empty())
+    return nullptr;
+
+  Task* task = mTasks[mFront];
+  ++mFront;
+
+  if (Empty())
+    Clear();
+  return task;
+}
+
+void TaskQueue::Clear()
+{
+  mTasks.Clear();
+  mFront = 0;
+}
+
+JobQueue::JobQueue() : mFront(0)
+{
+}
+
+bool JobQueue::Empty()
+{
+  return mFront == mJobs.Size();
+}
+
+void JobQueue::PushBack(Job* job)
+{
+  mJobs.PushBack(job);
+}
+
+HandleOf<Job> JobQueue::PopBack()
+{
+  if (Empty())
+    return HandleOf<Job>();
+
+  HandleOf<Job> job = mJobs.Back();
+  mJobs.PopBack();
+
+  // Reclaim the space used by stolen jobs once the queue has been drained.
+  if (Empty())
+    Clear();
+  return job;
+}
+
+HandleOf<Job> JobQueue::PopFront()
+{
+  if (Empty())
+    return HandleOf<Job>();
+
+  HandleOf<Job> job = mJobs[mFront];
+  mJobs[mFront] = HandleOf<Job>();
+  ++mFront;
+
+  if (Empty())
+    Clear();
+  return job;
+}
+
+void JobQueue::Clear()
+{
+  mJobs.Clear();
+  mFront = 0;
+}
+
+JobWorker::JobWorker(JobSystem* system, uint index) : mSystem(system), mIndex(index)
+{
+}
+
+OsInt JobWorker::WorkerThreadEntry()
+{
+  gCurrentJobWorker = this;
+
+  for (;;)
+  {
+    mSystem->mJobCounter.WaitAndDecrement();
+
+    // The semaphore is incremented once per worker without any jobs when we shut down.
+    if (mSystem->mShuttingDown)
+      return 0;
+
+    // The job this count was for may have already been taken by another thread
+    // helping out, in which case we just go back to waiting.
+    mSystem->RunOneJob(this);
+  }
+}
+
+void JobWorker::Push(Job* job)
+{
+  mLock.Lock();
+  mQueues[job->mPriority].PushBack(job);
+  mLock.Unlock();
+}
+
+HandleOf<Job> JobWorker::PopOwn(JobPriority::Enum priority)
+{
+  mLock.Lock();
+  HandleOf<Job> job = mQueues[priority].PopBack();
+  mLock.Unlock();
+  return job;
+}
+
+HandleOf<Job> JobWorker::Steal(JobPriority::Enum priority)
+{
+  mLock.Lock();
+  HandleOf<Job> job = mQueues[priority].PopFront();
+  mLock.Unlock();
+  return job;
+}
+
+void JobWorker::PushTask(Task* task)
+{
+  mLock.Lock();
+  mTasks.PushBack(task);
+  mLock.Unlock();
+}
+
+Task* JobWorker::PopOwnTask()
+{
+  mLock.Lock();
+  Task* task = mTasks.PopBack();
+  mLock.Unlock();
+  return task;
+}
+
+Task* JobWorker::StealTask()
+{
+  mLock.Lock();
+  Task* task = mTasks.PopFront();
+  mLock.Unlock();
+  return task;
+}
+
+void JobWorker::AddActive(Job* job)
+{
+  mLock.Lock();
+  job->mWorker = this;
+  mActiveJobs.PushBack(job);
+  mLock.Unlock();
+}
+
+void JobWorker::RemoveActive(Job* job)
+{
+  // Releasing the handle may delete the job, so release it outside of the lock.
+  HandleOf<Job> jobHandle = job;
+  mLock.Lock();
+  mActiveJobs.EraseValue(jobHandle);
+  mLock.Unlock();
+}
+
 namespace PL
 {
 JobSystem* gJobs = nullptr;
 }
 
-JobSystem::JobSystem()
+JobSystem::JobSystem() : mOutstandingJobs(0), mNextWorker(0), mShuttingDown(false)
 {
+  // Leave a hardware thread for the main thread, but always keep a couple of
+  // workers around because some jobs block on IO for long periods of time.
+  uint workerCount = 1;
   if (ThreadingEnabled)
   {
-    mWorkers.Resize(10);
+    uint processorCount = Os::GetProcessorCount();
+    workerCount = Math::Max(processorCount, 3u) - 1;
+  }
 
+  mWorkers.Resize(workerCount);
+  for (uint i = 0; i < mWorkers.Size(); ++i)
+    mWorkers[i] = new JobWorker(this, i);
+
+  if (ThreadingEnabled)
+  {
     for (uint i = 0; i < mWorkers.Size(); ++i)
     {
-      mWorkers[i] = new Thread();
-      Thread& thread = *mWorkers[i];
-      thread.Initialize(&Thread::ObjectEntryCreator<JobSystem, &JobSystem::WorkerThreadEntry>, this, "Background");
+      JobWorker* worker = mWorkers[i];
+      worker->mThread.Initialize(
+          &Thread::ObjectEntryCreator<JobWorker, &JobWorker::WorkerThreadEntry>, worker, "Background");
     }
   }
 }
 
 JobSystem::~JobSystem()
 {
-  // Cancel all active Jobs.
-  mLock.Lock();
-  // Active job range is safe because of the lock.
-  forRange (Job& job, mActiveJobs.All())
-    job.Cancel();
+  mShuttingDown = true;
 
-  // Release all active and pending job references that we own (this may delete
-  // the jobs).
-  mPendingJobs.Clear();
-  mLock.Unlock();
+  // Cancel all active Jobs and release all pending job references that we own
+  // (this may delete the jobs).
+  forRange (JobWorker* worker, mWorkers.All())
+  {
+    worker->mLock.Lock();
+    // Active job range is safe because of the lock.
+    forRange (Job& job, worker->mActiveJobs.All())
+      job.Cancel();
+
+    for (uint i = 0; i < JobPriority::Size; ++i)
+      worker->mQueues[i].Clear();
+    worker->mTasks.Clear();
+    worker->mLock.Unlock();
+  }
 
   // Increment the counter but push no jobs
   // allowing each background thread to unblock.
@@ -71,41 +333,63 @@ JobSystem::~JobSystem()
     mJobCounter.Increment();
 
   // Wait for each thread to shutdown.
-  for (uint i = 0; i < mWorkers.Size(); ++i)
+  if (ThreadingEnabled)
   {
-    Thread& thread = *mWorkers[i];
-    thread.WaitForCompletion();
+    for (uint i = 0; i < mWorkers.Size(); ++i)
+      mWorkers[i]->mThread.WaitForCompletion();
   }
 
   // Clear all active jobs now that all threads have stopped (may release the
   // memory for jobs). There should be no more threads running, but we lock just
   // to be safe.
-  mLock.Lock();
-  mActiveJobs.Clear();
-  mLock.Unlock();
+  forRange (JobWorker* worker, mWorkers.All())
+  {
+    worker->mLock.Lock();
+    worker->mActiveJobs.Clear();
+    worker->mLock.Unlock();
+  }
 
-  // Delete all threads.
+  // Delete all workers.
   DeleteObjectsInContainer(mWorkers);
+  DeleteObjectsInContainer(mWaitSemaphores);
 }
 
-Job* JobSystem::GetNextJob()
+Job* JobSystem::TakeJob(JobWorker* worker)
 {
-  Job* job = nullptr;
+  uint workerCount = mWorkers.Size();
 
-  // Locked pop front
-  mLock.Lock();
-  if (!mPendingJobs.Empty())
+  for (uint priority = 0; priority < JobPriority::Size; ++priority)
   {
-    HandleOf<Job> jobHandle = mPendingJobs.Back();
-    job = jobHandle;
-    mPendingJobs.PopBack();
-    mActiveJobs.PushBack(jobHandle);
+    JobPriority::Enum queue = (JobPriority::Enum)priority;
+
+    // Our own queue first (last in, first out).
+    HandleOf<Job> jobHandle = worker->PopOwn(queue);
+
+    // Otherwise steal the oldest job from the other workers.
+    for (uint i = 1; i < workerCount && jobHandle.IsNull(); ++i)
+      jobHandle = mWorkers[(worker->mIndex + i) % workerCount]->Steal(queue);
+
+    if (Job* job = jobHandle)
+    {
+      // The job will be kept alive by being inside of the worker's active jobs,
+      // so we don't need to return a handle.
+      worker->AddActive(job);
+      return job;
+    }
   }
-  mLock.Unlock();
 
-  // We don't need to return a handle because the job will
-  // be kept alive by being inside of mActiveJobs.
-  return job;
+  return nullptr;
+}
+
+Task* JobSystem::TakeTask(JobWorker* worker)
+{
+  Task* task = worker->PopOwnTask();
+
+  uint workerCount = mWorkers.Size();
+  for (uint i = 1; i < workerCount && task == nullptr; ++i)
+    task = mWorkers[(worker->mIndex + i) % workerCount]->StealTask();
+
+  return task;
 }
 
 void JobSystem::RunJobsTimeSliced(double seconds)
@@ -116,54 +400,190 @@ void JobSystem::RunJobsTimeSliced(double seconds)
   Timer timer;
   do
   {
-    if (!RunOneJob())
+    if (!RunOneJob(mWorkers.Front()))
       return;
+    // Nothing waits on the counter without threads, but keep it matching the queues.
+    mJobCounter.Decrement();
   } while (timer.UpdateAndGetTime() < seconds);
 }
 
 bool JobSystem::AreAllJobsCompleted()
 {
-  mLock.Lock();
-  bool completed = mPendingJobs.Empty() && mActiveJobs.Empty();
-  mLock.Unlock();
-  return completed;
+  return mOutstandingJobs == 0;
 }
 
-OsInt JobSystem::WorkerThreadEntry()
+uint JobSystem::GetWorkerCount()
 {
-  for (;;)
-  {
-    if (!RunOneJob())
-      return 0;
-  }
+  return ThreadingEnabled ? mWorkers.Size() : 0;
 }
 
 void JobSystem::AddJob(Job* job)
 {
   if (!ThreadingEnabled && job->mRunImmediateWhenThreadingDisabled)
   {
-    ++job->mRunCount;
+    if (job->mRunCount++ == 0)
+      ++mOutstandingJobs;
+    // Not kept alive by a worker, so there's nothing to remove on completion.
+    job->mWorker = nullptr;
     RunJob(job);
     return;
   }
 
-  mLock.Lock();
-  if (job->mRunCount == 0)
-    mPendingJobs.PushBack(job);
-  ++job->mRunCount;
-  mLock.Unlock();
+  // If the job is already pending or running it will just be run again when it completes.
+  if (job->mRunCount++ != 0)
+    return;
+
+  ++mOutstandingJobs;
+
+  // Jobs added from a worker go to its own queue (they're likely to share data with
+  // the job that is running), everyone else spreads jobs between the workers.
+  JobWorker* worker = gCurrentJobWorker;
+  if (worker == nullptr || worker->mSystem != this)
+    worker = mWorkers[mNextWorker++ % mWorkers.Size()];
+  worker->Push(job);
+
+  // Signal that a job has been added, which will unblock a waiting worker.
+  mJobCounter.Increment();
+}
+
+uint JobSystem::GetParallelTaskCount(uint count, uint grainSize)
+{
+  uint workerCount = GetWorkerCount();
+  if (workerCount == 0)
+    return 1;
+
+  // Split evenly with a few chunks per thread (workers plus the calling thread)
+  // so that threads that finish early can steal the rest.
+  if (grainSize == 0)
+    grainSize = Math::Max(count / ((workerCount + 1) * 4), 1u);
+
+  uint taskCount = (count + grainSize - 1) / grainSize;
+  uint maxTaskCount = cMaxParallelTasks;
+  return Math::Clamp(taskCount, 1u, maxTaskCount);
+}
+
+void JobSystem::AddTask(Task* task, TaskCounter* counter)
+{
+  task->mCounter = counter;
+  if (counter != nullptr)
+    ++counter->mCount;
+
+  QueueTask(task);
+}
+
+void JobSystem::QueueTask(Task* task)
+{
+  JobWorker* worker = gCurrentJobWorker;
+  if (worker == nullptr || worker->mSystem != this)
+    worker = mWorkers[mNextWorker++ % mWorkers.Size()];
+  worker->PushTask(task);
 
-  // Signal that a job has been added, which will unblock the waiting workers.
   mJobCounter.Increment();
 }
 
-bool JobSystem::RunOneJob()
+void JobSystem::WaitAndHelp(TaskCounter& counter)
 {
-  mJobCounter.WaitAndDecrement();
-  Job* job = GetNextJob();
+  // Threads that aren't workers help from the first worker's queue
+  // (when threading is disabled that's where every task is).
+  JobWorker* worker = gCurrentJobWorker;
+  if (worker == nullptr || worker->mSystem != this)
+    worker = mWorkers.Front();
 
-  // No jobs and Semaphore release
-  // that means we are shutting down.
+  // How many times in a row to yield without finding a task before blocking.
+  const uint cMaxIdleSpins = 64;
+
+  uint idleSpins = 0;
+  while (!counter.IsComplete())
+  {
+    // Takes from our own queue and otherwise steals from the other workers.
+    Task* task = TakeTask(worker);
+    if (task != nullptr)
+    {
+      // Consume the count the task was queued with so it doesn't wake a worker for nothing.
+      mJobCounter.Decrement();
+      RunTask(task);
+      idleSpins = 0;
+      continue;
+    }
+
+    // The rest of the tasks are running on other threads, so stop burning
+    // this core and wait for the last of them to signal us.
+    if (ThreadingEnabled && ++idleSpins >= cMaxIdleSpins)
+    {
+      BlockUntilComplete(counter);
+      return;
+    }
+    Os::Sleep(0);
+  }
+}
+
+void JobSystem::BlockUntilComplete(TaskCounter& counter)
+{
+  Semaphore* semaphore = nullptr;
+  mWaitSemaphoreLock.Lock();
+  if (!mWaitSemaphores.Empty())
+  {
+    semaphore = mWaitSemaphores.Back();
+    mWaitSemaphores.PopBack();
+  }
+  mWaitSemaphoreLock.Unlock();
+  if (semaphore == nullptr)
+    semaphore = new Semaphore();
+
+  // The waiter has to be set before the flag is, as the flag is what tells the
+  // last task to signal it. If the count reaches zero first there's nothing to wait for.
+  counter.mWaiter = semaphore;
+  s32 count = counter.mCount;
+  while (count != 0)
+  {
+    s32 previous = counter.mCount.CompareExchange(count | TaskCounter::cWaitingFlag, count);
+    if (previous == count)
+    {
+      semaphore->WaitAndDecrement();
+      counter.mCount = 0;
+      break;
+    }
+    count = previous;
+  }
+  counter.mWaiter = nullptr;
+
+  mWaitSemaphoreLock.Lock();
+  mWaitSemaphores.PushBack(semaphore);
+  mWaitSemaphoreLock.Unlock();
+}
+
+void JobSystem::RunTask(Task* task)
+{
+  task->Execute();
+
+  // The task may be destroyed as soon as its counter reaches zero (it's usually on
+  // the waiting thread's stack), so everything else has to be done first.
+  TaskCounter* counter = task->mCounter;
+  forRange (Task* continuation, task->mContinuations.All())
+  {
+    if (--continuation->mDependencies == 0)
+      QueueTask(continuation);
+  }
+
+  // A counter with a blocked waiter stays alive until the waiter is signaled.
+  if (counter != nullptr)
+  {
+    s32 previous = counter->mCount.FetchSubtract(1);
+    if (previous == (TaskCounter::cWaitingFlag | 1))
+      counter->mWaiter->Increment();
+  }
+}
+
+bool JobSystem::RunOneJob(JobWorker* worker)
+{
+  // Tasks are used for work the frame is waiting on, so they always go first.
+  if (Task* task = TakeTask(worker))
+  {
+    RunTask(task);
+    return true;
+  }
+
+  Job* job = TakeJob(worker);
   if (job == nullptr)
     return false;
 
@@ -181,18 +601,20 @@ void JobSystem::RunJob(Job* job)
 
 void JobSystem::JobComplete(Job* job)
 {
-  mLock.Lock();
-  --job->mRunCount;
-  bool completed = (job->mRunCount == 0);
-  if (completed)
-  {
-    HandleOf<Job> jobHandle = job;
-    mActiveJobs.EraseValue(jobHandle);
-  }
-  mLock.Unlock();
+  // Read the worker before decrementing, as once the count reaches zero the job
+  // may be added again and taken by a different worker.
+  JobWorker* worker = job->mWorker;
 
+  bool completed = (--job->mRunCount == 0);
   if (!completed)
+  {
     RunJob(job);
+    return;
+  }
+
+  --mOutstandingJobs;
+  if (worker != nullptr)
+    worker->RemoveActive(job);
 }
 
 } // namespace Plasma
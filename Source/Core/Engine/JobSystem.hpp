@@ -7,10 +7,19 @@
 namespace Plasma
 {
 
+class JobSystem;
+class JobWorker;
+
+/// Workers always take the highest priority job available (from any worker)
+/// before looking at lower priorities, so latency sensitive jobs such as path
+/// finding are not starved behind long running jobs such as content builds.
+DeclareEnum3(JobPriority, High, Normal, Low);
+
 class Job : public ReferenceCountedEventObject
 {
 public:
   friend class JobSystem;
+  friend class JobWorker;
   LightningDeclareType(Job, TypeCopyMode::ReferenceType);
   Job();
   virtual ~Job();
@@ -39,17 +48,191 @@ public:
   // When threading is disabled, should we run this task immediately when AddJob is called?
   bool mRunImmediateWhenThreadingDisabled = false;
 
+  // Which queue the job is placed in when added. Only read when the job is added.
+  JobPriority::Enum mPriority = JobPriority::Normal;
+
 private:
   // This value is incremented by the job system every time we add the job.
   // If the value is greater than 1, the thread will run it multiple times.
-  // Must be locked by the JobSystem.
-  size_t mRunCount;
+  Atomic<size_t> mRunCount;
+
+  // The worker that is keeping this job alive while it runs (set when the job is taken).
+  JobWorker* mWorker;
+};
+
+class TaskCounter;
+
+/// A light weight unit of work that is owned by the caller (typically on the
+/// stack or by a TaskGraph) rather than being reference counted like a Job.
+/// Tasks are meant for fork/join data parallelism inside the frame, so they are
+/// always taken before any Job and a thread waiting on them will help run them.
+class Task
+{
+public:
+  friend class JobSystem;
+  friend class TaskGraph;
+  Task();
+  virtual ~Task();
+
+  // Called on a worker or on a thread that is waiting for the task to complete.
+  virtual void Execute() = 0;
+
+private:
+  // The number of tasks that still have to complete before this one is queued.
+  Atomic<s32> mDependencies;
+  // How many dependencies this task was given (used to reset mDependencies).
+  s32 mDependencyCount;
+  // Tasks that depend on this one.
+  Array<Task*> mContinuations;
+  // Decremented once this task completes (may be null).
+  TaskCounter* mCounter;
+};
+
+/// Counts tasks that haven't completed yet. Waiting on a counter
+/// (JobSystem::WaitAndHelp) runs pending tasks rather than blocking, and only
+/// blocks once there's nothing left to help with. Only one thread may wait on a counter.
+class TaskCounter
+{
+public:
+  TaskCounter();
+
+  bool IsComplete();
+
+  // Set in mCount while a thread is blocked on the counter, the task that
+  // completes the count then signals mWaiter.
+  static const s32 cWaitingFlag = 1 << 30;
+
+  Atomic<s32> mCount;
+  Semaphore* mWaiter;
+};
+
+/// Calls a functor (anything with an operator() taking no arguments).
+template <typename FunctorType>
+class FunctorTask : public Task
+{
+public:
+  FunctorTask(const FunctorType& functor) : mFunctor(functor)
+  {
+  }
+
+  void Execute() override
+  {
+    mFunctor();
+  }
+
+  FunctorType mFunctor;
+};
+
+/// A set of tasks with dependencies between them that can be run (and re-run)
+/// as a whole. Tasks without dependencies start immediately, every other task
+/// is queued by the last of its dependencies to complete.
+class TaskGraph
+{
+public:
+  ~TaskGraph();
+
+  // Adds a task owned by the caller.
+  Task* Add(Task* task);
+
+  // Adds a task that calls a copy of the functor (owned by the graph).
+  template <typename FunctorType>
+  Task* Add(const FunctorType& functor)
+  {
+    Task* task = new FunctorTask<FunctorType>(functor);
+    mOwnedTasks.PushBack(task);
+    return Add(task);
+  }
+
+  // The task will not be started until dependsOn has completed.
+  void AddDependency(Task* task, Task* dependsOn);
+
+  // Runs every task and waits for all of them to complete (helping out on
+  // the calling thread while waiting).
+  void Run();
+
+  void Clear();
+
+private:
+  Array<Task*> mTasks;
+  Array<Task*> mOwnedTasks;
+};
+
+/// A queue of tasks that the owning worker pushes and pops from the back while
+/// other workers steal from the front. Must be locked by the owning JobWorker.
+class TaskQueue
+{
+public:
+  TaskQueue();
+
+  bool Empty();
+  void PushBack(Task* task);
+  Task* PopBack();
+  Task* PopFront();
+  void Clear();
+
+private:
+  Array<Task*> mTasks;
+  // Everything before this index has already been stolen.
+  size_t mFront;
+};
+
+/// A queue of jobs that the owning worker pushes and pops from the back (most
+/// recently added, likely still in cache) while other workers steal from the
+/// front (oldest). Must be locked by the owning JobWorker.
+class JobQueue
+{
+public:
+  JobQueue();
+
+  bool Empty();
+  void PushBack(Job* job);
+  HandleOf<Job> PopBack();
+  HandleOf<Job> PopFront();
+  void Clear();
+
+private:
+  Array<HandleOf<Job>> mJobs;
+  // Everything before this index has already been stolen.
+  size_t mFront;
+};
+
+/// One worker thread of the JobSystem along with its own set of job queues.
+class JobWorker
+{
+public:
+  JobWorker(JobSystem* system, uint index);
+
+  OsInt WorkerThreadEntry();
+
+  // Locked push / pop / steal helpers.
+  void Push(Job* job);
+  HandleOf<Job> PopOwn(JobPriority::Enum priority);
+  HandleOf<Job> Steal(JobPriority::Enum priority);
+  void PushTask(Task* task);
+  Task* PopOwnTask();
+  Task* StealTask();
+
+  // Keeps the job alive until it completes (it may run asynchronously).
+  void AddActive(Job* job);
+  void RemoveActive(Job* job);
+
+  JobSystem* mSystem;
+  uint mIndex;
+  Thread mThread;
+
+  // Protects the queues and the active jobs. Only held for a push, pop or steal.
+  SpinLock mLock;
+  JobQueue mQueues[JobPriority::Size];
+  TaskQueue mTasks;
+  Array<HandleOf<Job>> mActiveJobs;
 };
 
 class JobSystem : public EventObject
 {
 public:
   friend class Job;
+  friend class JobWorker;
+  friend class TaskGraph;
   typedef JobSystem LightningSelf;
   JobSystem();
   ~JobSystem();
@@ -57,7 +240,6 @@ public:
   // Add's a job to be worked on (can be called from any thread).
   // Note that a job can be queued up again after it completes.
   void AddJob(Job* job);
-  OsInt WorkerThreadEntry();
 
   // Runs until a slice of time is taken (only when ThreadingEnabled is false).
   // Returns false if there is no work to be done.
@@ -66,22 +248,75 @@ public:
 
   bool AreAllJobsCompleted();
 
+  // The number of worker threads (sized from the hardware thread count).
+  uint GetWorkerCount();
+
+  // Queues a task to be run by any worker (can be called from any thread).
+  // The counter (if given) is incremented now and decremented when the task completes.
+  void AddTask(Task* task, TaskCounter* counter = nullptr);
+
+  // Runs pending tasks on the calling thread until the counter reaches zero.
+  // Only tasks are run while waiting (never jobs, which may run for a long time).
+  void WaitAndHelp(TaskCounter& counter);
+
+  // Splits [begin, end) into chunks of at least grainSize (or an even split
+  // between the workers when grainSize is 0) and calls functor(chunkBegin, chunkEnd)
+  // for every chunk in parallel. Returns once every chunk has completed.
+  template <typename FunctorType>
+  void ParallelFor(uint begin, uint end, FunctorType& functor, uint grainSize = 0);
+
+  // Same as ParallelFor, but functor(chunkBegin, chunkEnd) returns a result for
+  // the chunk and the results are combined with combiner(a, b) in chunk order
+  // (so the result doesn't depend on which threads ran the chunks).
+  template <typename ResultType, typename FunctorType, typename CombinerType>
+  ResultType ParallelReduce(
+      uint begin, uint end, const ResultType& identity, FunctorType& functor, CombinerType& combiner, uint grainSize = 0);
+
+  // The most tasks a single ParallelFor / ParallelReduce is split into.
+  static const uint cMaxParallelTasks = 64;
+
 private:
-  // Takes a job from the job queue and runs it.
+  // Returns how many tasks a parallel loop over count items should be split into.
+  uint GetParallelTaskCount(uint count, uint grainSize);
+
+  // Queues a task whose counter has already been incremented.
+  void QueueTask(Task* task);
+
+  // Takes a pending task, preferring the given worker's own queue.
+  Task* TakeTask(JobWorker* worker);
+
+  // Runs the task, queues any continuations that are now ready and then completes it.
+  void RunTask(Task* task);
+
+  // Blocks the calling thread until the counter completes (see TaskCounter::cWaitingFlag).
+  void BlockUntilComplete(TaskCounter& counter);
+
+  // Takes the highest priority job available, preferring the given worker's own
+  // queues and otherwise stealing from the other workers. Returns null if there
+  // are no pending jobs.
+  Job* TakeJob(JobWorker* worker);
+
+  // Takes a job and runs it on the calling thread.
   // If no jobs are available, this will return false.
-  bool RunOneJob();
+  bool RunOneJob(JobWorker* worker);
 
   void RunJob(Job* job);
 
   void JobComplete(Job* job);
 
-  ThreadLock mLock;
-  Array<HandleOf<Job>> mPendingJobs;
-  Array<HandleOf<Job>> mActiveJobs;
-  Array<Thread*> mWorkers;
+  // Always contains at least one worker (when threading is disabled its
+  // queues are drained by RunJobsTimeSliced on the main thread).
+  Array<JobWorker*> mWorkers;
+  // Counts pending jobs so that idle workers can block.
   Semaphore mJobCounter;
-  Job* GetNextJob();
-  friend class Job;
+  // Jobs added or currently running (used for AreAllJobsCompleted).
+  Atomic<s32> mOutstandingJobs;
+  // Jobs added from non-worker threads are distributed round robin.
+  Atomic<u32> mNextWorker;
+  // Semaphores for threads blocked in WaitAndHelp (kept to avoid creating one every wait).
+  Array<Semaphore*> mWaitSemaphores;
+  SpinLock mWaitSemaphoreLock;
+  Atomic<bool> mShuttingDown;
 };
 
 namespace PL
@@ -89,4 +324,100 @@ namespace PL
 extern JobSystem* gJobs;
 }
 
+template <typename FunctorType>
+class ParallelForTask : public Task
+{
+public:
+  void Execute() override
+  {
+    (*mFunctor)(mBegin, mEnd);
+  }
+
+  FunctorType* mFunctor;
+  uint mBegin;
+  uint mEnd;
+};
+
+template <typename ResultType, typename FunctorType>
+class ParallelReduceTask : public Task
+{
+public:
+  void Execute() override
+  {
+    mResult = (*mFunctor)(mBegin, mEnd);
+  }
+
+  FunctorType* mFunctor;
+  uint mBegin;
+  uint mEnd;
+  ResultType mResult;
+};
+
+template <typename FunctorType>
+void JobSystem::ParallelFor(uint begin, uint end, FunctorType& functor, uint grainSize)
+{
+  if (end <= begin)
+    return;
+
+  uint count = end - begin;
+  uint taskCount = GetParallelTaskCount(count, grainSize);
+  if (taskCount == 1)
+  {
+    functor(begin, end);
+    return;
+  }
+
+  // The tasks live on our stack, which is safe because we don't return until they have all completed.
+  ParallelForTask<FunctorType> tasks[cMaxParallelTasks];
+  TaskCounter counter;
+  for (uint i = 0; i < taskCount; ++i)
+  {
+    ParallelForTask<FunctorType>& task = tasks[i];
+    task.mFunctor = &functor;
+    task.mBegin = begin + (uint)((u64)count * i / taskCount);
+    task.mEnd = begin + (uint)((u64)count * (i + 1) / taskCount);
+  }
+
+  // Queue everything but the first chunk, which the calling thread runs itself.
+  for (uint i = 1; i < taskCount; ++i)
+    AddTask(&tasks[i], &counter);
+  tasks[0].Execute();
+
+  WaitAndHelp(counter);
+}
+
+template <typename ResultType, typename FunctorType, typename CombinerType>
+ResultType JobSystem::ParallelReduce(
+    uint begin, uint end, const ResultType& identity, FunctorType& functor, CombinerType& combiner, uint grainSize)
+{
+  if (end <= begin)
+    return identity;
+
+  uint count = end - begin;
+  uint taskCount = GetParallelTaskCount(count, grainSize);
+  if (taskCount == 1)
+    return combiner(identity, functor(begin, end));
+
+  ParallelReduceTask<ResultType, FunctorType> tasks[cMaxParallelTasks];
+  TaskCounter counter;
+  for (uint i = 0; i < taskCount; ++i)
+  {
+    ParallelReduceTask<ResultType, FunctorType>& task = tasks[i];
+    task.mFunctor = &functor;
+    task.mBegin = begin + (uint)((u64)count * i / taskCount);
+    task.mEnd = begin + (uint)((u64)count * (i + 1) / taskCount);
+  }
+
+  for (uint i = 1; i < taskCount; ++i)
+    AddTask(&tasks[i], &counter);
+  tasks[0].Execute();
+
+  WaitAndHelp(counter);
+
+  ResultType result = identity;
+  for (uint i = 0; i < taskCount; ++i)
+    result = combiner(result, tasks[i].mResult);
+  return result;
+}
+
 } // namespace Plasma
@@ -214,6 +214,10 @@ public:
   // Is the space currently in the process of loading a level right now.
   bool mIsLoadingLevel;
 
+  // Components updated right after Events::LogicUpdate is dispatched on this
+  // space (for components that opt out of connecting to it).
+  UpdateRegistry mLogicUpdates;
+
   void SerializeObjectsToSpace(CogInitializer& initializer, CogCreationContext& context, Serializer& loader);
 
   friend class Cog;
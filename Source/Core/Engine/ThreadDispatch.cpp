@@ -27,20 +27,15 @@ void ThreadDispatch::DispatchOn(HandleParam object, EventDispatcher* eventDispat
   queuedEvent.EventDispatcherOn = eventDispatcher;
   queuedEvent.EventId = eventId;
 
-  mLock.Lock();
-  mEvents.PushBack(queuedEvent);
-  mLock.Unlock();
+  mEvents.Push(queuedEvent);
 }
 
 void ThreadDispatch::DispatchEvents()
 {
   Array<QueuedEvent> eventsToDispatch;
 
-  // To avoid dead lock pull out all message before dispatching
-  //(dispatching may add more events)
-  mLock.Lock();
-  eventsToDispatch.Swap(mEvents);
-  mLock.Unlock();
+  // Pull out all messages before dispatching (dispatching may add more events)
+  mEvents.Drain(eventsToDispatch);
 
   forRange (QueuedEvent& queuedEvent, eventsToDispatch.All())
   {
@@ -58,9 +53,7 @@ void ThreadDispatch::ClearEvents()
 {
   Array<QueuedEvent> eventsToDispatch;
 
-  mLock.Lock();
-  eventsToDispatch.Swap(mEvents);
-  mLock.Unlock();
+  mEvents.Drain(eventsToDispatch);
 
   forRange (QueuedEvent& queuedEvent, eventsToDispatch.All())
   {
@@ -86,20 +79,15 @@ void ObjectThreadDispatch::Dispatch(Object* object, StringParam eventId, Event*
   queuedEvent.EventDispatcherOn = object->GetDispatcher();
   queuedEvent.EventId = eventId;
 
-  mLock.Lock();
-  mEvents.PushBack(queuedEvent);
-  mLock.Unlock();
+  mEvents.Push(queuedEvent);
 }
 
 void ObjectThreadDispatch::DispatchEvents()
 {
   Array<ObjectQueuedEvent> eventsToDispatch;
 
-  // To avoid dead lock pull out all message before dispatching (dispatching may
-  // add more events)
-  mLock.Lock();
-  eventsToDispatch.Swap(mEvents);
-  mLock.Unlock();
+  // Pull out all messages before dispatching (dispatching may add more events)
+  mEvents.Drain(eventsToDispatch);
 
   forRange (ObjectQueuedEvent& queuedEvent, eventsToDispatch.All())
   {
@@ -115,9 +103,7 @@ void ObjectThreadDispatch::ClearEvents()
 {
   Array<ObjectQueuedEvent> eventsToDispatch;
 
-  mLock.Lock();
-  eventsToDispatch.Swap(mEvents);
-  mLock.Unlock();
+  mEvents.Drain(eventsToDispatch);
 
   forRange (ObjectQueuedEvent& queuedEvent, eventsToDispatch.All())
   {
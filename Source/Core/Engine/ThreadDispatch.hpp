@@ -31,8 +31,7 @@ public:
   void ClearEvents();
 
 private:
-  ThreadLock mLock;
-  Array<QueuedEvent> mEvents;
+  MpscQueue<QueuedEvent> mEvents;
 };
 
 /// A thread dispatch list for storage by an event receiver. Connects to
@@ -66,8 +65,7 @@ public:
   void OnEngineUpdate(Event* e);
 
 private:
-  ThreadLock mLock;
-  Array<ObjectQueuedEvent> mEvents;
+  MpscQueue<ObjectQueuedEvent> mEvents;
 };
 
 namespace PL
@@ -268,6 +268,7 @@ void TimeSpace::Step()
     ZoneScopedN("Logic Update");
     ProfileScopeTree("LogicUpdate", "TimeSystem", Color::Gainsboro);
     dispatcher->Dispatch(Events::LogicUpdate, &updateEvent);
+    GetSpace()->mLogicUpdates.Update(&updateEvent);
   }
 
   {
@@ -0,0 +1,151 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// Thread safe lists smaller than this are not worth splitting into tasks.
+const uint cMinParallelUpdateCount = 256;
+const uint cParallelUpdateGrainSize = 64;
+
+// Updates a range of one list's components (used with JobSystem::ParallelFor).
+struct ComponentBatchUpdater
+{
+  void operator()(uint begin, uint end)
+  {
+    UpdateRegistry::UpdateFunction function = mFunction;
+    for (uint i = begin; i < end; ++i)
+    {
+      if (Component* component = mComponents[i])
+        function(component, mEvent);
+    }
+  }
+
+  UpdateRegistry::UpdateFunction mFunction;
+  Component** mComponents;
+  UpdateEvent* mEvent;
+};
+
+UpdateRegistry::UpdateRegistry()
+{
+  mUpdating = false;
+  mNeedsCompact = false;
+}
+
+void UpdateRegistry::Add(Component* component, UpdateFunction function, bool threadSafe)
+{
+  ReturnIf(mSlots.ContainsKey(component), , "Component was already added to the update registry.");
+
+  // Find the list for this update function (there are only ever a few)
+  uint listIndex = 0;
+  while (listIndex < mLists.Size() && mLists[listIndex].mFunction != function)
+    ++listIndex;
+
+  if (listIndex == mLists.Size())
+  {
+    UpdateList& list = mLists.PushBack();
+    list.mFunction = function;
+    list.mThreadSafe = threadSafe;
+  }
+
+  // Components added while updating are not updated until the next update
+  Array<Component*>& components = mLists[listIndex].mComponents;
+  UpdateSlot slot;
+  slot.mList = listIndex;
+  slot.mIndex = components.Size();
+  components.PushBack(component);
+  mSlots.Insert(component, slot);
+}
+
+void UpdateRegistry::Remove(Component* component)
+{
+  UpdateSlot* slot = mSlots.FindPointer(component);
+  if (slot == nullptr)
+    return;
+
+  Array<Component*>& components = mLists[slot->mList].mComponents;
+  if (mUpdating)
+  {
+    // Indices can't change while updating
+    components[slot->mIndex] = nullptr;
+    mNeedsCompact = true;
+  }
+  else
+  {
+    // Move the last component into the removed component's place
+    Component* last = components.Back();
+    components[slot->mIndex] = last;
+    mSlots[last].mIndex = slot->mIndex;
+    components.PopBack();
+  }
+
+  mSlots.Erase(component);
+}
+
+bool UpdateRegistry::Contains(Component* component)
+{
+  return mSlots.ContainsKey(component);
+}
+
+void UpdateRegistry::Update(UpdateEvent* event)
+{
+  ErrorIf(mUpdating, "Update registry updated recursively.");
+  mUpdating = true;
+
+  // Lists added while updating are not updated until the next update
+  uint listCount = mLists.Size();
+  for (uint i = 0; i < listCount; ++i)
+    UpdateComponents(mLists[i], event);
+
+  mUpdating = false;
+
+  if (mNeedsCompact)
+    Compact();
+}
+
+void UpdateRegistry::UpdateComponents(UpdateList& list, UpdateEvent* event)
+{
+  uint count = list.mComponents.Size();
+
+  if (list.mThreadSafe && count >= cMinParallelUpdateCount)
+  {
+    ComponentBatchUpdater updater;
+    updater.mFunction = list.mFunction;
+    updater.mComponents = list.mComponents.Data();
+    updater.mEvent = event;
+    PL::gJobs->ParallelFor(0, count, updater, cParallelUpdateGrainSize);
+    return;
+  }
+
+  // The array may grow (and move) if components are added while updating
+  for (uint i = 0; i < count; ++i)
+  {
+    if (Component* component = list.mComponents[i])
+      list.mFunction(component, event);
+  }
+}
+
+void UpdateRegistry::Compact()
+{
+  for (uint listIndex = 0; listIndex < mLists.Size(); ++listIndex)
+  {
+    Array<Component*>& components = mLists[listIndex].mComponents;
+
+    uint count = 0;
+    for (uint i = 0; i < components.Size(); ++i)
+    {
+      Component* component = components[i];
+      if (component == nullptr)
+        continue;
+
+      components[count] = component;
+      mSlots[component].mIndex = count;
+      ++count;
+    }
+    components.Resize(count);
+  }
+
+  mNeedsCompact = false;
+}
+
+} // namespace Plasma
@@ -0,0 +1,72 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+class Component;
+class UpdateEvent;
+
+/// Calls update functions on components grouped by component type instead of
+/// through one EventConnection per component. Each type keeps its components
+/// in a contiguous array and every type is updated in turn. Types added as
+/// thread safe are split across the job system, so their update functions must
+/// only touch the component's own state and must not add or remove updates.
+/// The order of components within a type is not the order they were added in.
+class UpdateRegistry
+{
+public:
+  typedef void (*UpdateFunction)(Component* component, UpdateEvent* event);
+
+  UpdateRegistry();
+
+  /// Registers the component to be updated with ComponentType::Function.
+  template <typename ComponentType, void (ComponentType::*Function)(UpdateEvent*)>
+  void Add(ComponentType* component, bool threadSafe = false)
+  {
+    Add(component, &CallUpdate<ComponentType, Function>, threadSafe);
+  }
+
+  void Add(Component* component, UpdateFunction function, bool threadSafe);
+
+  /// Safe to call while updating (the component will not be updated).
+  void Remove(Component* component);
+  bool Contains(Component* component);
+
+  /// Updates every registered component, type by type.
+  void Update(UpdateEvent* event);
+
+  template <typename ComponentType, void (ComponentType::*Function)(UpdateEvent*)>
+  static void CallUpdate(Component* component, UpdateEvent* event)
+  {
+    (static_cast<ComponentType*>(component)->*Function)(event);
+  }
+
+private:
+  struct UpdateList
+  {
+    UpdateFunction mFunction;
+    bool mThreadSafe;
+    // Components removed while updating are set to null until the update ends.
+    Array<Component*> mComponents;
+  };
+
+  // Where a component is stored.
+  struct UpdateSlot
+  {
+    uint mList;
+    uint mIndex;
+  };
+
+  void UpdateComponents(UpdateList& list, UpdateEvent* event);
+  // Removes components that were set to null while updating.
+  void Compact();
+
+  // One per update function, in the order each was first added.
+  Array<UpdateList> mLists;
+  FlatHashMap<Component*, UpdateSlot> mSlots;
+  bool mUpdating;
+  bool mNeedsCompact;
+};
+
+} // namespace Plasma
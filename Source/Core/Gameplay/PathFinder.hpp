@@ -225,6 +225,8 @@ public:
     job->mMainThreadPathFinderDispatcher = GetDispatcher();
     job->mAlgorithm = algorithm;
     job->mMaxIterations = maxIterations;
+    // Gameplay is usually waiting on the result, so don't queue behind content jobs.
+    job->mPriority = JobPriority::High;
     PL::gJobs->AddJob(job);
 
     return request;
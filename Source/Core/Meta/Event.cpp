@@ -215,7 +215,7 @@ void EventConnection::DisconnectSelf()
   }
 }
 
-EventDispatchList::EventDispatchList()
+EventDispatchList::EventDispatchList(StringParam eventId) : mEventId(eventId)
 {
 }
 
@@ -434,21 +434,12 @@ void EventDispatcher::Dispatch(StringParam eventId, Event* event)
   if (event->mTerminated)
     return;
 
-  BoundType* sentEventType = LightningVirtualTypeId(event);
-
   // Validate that, if this event is bound, we're actually sending the proper
-  // event!
-  BoundType* boundEventType = MetaDatabase::GetInstance()->mEventMap.FindValue(eventId, nullptr);
-
-  if (CheckAllEventsBound)
-  {
-    // Comment this out if there are valid cases!
-    // ErrorIf(boundEventType == nullptr, "Attempting to dispatch an event that
-    // is not bound anywhere, we should bind this!");
-  }
-
+  // event! The meta lookup hashes the event name so only do it when checking.
   if (CheckEventDispatchAsBoundType)
   {
+    BoundType* sentEventType = LightningVirtualTypeId(event);
+    BoundType* boundEventType = MetaDatabase::GetInstance()->mEventMap.FindValue(eventId, nullptr);
     if (boundEventType)
     {
       // The event type that we're sending should be either more derived or the
@@ -464,29 +455,26 @@ void EventDispatcher::Dispatch(StringParam eventId, Event* event)
     }
   }
 
+  // Nothing is listening to this signal
+  EventMapType::range r = mEvents.Find(GetEventAtom(eventId));
+  if (r.Empty())
+    return;
+
   // Store the event Id so we can restore it after
   String previousEventId = event->EventId;
 
   event->EventId = eventId;
 
-  EventMapType::range r = mEvents.Find(eventId);
-  if (!r.Empty())
-  {
-    // Object is listening to this signal.
-    // Signal all objects in the signal chain.
-    r.Front().second->Dispatch(event);
-  }
-  else
-  {
-    // do nothing
-  }
+  // Object is listening to this signal.
+  // Signal all objects in the signal chain.
+  r.Front().second->Dispatch(event);
 
   event->EventId = previousEventId;
 }
 
 bool EventDispatcher::HasReceivers(StringParam eventId)
 {
-  return !mEvents.Find(eventId).Empty();
+  return !mEvents.Find(GetEventAtom(eventId)).Empty();
 }
 
 void EventDispatcher::Connect(StringParam eventId, EventConnection* connection)
@@ -494,7 +482,7 @@ void EventDispatcher::Connect(StringParam eventId, EventConnection* connection)
   ErrorIf(((void*)this) == nullptr, "This is being called on a null dispatcher");
 
   // Check to see if the signal has been mapped
-  EventMapType::range r = mEvents.Find(eventId);
+  EventMapType::range r = mEvents.Find(GetEventAtom(eventId));
   EventDispatchList* list = nullptr;
   if (!r.Empty())
   {
@@ -504,8 +492,8 @@ void EventDispatcher::Connect(StringParam eventId, EventConnection* connection)
   {
     // Event with that eventId not yet mapped. Make a new list and map the event
     // id
-    list = new EventDispatchList();
-    mEvents.Insert(eventId, list);
+    list = new EventDispatchList(eventId);
+    mEvents.Insert(GetEventAtom(eventId), list);
   }
 
   // Bind the connection to the event list
@@ -576,7 +564,7 @@ void EventDispatcher::DisconnectEvent(StringParam eventId, ObjPtr thisObject)
   }
 
   // Disconnect the events with eventId on thisObject
-  EventMapType::range r = mEvents.Find(eventId);
+  EventMapType::range r = mEvents.Find(GetEventAtom(eventId));
   if (!r.Empty())
   {
     r.Front().second->Disconnect(thisObject);
@@ -588,7 +576,7 @@ bool EventDispatcher::IsConnected(StringParam eventId, ObjPtr thisObject)
   ErrorIf(((void*)this) == nullptr, "This is being called on a null dispatcher");
   ErrorIf(thisObject == nullptr, "thisObject was null");
 
-  EventMapType::range r = mEvents.Find(eventId);
+  EventMapType::range r = mEvents.Find(GetEventAtom(eventId));
   if (!r.Empty())
   {
     return r.Front().second->IsConnected(thisObject);
@@ -600,7 +588,7 @@ bool EventDispatcher::IsAnyConnected(StringParam eventId)
 {
   ErrorIf(((void*)this) == nullptr, "This is being called on a null dispatcher");
 
-  EventMapType::range r = mEvents.Find(eventId);
+  EventMapType::range r = mEvents.Find(GetEventAtom(eventId));
   return !r.Empty();
 }
 
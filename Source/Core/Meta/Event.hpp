@@ -51,6 +51,20 @@ public:
 
 DeclareBitField3(ConnectionFlags, Invalid, DoNotDisconnect, Script);
 
+#if !defined(PlasmaStringPooling)
+#  error "Event atoms require pooled Strings"
+#endif
+/// Event ids are pooled Strings (see PlasmaStringPooling), so every String with
+/// the same text shares one StringNode. That node is the event's atom:
+/// dispatchers key on it, so a lookup is one pointer hash and compare.
+/// Events made with DefineEvent create their atoms during static init.
+typedef StringNode* EventAtom;
+
+inline EventAtom GetEventAtom(StringParam eventId)
+{
+  return eventId.GetNode();
+}
+
 /// Makes sure a given event string matches a given event type.
 /// This should ALWAYS be called before attaching to a receiver and a dispatcher
 /// If it returns false, meaning it did not validate, it should not be attached
@@ -151,7 +165,7 @@ class EventDispatchList
 {
 public:
   OverloadedNew();
-  EventDispatchList();
+  EventDispatchList(StringParam eventId);
   ~EventDispatchList();
 
   /// Dispatch event to all connections
@@ -170,6 +184,8 @@ public:
 
 private:
   DispatchList mConnections;
+  // Keeps the event's atom alive while the list is mapped on it.
+  String mEventId;
 };
 
 // Hash Policy
@@ -228,7 +244,7 @@ public:
 
 private:
   friend class EventConnection;
-  typedef HashMap<String, EventDispatchList*> EventMapType;
+  typedef FlatHashMap<EventAtom, EventDispatchList*> EventMapType;
   EventMapType mEvents;
 
 public:
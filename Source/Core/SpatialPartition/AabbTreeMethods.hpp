@@ -4,7 +4,14 @@
 namespace Plasma
 {
 
-DeclareEnum3(PartitionMethods, MinimizeVolumeSum, MinimuzeSurfaceAreaSum, MidPoint);
+DeclareEnum4(PartitionMethods, MinimizeVolumeSum, MinimuzeSurfaceAreaSum, MidPoint, BinnedSurfaceAreaHeuristic);
+
+/// How many candidate split planes per axis the binned surface area heuristic tests.
+const uint cSahBinCount = 16;
+/// Trees with fewer leaves than this are always built on one thread.
+const uint cMinParallelTreeBuildLeaves = 4096;
+/// How many subtrees the top of a tree is split into for a parallel build.
+const uint cParallelTreeBuildSubtrees = 64;
 
 template <typename NodeType>
 class PartitionNodeMethod
@@ -19,6 +26,15 @@ template <typename NodeType>
 NodeType* BuildTreeTopDownNodes(Array<NodeType*>& leafNodes,
                                 typename PartitionNodeMethod<NodeType>::PartitionNodeAxisMethod partitionMethod);
 
+/// Builds the same tree as BuildTreeTopDownNodes, but once the top of the tree
+/// has been split into about cParallelTreeBuildSubtrees subtrees they are built
+/// with parallelFor(begin, end, functor), which must call functor(chunkBegin,
+/// chunkEnd) over the range (e.g. a wrapper of JobSystem::ParallelFor).
+template <typename NodeType, typename ParallelForType>
+NodeType* BuildTreeTopDownNodesParallel(Array<NodeType*>& leafNodes,
+                                        typename PartitionNodeMethod<NodeType>::PartitionNodeAxisMethod partitionMethod,
+                                        ParallelForType& parallelFor);
+
 /// Calculates an Aabb encompassing all objects passed in.
 template <typename NodeType>
 Aabb CalculateAabbNodes(Array<NodeType*>& leafNodes);
@@ -35,6 +51,12 @@ uint MinimizeSurfaceAreaSumNodes(Array<NodeType*>& leafNodes);
 template <typename NodeType>
 uint MidPointNodes(Array<NodeType*>& leafNodes);
 
+/// Partition axis method that optimizes ray casts and queries like
+/// MinimizeSurfaceAreaSum, but only tests cSahBinCount split planes per axis
+/// so it's linear in the object count instead of sorting on every axis.
+template <typename NodeType>
+uint BinnedSurfaceAreaHeuristicNodes(Array<NodeType*>& leafNodes);
+
 //-------------------------------------Old functions (still used, can't remove)
 template <typename ObjectType>
 class PartitionMethod
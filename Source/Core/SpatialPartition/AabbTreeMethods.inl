@@ -55,6 +55,99 @@ NodeType* BuildTreeTopDownNodes(Array<NodeType*>& leafNodes,
   return parentNode;
 }
 
+/// Marks where a subtree starts in the splits of a ParallelTreeBuilder.
+const uint cParallelTreeBuildSubtree = uint(-1);
+
+/// Builds the subtrees of a parallel tree build. The top of the tree is split
+/// serially into contiguous ranges of the leaf array (recording each split in
+/// order), the ranges are built independently and then the recorded splits are
+/// replayed to join the subtrees under the top nodes.
+template <typename NodeType>
+struct ParallelTreeBuilder
+{
+  typedef typename PartitionNodeMethod<NodeType>::PartitionNodeAxisMethod PartitionMethodType;
+
+  // Builds the subtrees in [begin, end)
+  void operator()(uint begin, uint end)
+  {
+    for (uint i = begin; i < end; ++i)
+    {
+      Array<NodeType*> leaves;
+      leaves.Assign(mLeafNodes->Begin() + mRanges[i].first, mLeafNodes->Begin() + mRanges[i].second);
+      mRoots[i] = BuildTreeTopDownNodes<NodeType>(leaves, mPartitionMethod);
+    }
+  }
+
+  void Split(uint begin, uint end)
+  {
+    uint size = end - begin;
+    if (size <= mMaxSubtreeSize)
+    {
+      mSplits.PushBack(cParallelTreeBuildSubtree);
+      mRanges.PushBack(Pair<uint, uint>(begin, end));
+      return;
+    }
+
+    // Partition a copy of the range the same way BuildTreeTopDownNodes
+    // would and write the new order back
+    Array<NodeType*> leaves;
+    leaves.Assign(mLeafNodes->Begin() + begin, mLeafNodes->Begin() + end);
+    uint separationIndex = mPartitionMethod(leaves);
+    for (uint i = 0; i < size; ++i)
+      (*mLeafNodes)[begin + i] = leaves[i];
+
+    uint middle = begin + separationIndex;
+    mSplits.PushBack(middle);
+    Split(begin, middle);
+    Split(middle, end);
+  }
+
+  NodeType* Join(uint& splitIndex, uint& subtreeIndex)
+  {
+    if (mSplits[splitIndex++] == cParallelTreeBuildSubtree)
+      return mRoots[subtreeIndex++];
+
+    NodeType* leftNode = Join(splitIndex, subtreeIndex);
+    NodeType* rightNode = Join(splitIndex, subtreeIndex);
+
+    NodeType* parentNode = new NodeType();
+    parentNode->SetChildren(leftNode, rightNode);
+    return parentNode;
+  }
+
+  Array<NodeType*>* mLeafNodes;
+  PartitionMethodType mPartitionMethod;
+  uint mMaxSubtreeSize;
+  /// The split point of every top node in depth first order
+  /// (cParallelTreeBuildSubtree where a subtree starts instead).
+  Array<uint> mSplits;
+  /// The leaf range and the built root of every subtree.
+  Array<Pair<uint, uint>> mRanges;
+  Array<NodeType*> mRoots;
+};
+
+template <typename NodeType, typename ParallelForType>
+NodeType* BuildTreeTopDownNodesParallel(Array<NodeType*>& leafNodes,
+                                        typename PartitionNodeMethod<NodeType>::PartitionNodeAxisMethod partitionMethod,
+                                        ParallelForType& parallelFor)
+{
+  if (leafNodes.Size() < cMinParallelTreeBuildLeaves)
+    return BuildTreeTopDownNodes<NodeType>(leafNodes, partitionMethod);
+
+  ParallelTreeBuilder<NodeType> builder;
+  builder.mLeafNodes = &leafNodes;
+  builder.mPartitionMethod = partitionMethod;
+  builder.mMaxSubtreeSize = leafNodes.Size() / cParallelTreeBuildSubtrees;
+  builder.Split(0, leafNodes.Size());
+
+  builder.mRoots.Resize(builder.mRanges.Size());
+  parallelFor(0, builder.mRanges.Size(), builder);
+
+  uint splitIndex = 0;
+  uint subtreeIndex = 0;
+  return builder.Join(splitIndex, subtreeIndex);
+}
+
 template <typename NodeType>
 Aabb CalculateAabbNodes(Array<NodeType*>& leafNodes)
 {
@@ -258,6 +351,107 @@ uint MidPointNodes(Array<NodeType*>& leafNodes)
   return leafNodes.Size() >> 1;
 }
 
+template <typename NodeType>
+uint GetSahBin(NodeType* node, uint axis, real axisMin, real binScale)
+{
+  uint bin = uint((node->mAabb.GetCenter()[axis] - axisMin) * binScale);
+  return Math::Min(bin, cSahBinCount - 1);
+}
+
+template <typename NodeType>
+uint BinnedSurfaceAreaHeuristicNodes(Array<NodeType*>& leafNodes)
+{
+  uint size = leafNodes.Size();
+
+  // The leaves are binned by their centers
+  Aabb centerAabb;
+  centerAabb.Compute(leafNodes[0]->mAabb.GetCenter());
+  for (uint i = 1; i < size; ++i)
+    centerAabb.Expand(leafNodes[i]->mAabb.GetCenter());
+
+  uint axis = 0;
+  // The first bin on the right side of the split.
+  uint splitBin = 0;
+  real cost = Math::PositiveMax();
+
+  for (uint currAxis = 0; currAxis < 3; ++currAxis)
+  {
+    real axisMin = centerAabb.mMin[currAxis];
+    real axisLength = centerAabb.mMax[currAxis] - axisMin;
+    if (axisLength <= real(0.0))
+      continue;
+
+    Aabb binAabbs[cSahBinCount];
+    uint binCounts[cSahBinCount] = {};
+    for (uint bin = 0; bin < cSahBinCount; ++bin)
+      binAabbs[bin].SetInvalid();
+
+    real binScale = real(cSahBinCount) / axisLength;
+    for (uint i = 0; i < size; ++i)
+    {
+      uint bin = GetSahBin(leafNodes[i], currAxis, axisMin, binScale);
+      binAabbs[bin].Combine(leafNodes[i]->mAabb);
+      ++binCounts[bin];
+    }
+
+    // Sweep from the right to get the area and count
+    // of everything right of each split plane
+    real rightArea[cSahBinCount];
+    uint rightCount[cSahBinCount];
+    Aabb rightAabb;
+    rightAabb.SetInvalid();
+    uint count = 0;
+    for (uint bin = cSahBinCount - 1; bin > 0; --bin)
+    {
+      rightAabb.Combine(binAabbs[bin]);
+      count += binCounts[bin];
+      rightArea[bin] = count != 0 ? rightAabb.GetSurfaceArea() : real(0.0);
+      rightCount[bin] = count;
+    }
+
+    // Sweep from the left and compute the cost of
+    // splitting in front of each bin
+    Aabb leftAabb;
+    leftAabb.SetInvalid();
+    count = 0;
+    for (uint bin = 1; bin < cSahBinCount; ++bin)
+    {
+      leftAabb.Combine(binAabbs[bin - 1]);
+      count += binCounts[bin - 1];
+      if (count == 0 || rightCount[bin] == 0)
+        continue;
+
+      real currentCost = leftAabb.GetSurfaceArea() * count + rightArea[bin] * rightCount[bin];
+      if (currentCost < cost)
+      {
+        cost = currentCost;
+        axis = currAxis;
+        splitBin = bin;
+      }
+    }
+  }
+
+  // All of the centers are at the same point so
+  // any split is as good as any other
+  if (splitBin == 0)
+    return size >> 1;
+
+  // Move the leaves left of the split to the front
+  real axisMin = centerAabb.mMin[axis];
+  real binScale = real(cSahBinCount) / (centerAabb.mMax[axis] - axisMin);
+  uint index = 0;
+  for (uint i = 0; i < size; ++i)
+  {
+    if (GetSahBin(leafNodes[i], axis, axisMin, binScale) < splitBin)
+    {
+      Math::Swap(leafNodes[i], leafNodes[index]);
+      ++index;
+    }
+  }
+
+  return index;
+}
+
 //------------------------------------- Old functions (still used, can't remove)
 
 template <typename NodeType, typename ObjectType>
@@ -4,45 +4,37 @@
 namespace Plasma
 {
 
-namespace Memory
-{
-class Pool;
-}
-
 /// Node used for the Avl balanced dynamic aabb tree. Different from the static
-/// tree node because we need a parent pointer. Different from the normal
-/// DynamicAabbTree because we need a height.
+/// tree node because we need a parent index. Different from the normal
+/// DynamicAabbTree because we need a height. Nodes live in the tree's node
+/// storage and refer to each other by index. The client data is stored
+/// separately by the tree so that traversals only touch what they need.
 template <typename ClientDataType>
 struct AvlDynamicTreeNode
 {
   AvlDynamicTreeNode();
-  ~AvlDynamicTreeNode();
 
-  static Memory::Pool* sDynamicNodePool;
-  static void* operator new(size_t size);
-  static void operator delete(void* pMem, size_t size);
-
-  bool IsLeaf();
-  // Assumes that a parent exists
-  AvlDynamicTreeNode* GetSibling();
+  bool IsLeaf() const;
 
   Aabb mAabb;
-  ClientDataType mClientData;
 
-  AvlDynamicTreeNode* mParent;
+  uint mParent;
 
   union {
     struct
     {
-      AvlDynamicTreeNode* mChild1;
-      AvlDynamicTreeNode* mChild2;
+      uint mChild1;
+      uint mChild2;
     };
-    AvlDynamicTreeNode* mChildren[2];
+    uint mChildren[2];
   };
 
   /// The height of this current node. Height of 0 means a leaf node.
   /// Height increases as you go up the tree.
   uint mHeight;
+
+  /// Which of the tree's leaves this is (only valid for leaves).
+  uint mLeaf;
 };
 
 /// Policy for the AvlDynamicAabbTree that determines
@@ -53,19 +45,20 @@ struct AvlDynamicTreePolicy : public BaseDynamicTreePolicy<AvlDynamicTreeNode<Cl
   typedef AvlDynamicTreeNode<ClientDataType> NodeType;
   typedef ClientDataType ClientDataTypeDef;
   typedef BaseDynamicTreePolicy<AvlDynamicTreeNode<ClientDataType>> BaseType;
+  typedef typename BaseType::NodeStorage NodeStorage;
 
   /// Inserts the given leaf node at the starting node. Generally, start is
   /// the root, but when updating a node it may be somewhere in the middle
   // of the tree.
-  static void InsertNode(NodeType*& root, NodeType* leafNode, NodeType* start);
+  static void InsertNode(NodeStorage& nodes, uint leafNode, uint start);
   /// Removes the given node. Returns the last node that did not have to be
   /// resized from removal.
-  static NodeType* RemoveNode(NodeType*& root, NodeType* leafNode);
+  static uint RemoveNode(NodeStorage& nodes, uint leafNode);
 
   // Takes the given node and performs an AVL rotation to balance it's children.
-  static NodeType* Balance(NodeType*& root, NodeType* node);
-  static NodeType* RotateUp(NodeType*& root, NodeType* oldParent, uint childIndex);
-  static void FixAabbAndHeight(NodeType* node);
+  static uint Balance(NodeStorage& nodes, uint node);
+  static uint RotateUp(NodeStorage& nodes, uint oldParent, uint childIndex);
+  static void FixAabbAndHeight(NodeStorage& nodes, uint node);
 };
 
 /// A Hierarchical AabbTree that is meant for dynamic objects. Used to have a
@@ -6,204 +6,161 @@ namespace Plasma
 template <typename ClientDataType>
 AvlDynamicTreeNode<ClientDataType>::AvlDynamicTreeNode()
 {
-  mChild1 = nullptr;
-  mChild2 = nullptr;
-  mParent = nullptr;
+  mParent = cInvalidDynamicTreeIndex;
+  mChild1 = cInvalidDynamicTreeIndex;
+  mChild2 = cInvalidDynamicTreeIndex;
   mHeight = 0;
-  GetDefaultClientDataValue(mClientData);
+  mLeaf = cInvalidDynamicTreeIndex;
 }
 
 template <typename ClientDataType>
-AvlDynamicTreeNode<ClientDataType>::~AvlDynamicTreeNode()
+bool AvlDynamicTreeNode<ClientDataType>::IsLeaf() const
 {
-  delete mChild1;
-  delete mChild2;
+  return mChild1 == cInvalidDynamicTreeIndex;
 }
 
 template <typename ClientDataType>
-Memory::Pool* AvlDynamicTreeNode<ClientDataType>::sDynamicNodePool = new Memory::Pool(
-    "DynamicNodes", Memory::GetNamedHeap("BroadPhase"), sizeof(AvlDynamicTreeNode<ClientDataType>), 200);
-
-template <typename ClientDataType>
-void* AvlDynamicTreeNode<ClientDataType>::operator new(size_t size)
-{
-  return sDynamicNodePool->Allocate(size);
-}
-
-template <typename ClientDataType>
-void AvlDynamicTreeNode<ClientDataType>::operator delete(void* pMem, size_t size)
-{
-  return sDynamicNodePool->Deallocate(pMem, size);
-}
-
-template <typename ClientDataType>
-bool AvlDynamicTreeNode<ClientDataType>::IsLeaf()
-{
-  return mChild1 == nullptr;
-}
-
-template <typename ClientDataType>
-AvlDynamicTreeNode<ClientDataType>* AvlDynamicTreeNode<ClientDataType>::GetSibling()
-{
-  if (mParent->mChild1 == this)
-    return mParent->mChild2;
-  return mParent->mChild1;
-}
-
-template <typename ClientDataType>
-void AvlDynamicTreePolicy<ClientDataType>::InsertNode(NodeType*& root, NodeType* leafNode, NodeType* start)
+void AvlDynamicTreePolicy<ClientDataType>::InsertNode(NodeStorage& nodes, uint leafNode, uint start)
 {
   // if we have no root, then this node is the root
-  if (root == nullptr)
+  if (nodes.mRoot == cInvalidDynamicTreeIndex)
   {
-    root = leafNode;
-    root->mParent = nullptr;
+    nodes.mRoot = leafNode;
+    nodes[leafNode].mParent = cInvalidDynamicTreeIndex;
     return;
   }
 
   // traverse until we find the correct leaf node to add at
-  NodeType* node = start;
-  while (!node->IsLeaf())
+  uint node = start;
+  while (!nodes.IsLeaf(node))
   {
     // expand the aabb's of our parent as we go down
-    node->mAabb = node->mAabb.Combined(leafNode->mAabb);
+    nodes[node].mAabb = nodes[node].mAabb.Combined(nodes[leafNode].mAabb);
     // choose the correct node between the left and right node
-    node = BaseType::SelectNode(node, leafNode);
+    node = BaseType::SelectNode(nodes, node, leafNode);
   }
 
   // all our objects must be on leaf nodes, so we have
   // to make a new internal node to put the old leaf and the new leaf
-  NodeType* oldParent = node->mParent;
-  NodeType* newParent = BaseType::CreateInternalNode(oldParent, node, leafNode);
-  newParent->mHeight = 1;
+  uint oldParent = nodes[node].mParent;
+  uint newParent = BaseType::CreateInternalNode(nodes, oldParent, node, leafNode);
+  nodes[newParent].mHeight = 1;
 
-  // deal with fixing the root pointer if the tree contained only 1 node
-  if (nullptr == oldParent)
-    root = newParent;
+  // deal with fixing the root index if the tree contained only 1 node
+  if (oldParent == cInvalidDynamicTreeIndex)
+    nodes.mRoot = newParent;
 
-  NodeType* nodeToBalance = newParent;
-  while (nodeToBalance != nullptr)
+  uint nodeToBalance = newParent;
+  while (nodeToBalance != cInvalidDynamicTreeIndex)
   {
-    nodeToBalance = Balance(root, nodeToBalance);
+    nodeToBalance = Balance(nodes, nodeToBalance);
 
-    FixAabbAndHeight(nodeToBalance);
-    nodeToBalance = nodeToBalance->mParent;
+    FixAabbAndHeight(nodes, nodeToBalance);
+    nodeToBalance = nodes[nodeToBalance].mParent;
   }
 }
 
 template <typename ClientDataType>
-typename AvlDynamicTreePolicy<ClientDataType>::NodeType*
-AvlDynamicTreePolicy<ClientDataType>::RemoveNode(NodeType*& root, NodeType* leafNode)
+uint AvlDynamicTreePolicy<ClientDataType>::RemoveNode(NodeStorage& nodes, uint leafNode)
 {
-  ErrorIf(leafNode->mChild1 != nullptr, "Can only remove leaf nodes.");
-  ErrorIf(leafNode->mChild2 != nullptr, "Can only remove leaf nodes.");
+  ErrorIf(!nodes.IsLeaf(leafNode), "Can only remove leaf nodes.");
 
   // deal with removing the root
-  if (leafNode == root)
+  if (leafNode == nodes.mRoot)
   {
-    root = nullptr;
-    return root;
+    nodes.mRoot = cInvalidDynamicTreeIndex;
+    return nodes.mRoot;
   }
 
-  NodeType* parent = leafNode->mParent;
-  NodeType* grandParent = parent->mParent;
-  NodeType* sibling = leafNode->GetSibling();
+  uint parent = nodes[leafNode].mParent;
+  uint grandParent = nodes[parent].mParent;
+  uint sibling = nodes.GetSibling(leafNode);
   // if our parent is the root, then our sibling will have to
   // become the new root
-  if (grandParent == nullptr)
+  if (grandParent == cInvalidDynamicTreeIndex)
   {
-    BaseType::DeleteNode(root);
-    sibling->mParent = nullptr;
-    root = sibling;
-    return root;
+    BaseType::DeleteNode(nodes, nodes.mRoot);
+    nodes[sibling].mParent = cInvalidDynamicTreeIndex;
+    nodes.mRoot = sibling;
+    return nodes.mRoot;
   }
 
   // set our sibling to be where our old parent was,
   // then delete our parent
-  if (grandParent->mChild1 == parent)
-    grandParent->mChild1 = sibling;
-  else
-    grandParent->mChild2 = sibling;
-  sibling->mParent = grandParent;
-  BaseType::DeleteNode(parent);
+  nodes.ReplaceChild(grandParent, parent, sibling);
+  nodes[sibling].mParent = grandParent;
+  BaseType::DeleteNode(nodes, parent);
 
   // work up the tree shrinking the Aabb's to account for us being removed
-  while (grandParent)
+  while (grandParent != cInvalidDynamicTreeIndex)
   {
-    grandParent = Balance(root, grandParent);
+    grandParent = Balance(nodes, grandParent);
 
-    FixAabbAndHeight(grandParent);
-    grandParent = grandParent->mParent;
+    FixAabbAndHeight(nodes, grandParent);
+    grandParent = nodes[grandParent].mParent;
   }
 
   return grandParent;
 }
 
 template <typename ClientDataType>
-typename AvlDynamicTreePolicy<ClientDataType>::NodeType* AvlDynamicTreePolicy<ClientDataType>::Balance(NodeType*& root,
-                                                                                                       NodeType* node)
+uint AvlDynamicTreePolicy<ClientDataType>::Balance(NodeStorage& nodes, uint node)
 {
-  if (node->mHeight < 2)
+  if (nodes[node].mHeight < 2)
     return node;
 
-  NodeType* B = node->mChild1;
-  NodeType* C = node->mChild2;
-  int balance = C->mHeight - B->mHeight;
+  uint B = nodes[node].mChild1;
+  uint C = nodes[node].mChild2;
+  int balance = nodes[C].mHeight - nodes[B].mHeight;
 
   if (balance > 1)
-    return RotateUp(root, node, 1);
+    return RotateUp(nodes, node, 1);
   else if (balance < -1)
-    return RotateUp(root, node, 0);
+    return RotateUp(nodes, node, 0);
   return node;
 }
 
 template <typename ClientDataType>
-typename AvlDynamicTreePolicy<ClientDataType>::NodeType*
-AvlDynamicTreePolicy<ClientDataType>::RotateUp(NodeType*& root, NodeType* oldParent, uint childIndex)
+uint AvlDynamicTreePolicy<ClientDataType>::RotateUp(NodeStorage& nodes, uint oldParent, uint childIndex)
 {
-  NodeType* newParent = oldParent->mChildren[childIndex];
+  NodeType& oldParentNode = nodes[oldParent];
+  uint newParent = oldParentNode.mChildren[childIndex];
+  NodeType& newParentNode = nodes[newParent];
   uint largeIndex, smallIndex;
-  NodeType* smallChild;
+  uint smallChild;
 
-  if (newParent->mChild1->mHeight > newParent->mChild2->mHeight)
+  if (nodes[newParentNode.mChild1].mHeight > nodes[newParentNode.mChild2].mHeight)
     largeIndex = 0;
   else
     largeIndex = 1;
   smallIndex = (largeIndex + 1) % 2;
-  smallChild = newParent->mChildren[smallIndex];
+  smallChild = newParentNode.mChildren[smallIndex];
 
   // swap new and old parent
-  newParent->mChildren[smallIndex] = oldParent;
-  newParent->mParent = oldParent->mParent;
-  oldParent->mParent = newParent;
-  // fix the new parent's parent if it exists to point back down correctly
-  if (newParent->mParent != nullptr)
-  {
-    if (newParent->mParent->mChild1 == oldParent)
-      newParent->mParent->mChild1 = newParent;
-    else
-      newParent->mParent->mChild2 = newParent;
-  }
-  else
-    root = newParent;
+  newParentNode.mChildren[smallIndex] = oldParent;
+  newParentNode.mParent = oldParentNode.mParent;
+  oldParentNode.mParent = newParent;
+  // fix the new parent's parent (or the root) to point back down correctly
+  nodes.ReplaceChild(newParentNode.mParent, oldParent, newParent);
   // put the small child under c
-  oldParent->mChildren[childIndex] = smallChild;
-  smallChild->mParent = oldParent;
+  oldParentNode.mChildren[childIndex] = smallChild;
+  nodes[smallChild].mParent = oldParent;
   // fix the aabbs and heights of the old and new parent
-  FixAabbAndHeight(oldParent);
-  FixAabbAndHeight(newParent);
+  FixAabbAndHeight(nodes, oldParent);
+  FixAabbAndHeight(nodes, newParent);
 
   return newParent;
 }
 
 template <typename ClientDataType>
-void AvlDynamicTreePolicy<ClientDataType>::FixAabbAndHeight(NodeType* node)
+void AvlDynamicTreePolicy<ClientDataType>::FixAabbAndHeight(NodeStorage& nodes, uint node)
 {
-  NodeType* child1 = node->mChild1;
-  NodeType* child2 = node->mChild2;
-  node->mHeight = 1 + Math::Max(child1->mHeight, child2->mHeight);
-  node->mAabb = child1->mAabb;
-  node->mAabb.Combine(child2->mAabb);
+  NodeType& parent = nodes[node];
+  NodeType& child1 = nodes[parent.mChild1];
+  NodeType& child2 = nodes[parent.mChild2];
+  parent.mHeight = 1 + Math::Max(child1.mHeight, child2.mHeight);
+  parent.mAabb = child1.mAabb;
+  parent.mAabb.Combine(child2.mAabb);
 }
 
 template <typename ClientDataType>
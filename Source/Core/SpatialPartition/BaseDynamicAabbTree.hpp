@@ -6,20 +6,22 @@ namespace Plasma
 
 /// Base policy for DynamicAabbTrees.
 /// Contains core functionality that all other AabbTreePolicies need to have.
+/// Nodes are referred to by their index in the tree's node storage.
 template <typename NodeType>
 struct BaseDynamicTreePolicy
 {
   typedef NodeType NodeTypeDef;
+  typedef DynamicTreeNodes<NodeType> NodeStorage;
 
   /// Given a parent node and a leaf node, determines which
   /// child the new leaf should be placed with.
-  static NodeType* SelectNode(NodeType* parent, NodeType* newLeaf);
+  static uint SelectNode(NodeStorage& nodes, uint parent, uint newLeaf);
   /// Creates a new internal node from the old parent and two new children.
-  /// links all pointers and expands the aabb to deal with the children
-  static NodeType* CreateInternalNode(NodeType* oldParent, NodeType* oldChild, NodeType* newChild);
+  /// links all indices and expands the aabb to deal with the children
+  static uint CreateInternalNode(NodeStorage& nodes, uint oldParent, uint oldChild, uint newChild);
   /// Deletes just one node in the tree. Does nothing but unlinks the children
-  /// from the node. The children must still have their parent pointers fixed.
-  static void DeleteNode(NodeType* node);
+  /// from the node. The children must still have their parent indices fixed.
+  static void DeleteNode(NodeStorage& nodes, uint node);
 };
 
 /// A Hierarchical AabbTree that is meant for dynamic objects. Used to have a
@@ -30,6 +32,10 @@ struct BaseDynamicTreePolicy
 /// of shared functionality. The policy is used to determine how to Insert
 /// and remove nodes since different types might deal with these differently.
 ///(ie. Avl balancing)
+/// Nodes are stored contiguously and only hold what traversal needs (the aabb
+/// and the indices of their parent, children and leaf). The client data of the
+/// leaves is kept in a separate array indexed by proxy. Every so often the nodes
+/// are re-laid out in depth first order so traversals walk forward in memory.
 template <typename PolicyType>
 class BaseDynamicAabbTree
 {
@@ -40,10 +46,19 @@ public:
   typedef BaseBroadPhaseData<ClientDataType> DataType;
 
   typedef typename PolicyType::NodeType NodeType;
+  typedef DynamicTreeNodes<NodeType> NodeStorage;
   typedef Pair<NodeType*, NodeType*> NodePair;
   typedef Array<NodeType*> NodeArray;
   typedef Array<NodePair> NodePairArray;
 
+  /// The data of each leaf that queries don't need until they hit the leaf.
+  struct LeafData
+  {
+    ClientDataType mClientData;
+    /// The index of the leaf's node (or the next free leaf when unused).
+    uint mNode;
+  };
+
   /// A range for iterating through the leaf nodes of the tree. Used to
   /// perform queries without having to provide a callback function.
   /// Note: this range will become completely invalidated if any operations are
@@ -51,34 +66,207 @@ public:
   template <typename QueryType,
             typename ArrayType = Array<NodeType*>,
             typename QueryPolicyType = BroadPhasePolicy<QueryType, Aabb>>
-  struct BaseTreeRange : public BroadPhaseTreeRange<ClientDataType, NodeType, QueryType, QueryPolicyType, ArrayType>
+  struct BaseTreeRange
   {
-    typedef BroadPhaseTreeRange<ClientDataType, NodeType, QueryType, QueryPolicyType, ArrayType> BaseType;
+    typedef ClientDataType ClientDataTypeDef;
+    typedef NodeType NodeTypeDef;
+    typedef ArrayType NodeTypePointerArray;
 
     /// Constructs a range using the default Policy.
-    BaseTreeRange(ArrayType* scratchBuffer, NodeType* root, const QueryType& queryObj) :
-        BaseType(scratchBuffer, root, queryObj, QueryPolicyType())
+    BaseTreeRange(ArrayType* scratchBuffer, BaseTreeType* tree, const QueryType& queryObj) :
+        mQueryObj(queryObj),
+        mPolicy(QueryPolicyType())
     {
+      Initialize(scratchBuffer, tree);
     }
 
     /// Constructs a range using the policy type passed in.
-    BaseTreeRange(ArrayType* scratchBuffer, NodeType* root, const QueryType& queryObj, QueryPolicyType policy) :
-        BaseType(scratchBuffer, root, queryObj, policy)
+    BaseTreeRange(ArrayType* scratchBuffer, BaseTreeType* tree, const QueryType& queryObj, QueryPolicyType policy) :
+        mQueryObj(queryObj),
+        mPolicy(policy)
+    {
+      Initialize(scratchBuffer, tree);
+    }
+
+    void Initialize(ArrayType* scratchBuffer, BaseTreeType* tree)
+    {
+      mNodes = tree->mNodes.mNodes.Data();
+      mLeaves = tree->mLeaves.Data();
+      mScratchSpace = scratchBuffer;
+      mScratchSpace->Clear();
+      if (tree->mNodes.mRoot != cInvalidDynamicTreeIndex)
+        mScratchSpace->PushBack(mNodes + tree->mNodes.mRoot);
+      SkipDead();
+    }
+
+    void PopFront()
     {
+      mScratchSpace->PopBack();
+      SkipDead();
     }
+
+    ClientDataType& Front()
+    {
+      return mLeaves[proxyFront().mLeaf].mClientData;
+    }
+
+    bool Empty() const
+    {
+      return mScratchSpace->Size() == 0;
+    }
+
+    // temporary now so that the proxy can be retrieved
+    NodeType& proxyFront()
+    {
+      uint size = mScratchSpace->Size();
+      ErrorIf(size == 0, "Cannot pop an empty range.");
+      return *(*mScratchSpace)[size - 1];
+    }
+
+    void SkipDead()
+    {
+      ArrayType& nodes = *mScratchSpace;
+      while (!nodes.Empty())
+      {
+        NodeType* node = nodes.Back();
+
+        // if this node doesn't overlap the aabb, we don't care
+        if (!mPolicy.Overlap(mQueryObj, node->mAabb))
+        {
+          nodes.PopBack();
+          continue;
+        }
+
+        // if it is a leaf then return it
+        if (node->IsLeaf())
+          return;
+
+        // otherwise push both children onto the stack
+        nodes.PopBack();
+        nodes.PushBack(mNodes + node->mChild1);
+        nodes.PushBack(mNodes + node->mChild2);
+      }
+    }
+
+    QueryType mQueryObj;
+    QueryPolicyType mPolicy;
+    NodeTypePointerArray* mScratchSpace;
+    NodeType* mNodes;
+    LeafData* mLeaves;
   };
 
   /// A range for iterating through the self pairs of this tree.
   /// Used to determine all potential overlaps within the tree itself.
   /// Note: this range will become completely invalidated if any operations are
   /// performed on the tree.
-  struct SelfQueryRange : public BroadPhaseTreeSelfRange<BaseTreeType, BoxQueryPairCheck<ClientDataType>>
+  struct SelfQueryRange
   {
-    typedef BroadPhaseTreeSelfRange<BaseTreeType, BoxQueryPairCheck<ClientDataType>> BaseType;
+    typedef Pair<ClientDataType, ClientDataType> PairType;
+
+    SelfQueryRange(NodePairArray* scratchBuffer, BaseTreeType* tree)
+    {
+      mNodes = tree->mNodes.mNodes.Data();
+      mLeaves = tree->mLeaves.Data();
+      mScratchSpace = scratchBuffer;
+      mScratchSpace->Clear();
 
-    SelfQueryRange(NodePairArray* scratchBuffer, NodeType* root) : BaseType(scratchBuffer, root)
+      if (tree->mNodes.mRoot != cInvalidDynamicTreeIndex)
+        InitialSetup(mNodes + tree->mNodes.mRoot);
+      SkipDead();
+    }
+
+    void PopFront()
+    {
+      mScratchSpace->PopBack();
+      SkipDead();
+    }
+
+    PairType& Front()
+    {
+      return mPair;
+    }
+
+    NodePair& proxyFront()
+    {
+      return mNodePair;
+    }
+
+    bool Empty() const
     {
+      return mScratchSpace->Size() == 0;
     }
+
+    void InitialSetup(NodeType* root)
+    {
+      if (root->IsLeaf())
+        return;
+
+      NodePairArray& nodePairs = *mScratchSpace;
+      nodePairs.PushBack(MakePair(mNodes + root->mChild1, mNodes + root->mChild2));
+
+      for (uint i = 0; i < nodePairs.Size(); ++i)
+      {
+        NodeType* nodeA = nodePairs[i].first;
+        NodeType* nodeB = nodePairs[i].second;
+
+        if (!nodeA->IsLeaf())
+          nodePairs.PushBack(MakePair(mNodes + nodeA->mChild1, mNodes + nodeA->mChild2));
+        if (!nodeB->IsLeaf())
+          nodePairs.PushBack(MakePair(mNodes + nodeB->mChild1, mNodes + nodeB->mChild2));
+      }
+    }
+
+    void SkipDead()
+    {
+      NodePairArray& nodePairs = *mScratchSpace;
+      while (!nodePairs.Empty())
+      {
+        mNodePair = nodePairs.Back();
+
+        NodeType* nodeA = mNodePair.first;
+        NodeType* nodeB = mNodePair.second;
+
+        // if the nodes don't overlap, we don't care
+        if (!nodeA->mAabb.Overlap(nodeB->mAabb))
+        {
+          nodePairs.PopBack();
+          continue;
+        }
+
+        if (nodeA->IsLeaf())
+        {
+          if (nodeB->IsLeaf())
+          {
+            mPair = MakePair(mLeaves[nodeA->mLeaf].mClientData, mLeaves[nodeB->mLeaf].mClientData);
+            return;
+          }
+
+          nodePairs.PopBack();
+          nodePairs.PushBack(MakePair(nodeA, mNodes + nodeB->mChild1));
+          nodePairs.PushBack(MakePair(nodeA, mNodes + nodeB->mChild2));
+        }
+        else if (nodeB->IsLeaf())
+        {
+          nodePairs.PopBack();
+          nodePairs.PushBack(MakePair(mNodes + nodeA->mChild1, nodeB));
+          nodePairs.PushBack(MakePair(mNodes + nodeA->mChild2, nodeB));
+        }
+        else
+        {
+          nodePairs.PopBack();
+          nodePairs.PushBack(MakePair(mNodes + nodeA->mChild1, mNodes + nodeB->mChild1));
+          nodePairs.PushBack(MakePair(mNodes + nodeA->mChild1, mNodes + nodeB->mChild2));
+          nodePairs.PushBack(MakePair(mNodes + nodeA->mChild2, mNodes + nodeB->mChild1));
+          nodePairs.PushBack(MakePair(mNodes + nodeA->mChild2, mNodes + nodeB->mChild2));
+        }
+      }
+    }
+
+    NodePair mNodePair;
+    PairType mPair;
+    NodePairArray* mScratchSpace;
+    NodeType* mNodes;
+    LeafData* mLeaves;
   };
 
   BaseDynamicAabbTree();
@@ -96,13 +284,18 @@ public:
 
   void DrawEntireTree();
   void Draw(int level);
-  void DrawTree(NodeType* node);
-  void DrawLevel(NodeType* node, uint currLevel, uint level);
+  void DrawTree(uint node);
+  void DrawLevel(uint node, uint currLevel, uint level);
   /// Deletes the entire tree in one shot.
   void Clear();
 
   void Validate();
 
+  /// Re-lays out the nodes in depth first order (a node's first child directly
+  /// follows it) and drops any free nodes. Proxies are unaffected. Called
+  /// automatically once enough nodes have been moved around.
+  void Compact();
+
   /// Returns false if tree is empty and does not modify passed in aabb
   bool GetRootAabb(Aabb* aabb);
 
@@ -119,9 +312,9 @@ public:
                                                               ArrayType& scratchBuffer,
                                                               Policy policy)
   {
-    typedef BaseTreeRange<QueryType, ArrayType> RangeType;
+    typedef BaseTreeRange<QueryType, ArrayType, Policy> RangeType;
 
-    return RangeType(&scratchBuffer, mRoot, queryObj, policy);
+    return RangeType(&scratchBuffer, this, queryObj, policy);
   }
 
   /// The same functionality as the QueryWithPolicy function except
@@ -133,16 +326,16 @@ public:
   {
     typedef BaseTreeRange<QueryType, ArrayType> RangeType;
 
-    return RangeType(&scratchBuffer, mRoot, queryObj);
+    return RangeType(&scratchBuffer, this, queryObj);
   }
 
   /// Callback is expected to have a method called
-  /// QueryCallback(NodeType* node1, NodeType* node2) (world space trees)
+  /// QueryCallback(void* proxy1, void* proxy2) (world space trees)
   template <typename CallbackType>
   void QuerySelfTree(CallbackType* callback);
 
   /// Callback is expected to have a method called
-  /// QueryCallback(NodeType* thisNode, NodeType* otherNode) (world space trees)
+  /// QueryCallback(void* thisProxy, void* otherProxy) (world space trees)
   template <typename CallbackType>
   void QueryTree(CallbackType* callback, const BaseTreeType* tree);
 
@@ -152,10 +345,22 @@ public:
 
 protected:
   /// Updates the given leaf with the passed in aabb.
-  void Update(NodeType* leafNode, Aabb& aabb);
+  void Update(uint leaf, Aabb& aabb);
+  /// Counts nodes moved by inserts and removals and compacts the
+  /// nodes once the count passes the size of the tree.
+  void NodesChanged(uint count);
+  /// Copies the subtree into the new nodes in depth first order. Returns the node's new index.
+  uint CompactSubtree(uint node, uint newParent, Array<NodeType>& newNodes);
 
-  NodeType* mRoot;
+  NodeStorage mNodes;
+  /// Indexed by proxy. Unused leaves are linked through mNode.
+  Array<LeafData> mLeaves;
+  uint mFreeLeaf;
   uint mProxyCount;
+  /// Nodes inserted or removed since the last compaction.
+  uint mChangedNodeCount;
+  /// Scratch space for QuerySelfTree (kept to avoid allocating every query).
+  Array<Pair<uint, uint>> mNodePairScratch;
 };
 
 } // namespace Plasma
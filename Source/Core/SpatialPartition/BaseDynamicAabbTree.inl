@@ -8,71 +8,70 @@ namespace BaseDynamicTreeInternal
 
 static const Vec3 cAabbFatFactor = Vec3(.1f, .1f, .1f);
 static const real cAabbFatScaleFactor = real(1.2);
+// Small trees aren't compacted until at least this many nodes have changed.
+static const uint cMinCompactNodeChanges = 256;
 
 } // namespace BaseDynamicTreeInternal
 
 template <typename NodeType>
-typename BaseDynamicTreePolicy<NodeType>::NodeTypeDef* BaseDynamicTreePolicy<NodeType>::SelectNode(NodeType* parent,
-                                                                                                   NodeType* newLeaf)
+uint BaseDynamicTreePolicy<NodeType>::SelectNode(NodeStorage& nodes, uint parent, uint newLeaf)
 {
+  NodeType& parentNode = nodes[parent];
   // if there is no child 2 then we have to select child1
-  if (parent->mChild2 == nullptr)
-    return parent->mChild1;
+  if (parentNode.mChild2 == cInvalidDynamicTreeIndex)
+    return parentNode.mChild1;
 
-  Vec3 child1Pos = parent->mChild1->mAabb.GetCenter();
-  Vec3 child2Pos = parent->mChild2->mAabb.GetCenter();
-  Vec3 leafPos = newLeaf->mAabb.GetCenter();
+  Vec3 child1Pos = nodes[parentNode.mChild1].mAabb.GetCenter();
+  Vec3 child2Pos = nodes[parentNode.mChild2].mAabb.GetCenter();
+  Vec3 leafPos = nodes[newLeaf].mAabb.GetCenter();
 
   real child1Dist = (child1Pos - leafPos).LengthSq();
   real child2Dist = (child2Pos - leafPos).LengthSq();
   if (child1Dist < child2Dist)
-    return parent->mChild1;
-  return parent->mChild2;
+    return parentNode.mChild1;
+  return parentNode.mChild2;
 }
 
 template <typename NodeType>
-typename BaseDynamicTreePolicy<NodeType>::NodeTypeDef*
-BaseDynamicTreePolicy<NodeType>::CreateInternalNode(NodeType* oldParent, NodeType* oldChild, NodeType* newChild)
+uint BaseDynamicTreePolicy<NodeType>::CreateInternalNode(NodeStorage& nodes, uint oldParent, uint oldChild, uint newChild)
 {
-  NodeType* internalNode = new NodeType();
+  // allocate first, allocating can move the nodes
+  uint internalIndex = nodes.Allocate();
+  NodeType& internalNode = nodes[internalIndex];
 
-  // link the internal node pointers
-  internalNode->mChild1 = oldChild;
-  internalNode->mChild2 = newChild;
-  internalNode->mParent = oldParent;
+  // link the internal node indices
+  internalNode.mChild1 = oldChild;
+  internalNode.mChild2 = newChild;
+  internalNode.mParent = oldParent;
 
-  // link the children pointers
-  oldChild->mParent = internalNode;
-  newChild->mParent = internalNode;
+  // link the children indices
+  nodes[oldChild].mParent = internalIndex;
+  nodes[newChild].mParent = internalIndex;
 
-  // replace the correct child pointer for our old parent
-  if (oldParent != nullptr)
-  {
-    if (oldParent->mChild1 == oldChild)
-      oldParent->mChild1 = internalNode;
-    else
-      oldParent->mChild2 = internalNode;
-  }
+  // replace the correct child index for our old parent
+  if (oldParent != cInvalidDynamicTreeIndex)
+    nodes.ReplaceChild(oldParent, oldChild, internalIndex);
 
   // compute the internal node's aabb
-  internalNode->mAabb = oldChild->mAabb;
-  internalNode->mAabb = internalNode->mAabb.Combined(newChild->mAabb);
+  internalNode.mAabb = nodes[oldChild].mAabb;
+  internalNode.mAabb = internalNode.mAabb.Combined(nodes[newChild].mAabb);
 
-  return internalNode;
+  return internalIndex;
 }
 
 template <typename NodeType>
-void BaseDynamicTreePolicy<NodeType>::DeleteNode(NodeType* node)
+void BaseDynamicTreePolicy<NodeType>::DeleteNode(NodeStorage& nodes, uint node)
 {
-  node->mChild1 = node->mChild2 = nullptr;
-  delete node;
+  nodes[node].mChild1 = nodes[node].mChild2 = cInvalidDynamicTreeIndex;
+  nodes.Free(node);
 }
 
 template <typename PolicyType>
 BaseDynamicAabbTree<PolicyType>::BaseDynamicAabbTree()
 {
-  mRoot = nullptr;
+  mFreeLeaf = cInvalidDynamicTreeIndex;
   mProxyCount = 0;
+  mChangedNodeCount = 0;
 }
 
 template <typename PolicyType>
@@ -93,26 +92,48 @@ void BaseDynamicAabbTree<PolicyType>::CreateProxy(BroadPhaseProxy& proxy, DataTy
     aabb.AttemptToCorrectInvalid();
   }
 
-  NodeType* node = new NodeType();
-  node->mClientData = data.mClientData;
-  node->mAabb = aabb;
+  // reuse a free leaf if there is one
+  uint leaf = mFreeLeaf;
+  if (leaf == cInvalidDynamicTreeIndex)
+  {
+    leaf = mLeaves.Size();
+    mLeaves.PushBack();
+  }
+  else
+    mFreeLeaf = mLeaves[leaf].mNode;
+
+  uint nodeIndex = mNodes.Allocate();
+  NodeType& node = mNodes[nodeIndex];
+  node.mLeaf = leaf;
+  node.mAabb = aabb;
   Vec3 halfExtents = aabb.GetHalfExtents();
   halfExtents = Math::Min(halfExtents + BaseDynamicTreeInternal::cAabbFatFactor,
                           halfExtents * BaseDynamicTreeInternal::cAabbFatScaleFactor);
-  node->mAabb.SetCenterAndHalfExtents(aabb.GetCenter(), halfExtents);
+  node.mAabb.SetCenterAndHalfExtents(aabb.GetCenter(), halfExtents);
 
-  PolicyType::InsertNode(mRoot, node, mRoot);
-  proxy = BroadPhaseProxy(node);
+  LeafData& leafData = mLeaves[leaf];
+  leafData.mClientData = data.mClientData;
+  leafData.mNode = nodeIndex;
+
+  PolicyType::InsertNode(mNodes, nodeIndex, mNodes.mRoot);
+  proxy = DynamicTreeLeafToProxy(leaf);
   ++mProxyCount;
+  NodesChanged(2);
 }
 
 template <typename PolicyType>
 void BaseDynamicAabbTree<PolicyType>::RemoveProxy(BroadPhaseProxy& proxy)
 {
-  NodeType* node = static_cast<NodeType*>(proxy.ToVoidPointer());
-  PolicyType::RemoveNode(mRoot, node);
-  delete node;
+  uint leaf = DynamicTreeProxyToLeaf(proxy);
+  LeafData& leafData = mLeaves[leaf];
+  PolicyType::RemoveNode(mNodes, leafData.mNode);
+  mNodes.Free(leafData.mNode);
+
+  GetDefaultClientDataValue(leafData.mClientData);
+  leafData.mNode = mFreeLeaf;
+  mFreeLeaf = leaf;
   --mProxyCount;
+  NodesChanged(2);
 }
 
 template <typename PolicyType>
@@ -127,26 +148,24 @@ void BaseDynamicAabbTree<PolicyType>::UpdateProxy(BroadPhaseProxy& proxy, DataTy
     aabb.AttemptToCorrectInvalid();
   }
 
-  NodeType* node = static_cast<NodeType*>(proxy.ToVoidPointer());
+  uint leaf = DynamicTreeProxyToLeaf(proxy);
   // there could be an update where our client data changed
   // so make sure to update it (ie. a remove->Insert)
-  node->mClientData = data.mClientData;
-  Update(node, aabb);
+  mLeaves[leaf].mClientData = data.mClientData;
+  Update(leaf, aabb);
 }
 
 template <typename PolicyType>
 typename BaseDynamicAabbTree<PolicyType>::ClientDataType&
 BaseDynamicAabbTree<PolicyType>::GetClientData(BroadPhaseProxy& proxy)
 {
-  NodeType* node = static_cast<NodeType*>(proxy.ToVoidPointer());
-  return node->mClientData;
+  return mLeaves[DynamicTreeProxyToLeaf(proxy)].mClientData;
 }
 
 template <typename PolicyType>
 Aabb BaseDynamicAabbTree<PolicyType>::GetFatAabb(BroadPhaseProxy& proxy)
 {
-  NodeType* node = static_cast<NodeType*>(proxy.ToVoidPointer());
-  return node->mAabb;
+  return mNodes[mLeaves[DynamicTreeProxyToLeaf(proxy)].mNode].mAabb;
 }
 
 template <typename PolicyType>
@@ -158,104 +177,122 @@ uint BaseDynamicAabbTree<PolicyType>::GetTotalProxyCount() const
 template <typename PolicyType>
 void BaseDynamicAabbTree<PolicyType>::DrawEntireTree()
 {
-  DrawTree(mRoot);
+  DrawTree(mNodes.mRoot);
 }
 
 template <typename PolicyType>
 void BaseDynamicAabbTree<PolicyType>::Draw(int level)
 {
-  if (!mRoot)
+  if (mNodes.mRoot == cInvalidDynamicTreeIndex)
     return;
 
   if (level == -1)
-    DrawTree(mRoot);
+    DrawTree(mNodes.mRoot);
   else
-    DrawLevel(mRoot, 0, level);
+    DrawLevel(mNodes.mRoot, 0, level);
 }
 
 template <typename PolicyType>
-void BaseDynamicAabbTree<PolicyType>::DrawTree(NodeType* node)
+void BaseDynamicAabbTree<PolicyType>::DrawTree(uint node)
 {
-  if (!node)
+  if (node == cInvalidDynamicTreeIndex)
     return;
 
-  gDebugDraw->Add(Debug::Obb(node->mAabb).Color(Color::MintCream));
+  gDebugDraw->Add(Debug::Obb(mNodes[node].mAabb).Color(Color::MintCream));
 
-  DrawTree(node->mChild1);
-  DrawTree(node->mChild2);
+  DrawTree(mNodes[node].mChild1);
+  DrawTree(mNodes[node].mChild2);
 }
 
 template <typename PolicyType>
-void BaseDynamicAabbTree<PolicyType>::DrawLevel(NodeType* node, uint currLevel, uint level)
+void BaseDynamicAabbTree<PolicyType>::DrawLevel(uint node, uint currLevel, uint level)
 {
-  if (!node)
+  if (node == cInvalidDynamicTreeIndex)
     return;
 
   if (currLevel == level)
   {
-    gDebugDraw->Add(Debug::Obb(node->mAabb).Color(Color::MintCream));
+    gDebugDraw->Add(Debug::Obb(mNodes[node].mAabb).Color(Color::MintCream));
     return;
   }
 
-  DrawLevel(node->mChild1, currLevel + 1, level);
-  DrawLevel(node->mChild2, currLevel + 1, level);
+  DrawLevel(mNodes[node].mChild1, currLevel + 1, level);
+  DrawLevel(mNodes[node].mChild2, currLevel + 1, level);
 }
 
 template <typename PolicyType>
 void BaseDynamicAabbTree<PolicyType>::Clear()
 {
-  delete mRoot;
-  mRoot = nullptr;
+  mNodes.Clear();
+  mLeaves.Clear();
+  mFreeLeaf = cInvalidDynamicTreeIndex;
   mProxyCount = 0;
+  mChangedNodeCount = 0;
 }
 
 template <typename PolicyType>
 void BaseDynamicAabbTree<PolicyType>::Validate()
 {
-  NodeArray nodes;
-  nodes.Reserve(256);
-  nodes.PushBack(mRoot);
-
-  if (mRoot == nullptr)
+  if (mNodes.mRoot == cInvalidDynamicTreeIndex)
     return;
 
-  ErrorIf(mRoot->mParent != nullptr, "Root should have a null Parent.");
+  ErrorIf(mNodes[mNodes.mRoot].mParent != cInvalidDynamicTreeIndex, "Root should have an invalid Parent.");
+
+  Array<uint> nodes;
+  nodes.Reserve(256);
+  nodes.PushBack(mNodes.mRoot);
 
   while (!nodes.Empty())
   {
-    NodeType* node = nodes.Back();
+    uint index = nodes.Back();
     nodes.PopBack();
+    NodeType& node = mNodes[index];
 
-    if (node->IsLeaf())
+    if (node.IsLeaf())
     {
-      ErrorIf(node->mChild1 != nullptr, "Leaf should have a null Child 1 pointer.");
-      ErrorIf(node->mChild2 != nullptr, "Leaf should have a null Child 2 pointer.");
+      ErrorIf(node.mChild2 != cInvalidDynamicTreeIndex, "Leaf should have an invalid Child 2.");
+      ErrorIf(mLeaves[node.mLeaf].mNode != index, "Leaf data should point back at its node.");
     }
     else
     {
-      ErrorIf(node->mChild1 == nullptr, "Child 1 of an internal node should never be null.");
-      ErrorIf(node->mChild1 == nullptr, "Child 2 of an internal node should never be null.");
+      ErrorIf(node.mChild2 == cInvalidDynamicTreeIndex, "Child 2 of an internal node should never be invalid.");
+      ErrorIf(mNodes[node.mChild1].mParent != index, "Child 1 should point back at its parent.");
+      ErrorIf(mNodes[node.mChild2].mParent != index, "Child 2 should point back at its parent.");
 
-      Aabb& parent = node->mAabb;
-      Aabb& child1 = node->mChild1->mAabb;
-      Aabb& child2 = node->mChild2->mAabb;
+      Aabb& parent = node.mAabb;
+      Aabb& child1 = mNodes[node.mChild1].mAabb;
+      Aabb& child2 = mNodes[node.mChild2].mAabb;
       ErrorIf(!parent.ContainsPoint(child1.mMax) || !parent.ContainsPoint(child1.mMin),
               "Parent Aabb does not contain child 1.");
       ErrorIf(!parent.ContainsPoint(child2.mMax) || !parent.ContainsPoint(child2.mMin),
               "Parent Aabb does not contain child 2.");
-      nodes.PushBack(node->mChild1);
-      nodes.PushBack(node->mChild2);
+      nodes.PushBack(node.mChild1);
+      nodes.PushBack(node.mChild2);
     }
   }
 }
 
+template <typename PolicyType>
+void BaseDynamicAabbTree<PolicyType>::Compact()
+{
+  mChangedNodeCount = 0;
+
+  Array<NodeType> newNodes;
+  newNodes.Reserve(mNodes.mActiveCount);
+  if (mNodes.mRoot != cInvalidDynamicTreeIndex)
+    mNodes.mRoot = CompactSubtree(mNodes.mRoot, cInvalidDynamicTreeIndex, newNodes);
+
+  mNodes.mNodes.Swap(newNodes);
+  mNodes.mFreeList = cInvalidDynamicTreeIndex;
+}
+
 template <typename PolicyType>
 bool BaseDynamicAabbTree<PolicyType>::GetRootAabb(Aabb* aabb)
 {
-  if (!mRoot)
+  if (mNodes.mRoot == cInvalidDynamicTreeIndex)
     return false;
 
-  *aabb = mRoot->mAabb;
+  *aabb = mNodes[mNodes.mRoot].mAabb;
   return true;
 }
 
@@ -263,47 +300,98 @@ template <typename PolicyType>
 template <typename CallbackType>
 void BaseDynamicAabbTree<PolicyType>::QuerySelfTree(CallbackType* callback)
 {
-  TreeSelfQuery(callback, mRoot);
+  TreeSelfQuery(callback, mNodes, mNodePairScratch);
 }
 
 template <typename PolicyType>
 template <typename CallbackType>
 void BaseDynamicAabbTree<PolicyType>::QueryTree(CallbackType* callback, const BaseTreeType* tree)
 {
-  QueryTreeVsTree(callback, mRoot, tree->mRoot);
+  QueryTreeVsTree(callback, mNodes, tree->mNodes);
 }
 
 template <typename PolicyType>
 typename BaseDynamicAabbTree<PolicyType>::SelfQueryRange
 BaseDynamicAabbTree<PolicyType>::QuerySelf(NodePairArray& scratchBuffer)
 {
-  return SelfQueryRange(scratchBuffer, mRoot);
+  return SelfQueryRange(&scratchBuffer, this);
 }
 
 template <typename PolicyType>
-void BaseDynamicAabbTree<PolicyType>::Update(NodeType* leafNode, Aabb& aabb)
+void BaseDynamicAabbTree<PolicyType>::Update(uint leaf, Aabb& aabb)
 {
+  uint leafNode = mLeaves[leaf].mNode;
+  Aabb& oldAabb = mNodes[leafNode].mAabb;
+
   // our old Aabb contained our new one, so we don't have to do anything
-  if (leafNode->mAabb.ContainsPoint(aabb.mMin) && leafNode->mAabb.ContainsPoint(aabb.mMax))
+  if (oldAabb.ContainsPoint(aabb.mMin) && oldAabb.ContainsPoint(aabb.mMax))
     return;
 
   // remove the leaf node
-  NodeType* node = PolicyType::RemoveNode(mRoot, leafNode);
-  if (node == nullptr)
-    node = mRoot;
+  PolicyType::RemoveNode(mNodes, leafNode);
 
   // set the new fattened aabb
   Vec3 center = aabb.GetCenter();
   Vec3 halfExtents = aabb.GetHalfExtents();
   halfExtents = Math::Min(halfExtents + BaseDynamicTreeInternal::cAabbFatFactor,
                           halfExtents * BaseDynamicTreeInternal::cAabbFatScaleFactor);
-  leafNode->mAabb.SetCenterAndHalfExtents(center, halfExtents);
+  mNodes[leafNode].mAabb.SetCenterAndHalfExtents(center, halfExtents);
 
   // we could update at the last unaffected node, but there is no guarantee that
   // the new node is contained within that. We could iterate back up and find
   // the node to Insert from, but the speed of that is debatable. Instead,
   // just Insert from the root for now.
-  PolicyType::InsertNode(mRoot, leafNode, mRoot);
+  PolicyType::InsertNode(mNodes, leafNode, mNodes.mRoot);
+  NodesChanged(2);
+}
+
+template <typename PolicyType>
+void BaseDynamicAabbTree<PolicyType>::NodesChanged(uint count)
+{
+  // Compacting is linear in the size of the tree, so only compact after a
+  // similar amount of work has been done to keep the cost constant per change
+  mChangedNodeCount += count;
+  uint threshold = Math::Max(mNodes.mActiveCount, BaseDynamicTreeInternal::cMinCompactNodeChanges);
+  if (mChangedNodeCount >= threshold)
+    Compact();
+}
+
+template <typename PolicyType>
+uint BaseDynamicAabbTree<PolicyType>::CompactSubtree(uint node, uint newParent, Array<NodeType>& newNodes)
+{
+  // Fully iterative so deep (unbalanced) trees can't overflow the stack. Each
+  // chain of first children is laid out in a loop, the second children along
+  // the way are pushed and laid out afterwards (deepest first).
+  Array<uint> pendingChildren;
+  uint firstIndex = newNodes.Size();
+  while (true)
+  {
+    uint newIndex = newNodes.Size();
+    newNodes.PushBack(mNodes[node]);
+    newNodes[newIndex].mParent = newParent;
+
+    if (newNodes[newIndex].IsLeaf())
+    {
+      mLeaves[newNodes[newIndex].mLeaf].mNode = newIndex;
+
+      // Continue with the most recently pushed second child, its new parent
+      // still points at the old child until it's laid out here
+      if (pendingChildren.Empty())
+        break;
+      newParent = pendingChildren.Back();
+      pendingChildren.PopBack();
+      node = newNodes[newParent].mChild2;
+      newNodes[newParent].mChild2 = newNodes.Size();
+      continue;
+    }
+
+    // the first child always directly follows its parent
+    newNodes[newIndex].mChild1 = newIndex + 1;
+    pendingChildren.PushBack(newIndex);
+    node = mNodes[node].mChild1;
+    newParent = newIndex;
+  }
+  return firstIndex;
 }
 
 } // namespace Plasma
@@ -38,7 +38,6 @@ template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::CreateProxy(BroadPhaseProxy& proxy, BroadPhaseData& data)
 {
   mTree.CreateProxy(proxy, data);
-  NodeType* node = static_cast<NodeType*>(proxy.ToVoidPointer());
 
   // Temporarily Disabled: Leaks in the editor because nothing cleans up
   // mNodesToQuery
@@ -205,9 +204,8 @@ void BaseDynamicAabbTreeBroadPhase<TreeType>::QueryCallback(void* thisProxy, voi
     return;
 
   // we need to somehow prevent duplicates, so we are using a set. However,
-  // we need a unique key for our hash. So use the proxies
-  //(also the node pointers) in the pair. When we need the client data,
-  // we can retrieve the pair and therefore client data.
+  // we need a unique key for our hash. So use the proxies in the pair.
+  // When we need the client data, we can retrieve it from the tree.
   mPairs.Insert(NodePointerPair(thisProxy, otherProxy));
 }
 
@@ -281,10 +279,12 @@ void BaseDynamicAabbTreeBroadPhase<TreeType>::FillOutResults(ClientPairArray& re
   typename PairSet::range pairRange = mPairs.All();
   for (; !pairRange.Empty(); pairRange.PopFront())
   {
-    NodeType *node1, *node2;
+    void *proxy1, *proxy2;
     NodePointerPair& pair = pairRange.Front();
-    pair.Convert(node1, node2);
-    results.PushBack(ClientPair(node1->mClientData, node2->mClientData));
+    pair.Convert(proxy1, proxy2);
+    BroadPhaseProxy treeProxy1(proxy1);
+    BroadPhaseProxy treeProxy2(proxy2);
+    results.PushBack(ClientPair(mTree.GetClientData(treeProxy1), mTree.GetClientData(treeProxy2)));
   }
   mPairs.Clear();
 }
@@ -294,15 +294,14 @@ void BaseDynamicAabbTreeBroadPhase<TreeType>::AddQueryResult(Aabb& aabb)
 {
   forRangeBroadphaseTree(typename TreeType, mTree, Aabb, aabb)
   {
-    void* proxy1 = &range.proxyFront();
-    void* proxy2 = mQueryNode;
+    void* proxy1 = DynamicTreeLeafToProxy(range.proxyFront().mLeaf).ToVoidPointer();
+    void* proxy2 = DynamicTreeLeafToProxy(mQueryNode->mLeaf).ToVoidPointer();
     if (proxy1 == proxy2)
       continue;
 
     // we need to somehow prevent duplicates, so we are using a set. However,
-    // we need a unique key for our hash. So use the proxies
-    //(also the node pointers) in the pair. When we need the client data,
-    // we can retrieve the pair and therefore client data.
+    // we need a unique key for our hash. So use the proxies in the pair.
+    // When we need the client data, we can retrieve it from the tree.
 
     mPairs.Insert(NodePointerPair(proxy1, proxy2));
   }
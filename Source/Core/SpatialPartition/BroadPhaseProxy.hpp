@@ -201,5 +201,7 @@ typedef Array<BroadPhaseProxy*> ProxyHandleArray;
 typedef Array<BroadPhaseObject> BroadPhaseObjectArray;
 typedef Array<ClientPair> ClientPairArray;
 typedef Array<BroadPhaseDataPair> DataPairArray;
+// Collisions found during one frame of narrow phase.
+typedef Array<NodePointerPair, FrameAllocator> FrameNodePointerPairArray;
 
 } // namespace Plasma
@@ -184,7 +184,7 @@ Statistics* BroadPhaseTracker::GetStatistics(uint type, uint index)
 /// this function.  Each index represents the lexicographical id of the
 /// objects that collided.  This function will compare the results with
 /// what each broad phase has recorded and report any discrepancies.
-void BroadPhaseTracker::RecordFrameResults(const Array<NodePointerPair>& results)
+void BroadPhaseTracker::RecordFrameResults(const FrameNodePointerPairArray& results)
 {
   // Walk through each pair and record the collision
   for (uint i = 0; i < results.Size(); ++i)
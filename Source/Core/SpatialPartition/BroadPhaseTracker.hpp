@@ -78,7 +78,7 @@ public:
   /// this function.  Each index represents the lexicographical id of the
   /// objects that collided.  This function will compare the results with
   /// what each broad phase has recorded and report any discrepancies.
-  virtual void RecordFrameResults(const Array<NodePointerPair>& results);
+  virtual void RecordFrameResults(const FrameNodePointerPairArray& results);
 
   virtual bool IsTracking()
   {
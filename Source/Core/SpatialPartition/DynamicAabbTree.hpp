@@ -4,34 +4,26 @@
 namespace Plasma
 {
 
-namespace Memory
-{
-class Pool;
-}
-
 /// Node used for the dynamic aabb tree. Different from the static
-/// tree node because we need a parent pointer.
+/// tree node because we need a parent index. Nodes live in the tree's node
+/// storage and refer to each other by index. The client data is stored
+/// separately by the tree so that traversals only touch what they need.
 template <typename ClientDataType>
 struct DynamicTreeNode
 {
   DynamicTreeNode();
-  ~DynamicTreeNode();
-
-  static Memory::Pool* sDynamicNodePool;
-  static void* operator new(size_t size);
-  static void operator delete(void* pMem, size_t size);
 
-  bool IsLeaf();
-  // Assumes that a parent exists
-  DynamicTreeNode* GetSibling();
+  bool IsLeaf() const;
 
   Aabb mAabb;
-  ClientDataType mClientData;
 
-  DynamicTreeNode* mParent;
+  uint mParent;
 
-  DynamicTreeNode* mChild1;
-  DynamicTreeNode* mChild2;
+  uint mChild1;
+  uint mChild2;
+
+  /// Which of the tree's leaves this is (only valid for leaves).
+  uint mLeaf;
 };
 
 /// Policy for the DynamicAabbTree that determines
@@ -43,13 +35,15 @@ struct DynamicTreePolicy : public BaseDynamicTreePolicy<DynamicTreeNode<ClientDa
   typedef ClientDataType ClientDataTypeDef;
   typedef BaseDynamicTreePolicy<DynamicTreeNode<ClientDataType>> BaseType;
 
+  typedef typename BaseType::NodeStorage NodeStorage;
+
   /// Inserts the given leaf node at the starting node. Generally, start is
   /// the root, but when updating a node it may be somewhere in the middle
   // of the tree.
-  static void InsertNode(NodeType*& root, NodeType* leafNode, NodeType* start);
+  static void InsertNode(NodeStorage& nodes, uint leafNode, uint start);
   /// Removes the given node. Returns the last node that did not have to be
   /// resized from removal.
-  static NodeType* RemoveNode(NodeType*& root, NodeType* leafNode);
+  static uint RemoveNode(NodeStorage& nodes, uint leafNode);
 };
 
 /// A Hierarchical AabbTree that is meant for dynamic objects. Used to have a
@@ -64,7 +58,7 @@ public:
   typedef BaseDynamicAabbTree<DynamicTreePolicy<ClientDataType>> BaseType;
   typedef typename BaseType::PolicyTypeDef MyPolicyType;
 
-  using BaseType::mRoot;
+  using BaseType::mNodes;
 
   DynamicAabbTree();
   ~DynamicAabbTree();
@@ -6,131 +6,96 @@ namespace Plasma
 template <typename ClientDataType>
 DynamicTreeNode<ClientDataType>::DynamicTreeNode()
 {
-  mChild1 = nullptr;
-  mChild2 = nullptr;
-  mParent = nullptr;
-  GetDefaultClientDataValue(mClientData);
+  mParent = cInvalidDynamicTreeIndex;
+  mChild1 = cInvalidDynamicTreeIndex;
+  mChild2 = cInvalidDynamicTreeIndex;
+  mLeaf = cInvalidDynamicTreeIndex;
 }
 
 template <typename ClientDataType>
-DynamicTreeNode<ClientDataType>::~DynamicTreeNode()
+bool DynamicTreeNode<ClientDataType>::IsLeaf() const
 {
-  delete mChild1;
-  delete mChild2;
+  return mChild1 == cInvalidDynamicTreeIndex;
 }
 
 template <typename ClientDataType>
-Memory::Pool* DynamicTreeNode<ClientDataType>::sDynamicNodePool =
-    new Memory::Pool("DynamicNodes", Memory::GetNamedHeap("BroadPhase"), sizeof(DynamicTreeNode<ClientDataType>), 200);
-
-template <typename ClientDataType>
-void* DynamicTreeNode<ClientDataType>::operator new(size_t size)
-{
-  return sDynamicNodePool->Allocate(size);
-}
-
-template <typename ClientDataType>
-void DynamicTreeNode<ClientDataType>::operator delete(void* pMem, size_t size)
-{
-  return sDynamicNodePool->Deallocate(pMem, size);
-}
-
-template <typename ClientDataType>
-bool DynamicTreeNode<ClientDataType>::IsLeaf()
-{
-  return mChild1 == nullptr;
-}
-
-template <typename ClientDataType>
-DynamicTreeNode<ClientDataType>* DynamicTreeNode<ClientDataType>::GetSibling()
-{
-  if (mParent->mChild1 == this)
-    return mParent->mChild2;
-  return mParent->mChild1;
-}
-
-template <typename ClientDataType>
-void DynamicTreePolicy<ClientDataType>::InsertNode(NodeType*& root, NodeType* leafNode, NodeType* start)
+void DynamicTreePolicy<ClientDataType>::InsertNode(NodeStorage& nodes, uint leafNode, uint start)
 {
   // if we have no root, then this node is the root
-  if (root == nullptr)
+  if (nodes.mRoot == cInvalidDynamicTreeIndex)
   {
-    root = leafNode;
-    root->mParent = nullptr;
+    nodes.mRoot = leafNode;
+    nodes[leafNode].mParent = cInvalidDynamicTreeIndex;
     return;
   }
 
   // traverse until we find the correct leaf node to add at
-  NodeType* node = start;
-  while (!node->IsLeaf())
+  uint node = start;
+  while (!nodes.IsLeaf(node))
   {
     // expand the aabb's of our parent as we go down
-    node->mAabb = node->mAabb.Combined(leafNode->mAabb);
+    nodes[node].mAabb = nodes[node].mAabb.Combined(nodes[leafNode].mAabb);
     // choose the correct node between the left and right node
-    node = BaseType::SelectNode(node, leafNode);
+    node = BaseType::SelectNode(nodes, node, leafNode);
   }
 
   // all our objects must be on leaf nodes, so we have
   // to make a new internal node to put the old leaf and the new leaf
-  NodeType* oldParent = node->mParent;
-  NodeType* newParent = BaseType::CreateInternalNode(oldParent, node, leafNode);
+  uint oldParent = nodes[node].mParent;
+  uint newParent = BaseType::CreateInternalNode(nodes, oldParent, node, leafNode);
 
-  // deal with fixing the root pointer if the tree contained only 1 node
-  if (nullptr == oldParent)
-    root = newParent;
+  // deal with fixing the root index if the tree contained only 1 node
+  if (oldParent == cInvalidDynamicTreeIndex)
+    nodes.mRoot = newParent;
 }
 
 template <typename ClientDataType>
-typename DynamicTreePolicy<ClientDataType>::NodeType* DynamicTreePolicy<ClientDataType>::RemoveNode(NodeType*& root,
-                                                                                                    NodeType* leafNode)
+uint DynamicTreePolicy<ClientDataType>::RemoveNode(NodeStorage& nodes, uint leafNode)
 {
-  ErrorIf(leafNode->mChild1 != nullptr, "Can only remove leaf nodes.");
-  ErrorIf(leafNode->mChild2 != nullptr, "Can only remove leaf nodes.");
+  ErrorIf(!nodes.IsLeaf(leafNode), "Can only remove leaf nodes.");
 
   // deal with removing the root
-  if (leafNode == root)
+  if (leafNode == nodes.mRoot)
   {
-    root = nullptr;
-    return root;
+    nodes.mRoot = cInvalidDynamicTreeIndex;
+    return nodes.mRoot;
   }
 
-  NodeType* parent = leafNode->mParent;
-  NodeType* grandParent = parent->mParent;
-  NodeType* sibling = leafNode->GetSibling();
+  uint parent = nodes[leafNode].mParent;
+  uint grandParent = nodes[parent].mParent;
+  uint sibling = nodes.GetSibling(leafNode);
   // if our parent is the root, then our sibling will have to
   // become the new root
-  if (grandParent == nullptr)
+  if (grandParent == cInvalidDynamicTreeIndex)
   {
-    BaseType::DeleteNode(root);
-    sibling->mParent = nullptr;
-    root = sibling;
-    return root;
+    BaseType::DeleteNode(nodes, nodes.mRoot);
+    nodes[sibling].mParent = cInvalidDynamicTreeIndex;
+    nodes.mRoot = sibling;
+    return nodes.mRoot;
   }
 
   // set our sibling to be where our old parent was,
   // then delete our parent
-  if (grandParent->mChild1 == parent)
-    grandParent->mChild1 = sibling;
-  else
-    grandParent->mChild2 = sibling;
-  sibling->mParent = grandParent;
-  BaseType::DeleteNode(parent);
+  nodes.ReplaceChild(grandParent, parent, sibling);
+  nodes[sibling].mParent = grandParent;
+  BaseType::DeleteNode(nodes, parent);
 
   // work up the tree shrinking the Aabb's to account for us being removed
-  while (grandParent)
+  while (grandParent != cInvalidDynamicTreeIndex)
   {
-    Aabb oldAabb = grandParent->mAabb;
-    grandParent->mAabb = grandParent->mChild1->mAabb;
-    grandParent->mAabb = grandParent->mAabb.Combined(grandParent->mChild2->mAabb);
+    NodeType& node = nodes[grandParent];
+    Aabb oldAabb = node.mAabb;
+    node.mAabb = nodes[node.mChild1].mAabb;
+    node.mAabb = node.mAabb.Combined(nodes[node.mChild2].mAabb);
 
     // if our old Aabb and our new Aabb are of the same size, then there
     // is no point in continuing up the tree since none of our parent's will
     // grow
-    int result = memcmp(&oldAabb, &(grandParent->mAabb), sizeof(Aabb));
+    int result = memcmp(&oldAabb, &(node.mAabb), sizeof(Aabb));
     if (result == 0)
       return grandParent;
 
-    grandParent = grandParent->mParent;
+    grandParent = node.mParent;
   }
   return grandParent;
 }
@@ -150,24 +115,24 @@ DynamicAabbTree<ClientDataType>::~DynamicAabbTree()
 template <typename ClientDataType>
 void DynamicAabbTree<ClientDataType>::Rebalance(uint iterations)
 {
-  if (mRoot == nullptr)
+  if (mNodes.mRoot == cInvalidDynamicTreeIndex)
     return;
 
   for (uint i = 0; i < iterations; ++i)
   {
     uint bit = 0;
-    typename BaseType::NodeType* node = mRoot;
+    uint node = mNodes.mRoot;
 
     // shuffle down the leaves based upon a path variable.
     // each bit represents whether to go left or right at the level
     // corresponding to bit #.
-    while (!node->IsLeaf())
+    while (!mNodes.IsLeaf(node))
     {
       uint selection = (mPath >> bit) & 0x1;
       if (selection == 0)
-        node = node->mChild1;
+        node = mNodes[node].mChild1;
       else
-        node = node->mChild2;
+        node = mNodes[node].mChild2;
 
       // since path is 32 bits, we need to keep
       // bit between 0 and 31
@@ -175,8 +140,8 @@ void DynamicAabbTree<ClientDataType>::Rebalance(uint iterations)
     }
     ++mPath;
 
-    MyPolicyType::RemoveNode(mRoot, node);
-    MyPolicyType::InsertNode(mRoot, node, mRoot);
+    MyPolicyType::RemoveNode(mNodes, node);
+    MyPolicyType::InsertNode(mNodes, node, mNodes.mRoot);
   }
 }
 
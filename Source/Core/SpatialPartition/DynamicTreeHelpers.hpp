@@ -4,88 +4,202 @@
 namespace Plasma
 {
 
-// Callback is expected to have a method called QueryCallback (world space
-// trees)
+/// Used for a node index that doesn't refer to any node (no parent, no children
+/// or the end of a free list) in the dynamic trees.
+const uint cInvalidDynamicTreeIndex = uint(-1);
+
+/// Dynamic tree proxies hold the index of the leaf plus one so that a valid
+/// proxy is never null.
+inline BroadPhaseProxy DynamicTreeLeafToProxy(uint leaf)
+{
+  return BroadPhaseProxy(reinterpret_cast<void*>(uintptr_t(leaf) + 1));
+}
+
+inline uint DynamicTreeProxyToLeaf(const BroadPhaseProxy& proxy)
+{
+  return uint(reinterpret_cast<uintptr_t>(proxy.ToVoidPointer()) - 1);
+}
+
+/// Contiguous storage for the nodes of a dynamic tree. Nodes refer to each
+/// other by index (so the whole tree can be moved or reordered) and freed
+/// nodes are reused before the array grows. Node references are invalidated
+/// by Allocate since it may have to grow the array.
+template <typename NodeType>
+struct DynamicTreeNodes
+{
+  DynamicTreeNodes()
+  {
+    mRoot = cInvalidDynamicTreeIndex;
+    mFreeList = cInvalidDynamicTreeIndex;
+    mActiveCount = 0;
+  }
+
+  NodeType& operator[](uint index)
+  {
+    return mNodes[index];
+  }
+
+  const NodeType& operator[](uint index) const
+  {
+    return mNodes[index];
+  }
+
+  /// Returns the index of a new (default constructed) node.
+  uint Allocate()
+  {
+    ++mActiveCount;
+    if (mFreeList == cInvalidDynamicTreeIndex)
+    {
+      mNodes.PushBack(NodeType());
+      return mNodes.Size() - 1;
+    }
+
+    uint index = mFreeList;
+    mFreeList = mNodes[index].mParent;
+    mNodes[index] = NodeType();
+    return index;
+  }
+
+  /// Puts the node on the free list (free nodes are linked through their parent).
+  void Free(uint index)
+  {
+    --mActiveCount;
+    mNodes[index].mParent = mFreeList;
+    mFreeList = index;
+  }
+
+  void Clear()
+  {
+    mNodes.Clear();
+    mRoot = cInvalidDynamicTreeIndex;
+    mFreeList = cInvalidDynamicTreeIndex;
+    mActiveCount = 0;
+  }
+
+  bool IsLeaf(uint index) const
+  {
+    return mNodes[index].IsLeaf();
+  }
+
+  // Assumes that a parent exists
+  uint GetSibling(uint index) const
+  {
+    const NodeType& parent = mNodes[mNodes[index].mParent];
+    if (parent.mChild1 == index)
+      return parent.mChild2;
+    return parent.mChild1;
+  }
+
+  /// Points the parent's child at newChild instead of oldChild (or makes
+  /// newChild the root if there is no parent).
+  void ReplaceChild(uint parent, uint oldChild, uint newChild)
+  {
+    if (parent == cInvalidDynamicTreeIndex)
+    {
+      mRoot = newChild;
+      return;
+    }
+
+    NodeType& parentNode = mNodes[parent];
+    if (parentNode.mChild1 == oldChild)
+      parentNode.mChild1 = newChild;
+    else
+      parentNode.mChild2 = newChild;
+  }
+
+  Array<NodeType> mNodes;
+  uint mRoot;
+  uint mFreeList;
+  uint mActiveCount;
+};
+
+// Callback is expected to have a method called QueryCallback(void* proxy1, void* proxy2)
+// which is given the proxies of every pair of overlapping leaves (world space trees)
 template <typename CallbackType, typename NodeType>
-void TreeSelfQuery(CallbackType* callback, NodeType* root)
+void TreeSelfQuery(CallbackType* callback, const DynamicTreeNodes<NodeType>& nodes, Array<Pair<uint, uint>>& nodePairs)
 {
-  if (root == nullptr || root->IsLeaf())
+  nodePairs.Clear();
+  uint root = nodes.mRoot;
+  if (root == cInvalidDynamicTreeIndex || nodes[root].IsLeaf())
     return;
 
-  typedef Pair<NodeType*, NodeType*> NodePair;
-  static Array<NodePair> nodePairs;
-
   nodePairs.Reserve(256);
-  nodePairs.PushBack(MakePair(root->mChild1, root->mChild2));
+  nodePairs.PushBack(MakePair(nodes[root].mChild1, nodes[root].mChild2));
 
   for (uint i = 0; i < nodePairs.Size(); ++i)
   {
-    NodePair& pair = nodePairs[i];
-    NodeType* nodeA = pair.first;
-    NodeType* nodeB = pair.second;
-
-    if (!nodeA->IsLeaf())
-      nodePairs.PushBack(MakePair(nodeA->mChild1, nodeA->mChild2));
-    if (!nodeB->IsLeaf())
-      nodePairs.PushBack(MakePair(nodeB->mChild1, nodeB->mChild2));
+    const NodeType& nodeA = nodes[nodePairs[i].first];
+    const NodeType& nodeB = nodes[nodePairs[i].second];
+
+    if (!nodeA.IsLeaf())
+      nodePairs.PushBack(MakePair(nodeA.mChild1, nodeA.mChild2));
+    if (!nodeB.IsLeaf())
+      nodePairs.PushBack(MakePair(nodeB.mChild1, nodeB.mChild2));
   }
 
   while (!nodePairs.Empty())
   {
-    NodeType* nodeA = nodePairs.Back().first;
-    NodeType* nodeB = nodePairs.Back().second;
+    uint indexA = nodePairs.Back().first;
+    uint indexB = nodePairs.Back().second;
     nodePairs.PopBack();
+    const NodeType& nodeA = nodes[indexA];
+    const NodeType& nodeB = nodes[indexB];
 
     // if the nodes don't overlap, we don't care
-    if (!nodeA->mAabb.Overlap(nodeB->mAabb))
+    if (!nodeA.mAabb.Overlap(nodeB.mAabb))
       continue;
 
-    if (nodeA->IsLeaf())
+    if (nodeA.IsLeaf())
     {
-      if (nodeB->IsLeaf())
+      if (nodeB.IsLeaf())
       {
-        callback->QueryCallback(nodeA, nodeB);
+        callback->QueryCallback(DynamicTreeLeafToProxy(nodeA.mLeaf).ToVoidPointer(),
+                                DynamicTreeLeafToProxy(nodeB.mLeaf).ToVoidPointer());
         continue;
       }
-      nodePairs.PushBack(MakePair(nodeA, nodeB->mChild1));
-      nodePairs.PushBack(MakePair(nodeA, nodeB->mChild2));
+      nodePairs.PushBack(MakePair(indexA, nodeB.mChild1));
+      nodePairs.PushBack(MakePair(indexA, nodeB.mChild2));
     }
-    else if (nodeB->IsLeaf())
+    else if (nodeB.IsLeaf())
     {
-      nodePairs.PushBack(MakePair(nodeA->mChild1, nodeB));
-      nodePairs.PushBack(MakePair(nodeA->mChild2, nodeB));
+      nodePairs.PushBack(MakePair(nodeA.mChild1, indexB));
+      nodePairs.PushBack(MakePair(nodeA.mChild2, indexB));
     }
     else
     {
-      nodePairs.PushBack(MakePair(nodeA->mChild1, nodeB->mChild1));
-      nodePairs.PushBack(MakePair(nodeA->mChild1, nodeB->mChild2));
-      nodePairs.PushBack(MakePair(nodeA->mChild2, nodeB->mChild1));
-      nodePairs.PushBack(MakePair(nodeA->mChild2, nodeB->mChild2));
+      nodePairs.PushBack(MakePair(nodeA.mChild1, nodeB.mChild1));
+      nodePairs.PushBack(MakePair(nodeA.mChild1, nodeB.mChild2));
+      nodePairs.PushBack(MakePair(nodeA.mChild2, nodeB.mChild1));
+      nodePairs.PushBack(MakePair(nodeA.mChild2, nodeB.mChild2));
     }
   }
 }
 
+// Callback is expected to have a method called QueryCallback(void* proxyA, void* proxyB)
+// where proxyA is from treeA and proxyB is from treeB (world space trees)
 template <typename CallbackType, typename NodeType>
-void QueryTreeVsTree(CallbackType* callback, NodeType* rootA, NodeType* rootB)
+void QueryTreeVsTree(CallbackType* callback, const DynamicTreeNodes<NodeType>& nodesA, const DynamicTreeNodes<NodeType>& nodesB)
 {
-  if (rootA == nullptr || rootB == nullptr)
+  if (nodesA.mRoot == cInvalidDynamicTreeIndex || nodesB.mRoot == cInvalidDynamicTreeIndex)
     return;
 
   // not that it matters, but this is always ordered such that pair.first is
   // from this treeA and pair.second is from treeB.
-  typedef Pair<NodeType*, NodeType*> NodePair;
+  typedef Pair<uint, uint> NodePair;
   Array<NodePair> nodes;
   nodes.Reserve(256);
-  nodes.PushBack(MakePair(rootA, rootB));
+  nodes.PushBack(MakePair(nodesA.mRoot, nodesB.mRoot));
 
   while (!nodes.Empty())
   {
-    NodeType* nodeA = nodes.Back().first;
-    NodeType* nodeB = nodes.Back().second;
+    uint indexA = nodes.Back().first;
+    uint indexB = nodes.Back().second;
     nodes.PopBack();
+    const NodeType& nodeA = nodesA[indexA];
+    const NodeType& nodeB = nodesB[indexB];
 
     // if the nodes don't overlap, we don't care
-    if (!nodeA->mAabb.Overlap(nodeB->mAabb))
+    if (!nodeA.mAabb.Overlap(nodeB.mAabb))
       continue;
 
     // here's the 3 cases for what to do with a node:
@@ -97,32 +211,33 @@ void QueryTreeVsTree(CallbackType* callback, NodeType* rootA, NodeType* rootB)
     // Efficient Collision Detection of Complex Deformable Models using AABB
     // Trees)
 
-    if (nodeA->IsLeaf())
+    if (nodeA.IsLeaf())
     {
-      if (nodeB->IsLeaf())
+      if (nodeB.IsLeaf())
       {
-        callback->QueryCallback(nodeA, nodeB);
+        callback->QueryCallback(DynamicTreeLeafToProxy(nodeA.mLeaf).ToVoidPointer(),
+                                DynamicTreeLeafToProxy(nodeB.mLeaf).ToVoidPointer());
         continue;
       }
-      nodes.PushBack(MakePair(nodeA, nodeB->mChild1));
-      nodes.PushBack(MakePair(nodeA, nodeB->mChild2));
+      nodes.PushBack(MakePair(indexA, nodeB.mChild1));
+      nodes.PushBack(MakePair(indexA, nodeB.mChild2));
     }
-    else if (nodeB->IsLeaf())
+    else if (nodeB.IsLeaf())
     {
-      nodes.PushBack(MakePair(nodeA->mChild1, nodeB));
-      nodes.PushBack(MakePair(nodeA->mChild2, nodeB));
+      nodes.PushBack(MakePair(nodeA.mChild1, indexB));
+      nodes.PushBack(MakePair(nodeA.mChild2, indexB));
     }
     else
     {
-      if (nodeA->mAabb.GetVolume() > nodeB->mAabb.GetVolume())
+      if (nodeA.mAabb.GetVolume() > nodeB.mAabb.GetVolume())
       {
-        nodes.PushBack(MakePair(nodeA->mChild1, nodeB));
-        nodes.PushBack(MakePair(nodeA->mChild2, nodeB));
+        nodes.PushBack(MakePair(nodeA.mChild1, indexB));
+        nodes.PushBack(MakePair(nodeA.mChild2, indexB));
       }
       else
       {
-        nodes.PushBack(MakePair(nodeA, nodeB->mChild1));
-        nodes.PushBack(MakePair(nodeA, nodeB->mChild2));
+        nodes.PushBack(MakePair(indexA, nodeB.mChild1));
+        nodes.PushBack(MakePair(indexA, nodeB.mChild2));
       }
     }
   }
@@ -45,6 +45,7 @@ public:
 #include "SapBroadPhase.hpp"
 #include "AabbTreeNode.hpp"
 #include "AabbTreeMethods.hpp"
+#include "WideAabbTree.hpp"
 #include "StaticAabbTree.hpp"
 #include "StaticAabbTreeBroadPhase.hpp"
 #include "BroadPhasePackage.hpp"
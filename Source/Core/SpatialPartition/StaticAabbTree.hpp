@@ -84,6 +84,10 @@ public:
   /// Tells the structure that it has all of the data it will ever have. Used
   /// mainly for static BroadPhases.
   void Construct();
+  /// Same as Construct, but large trees are built in parallel through
+  /// parallelFor (see BuildTreeTopDownNodesParallel).
+  template <typename ParallelForType>
+  void Construct(ParallelForType& parallelFor);
 
   ///"Destructs" the entire tree. Still holds on to the inserted objects.
   void Destruct();
@@ -126,13 +130,23 @@ public:
   /// Sets the current partition method.
   void SetPartitionMethod(PartitionMethods::Enum method);
 
+  /// The tree collapsed to cWideAabbTreeWidth children per node. Rebuilt on
+  /// every construction, queries should prefer it over the binary tree (see
+  /// the forRangeWideAabbTree macro).
+  WideAabbTree<ClientDataType>& GetWideTree();
+
 private:
   template <typename ClientDataTypeOther>
-  friend void SerializeAabbTree(Serializer& stream, StaticAabbTree<ClientDataTypeOther>& tree);
+  friend bool SerializeAabbTree(Serializer& stream, StaticAabbTree<ClientDataTypeOther>& tree);
 
   typedef uint (*PartitionNodeMethodPtr)(NodeArray&);
   PartitionNodeMethodPtr CurrPartitionMethod;
 
+  /// Applies the pending updates and collects every leaf into mNodesAdded.
+  /// Returns false if there is nothing to build.
+  bool PrepareConstruct();
+  void FinishConstruct();
+
   /// Draw the tree at a given level.
   void DrawLevel(NodePointer node, uint currLevel, uint level);
   void DrawTree(NodePointer node);
@@ -147,6 +161,7 @@ private:
   PartitionMethods::Enum mPartitionMethod;
 
   NodePointer mRoot;
+  WideAabbTree<ClientDataType> mWideTree;
   NodeArray mNodesAdded;
   UpdateArray mUpdateNodes;
   NodeSet mNodesRemoved;
@@ -159,8 +174,12 @@ typedef StaticAabbTree<void*> StaticAabbTreeDefault;
 template <typename ClientDataType>
 AabbNode<ClientDataType>* SerializeAabbTree(Serializer& stream);
 
+/// Saves the tree in a flat form (the nodes in depth first order with the
+/// index of each node's second child) that loads without rebuilding the tree.
+/// Returns true if a tree in that form was loaded, trees saved by older
+/// versions are loaded node by node and may need to be reconstructed.
 template <typename ClientDataType>
-void SerializeAabbTree(Serializer& stream, StaticAabbTree<ClientDataType>& tree);
+bool SerializeAabbTree(Serializer& stream, StaticAabbTree<ClientDataType>& tree);
 
 } // namespace Plasma
 
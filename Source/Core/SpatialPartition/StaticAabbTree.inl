@@ -112,6 +112,28 @@ uint StaticAabbTree<ClientDataType>::GetTotalProxyCount() const
 
 template <typename ClientDataType>
 void StaticAabbTree<ClientDataType>::Construct()
+{
+  if (!PrepareConstruct())
+    return;
+
+  // now build the tree from all of these leaf nodes
+  mRoot = BuildTreeTopDownNodes<NodeType>(mNodesAdded, CurrPartitionMethod);
+  FinishConstruct();
+}
+
+template <typename ClientDataType>
+template <typename ParallelForType>
+void StaticAabbTree<ClientDataType>::Construct(ParallelForType& parallelFor)
+{
+  if (!PrepareConstruct())
+    return;
+
+  mRoot = BuildTreeTopDownNodesParallel<NodeType>(mNodesAdded, CurrPartitionMethod, parallelFor);
+  FinishConstruct();
+}
+
+template <typename ClientDataType>
+bool StaticAabbTree<ClientDataType>::PrepareConstruct()
 {
   // update all of the nodes that need updating
   typename UpdateArray::range range = mUpdateNodes.All();
@@ -128,12 +150,14 @@ void StaticAabbTree<ClientDataType>::Construct()
   // internal nodes along with the new nodes to be added
   DeleteInternalNodes(mNodesAdded);
 
-  if (mNodesAdded.Empty())
-    return;
+  return !mNodesAdded.Empty();
+}
 
-  // now build the tree from all of these leaf nodes
-  mRoot = BuildTreeTopDownNodes<NodeType>(mNodesAdded, CurrPartitionMethod);
+template <typename ClientDataType>
+void StaticAabbTree<ClientDataType>::FinishConstruct()
+{
   mNodesAdded.Clear();
+  mWideTree.Build(mRoot);
 }
 
 template <typename ClientDataType>
@@ -203,6 +227,14 @@ void StaticAabbTree<ClientDataType>::SetPartitionMethod(PartitionMethods::Enum m
     CurrPartitionMethod = &MinimizeSurfaceAreaSumNodes<NodeType>;
   else if (mPartitionMethod == PartitionMethods::MidPoint)
     CurrPartitionMethod = &MidPointNodes<NodeType>;
+  else if (mPartitionMethod == PartitionMethods::BinnedSurfaceAreaHeuristic)
+    CurrPartitionMethod = &BinnedSurfaceAreaHeuristicNodes<NodeType>;
+}
+
+template <typename ClientDataType>
+WideAabbTree<ClientDataType>& StaticAabbTree<ClientDataType>::GetWideTree()
+{
+  return mWideTree;
 }
 
 template <typename ClientDataType>
@@ -253,27 +285,144 @@ void StaticAabbTree<ClientDataType>::DeleteInternalNodes(Array<NodePointer>& lea
 
   mRoot = nullptr;
   mNodesRemoved.Clear();
+  mWideTree.Clear();
+}
+
+template <typename ClientDataType>
+void SaveFlatAabbTree(Serializer& stream, AabbNode<ClientDataType>* root)
+{
+  typedef AabbNode<ClientDataType> Node;
+  const uint cNoParent = uint(-1);
+
+  // Walk the tree in depth first order. The first child of an internal
+  // node always follows it, so only the index of the second is stored.
+  Array<Vec3> bounds;
+  Array<uint> links;
+  Array<ClientDataType> clientData;
+  Array<Pair<Node*, uint>> stack;
+  if (root != nullptr)
+    stack.PushBack(Pair<Node*, uint>(root, cNoParent));
+
+  while (!stack.Empty())
+  {
+    Node* node = stack.Back().first;
+    uint parent = stack.Back().second;
+    stack.PopBack();
+
+    uint index = links.Size();
+    if (parent != cNoParent)
+      links[parent] = index;
+
+    bounds.PushBack(node->mAabb.mMin);
+    bounds.PushBack(node->mAabb.mMax);
+    links.PushBack(0);
+
+    if (node->IsLeaf())
+    {
+      clientData.PushBack(node->mClientData);
+      continue;
+    }
+
+    // The second child is linked from its parent once it's reached
+    stack.PushBack(Pair<Node*, uint>(node->mChild2, index));
+    stack.PushBack(Pair<Node*, uint>(node->mChild1, cNoParent));
+  }
+
+  stream.SerializeField("Bounds", bounds);
+  stream.SerializeField("Links", links);
+  stream.SerializeField("ClientData", clientData);
+}
+
+template <typename ClientDataType>
+AabbNode<ClientDataType>* LoadFlatAabbTree(Serializer& stream, uint& leafCount)
+{
+  typedef AabbNode<ClientDataType> Node;
+
+  Array<Vec3> bounds;
+  Array<uint> links;
+  Array<ClientDataType> clientData;
+  stream.SerializeField("Bounds", bounds);
+  stream.SerializeField("Links", links);
+  stream.SerializeField("ClientData", clientData);
+
+  // Make sure the links form a valid tree before allocating anything
+  uint nodeCount = links.Size();
+  leafCount = 0;
+  bool valid = bounds.Size() == nodeCount * 2;
+  for (uint i = 0; valid && i < nodeCount; ++i)
+  {
+    if (links[i] == 0)
+      ++leafCount;
+    else
+      valid = links[i] > i + 1 && links[i] < nodeCount;
+  }
+  valid = valid && nodeCount != 0 && leafCount == clientData.Size() && nodeCount == leafCount * 2 - 1;
+  ErrorIf(!valid && nodeCount != 0, "Invalid serialized aabb tree.");
+  if (!valid)
+  {
+    leafCount = 0;
+    return nullptr;
+  }
+
+  Array<Node*> nodes;
+  nodes.Resize(nodeCount);
+  for (uint i = 0; i < nodeCount; ++i)
+    nodes[i] = new Node();
+
+  uint leafIndex = 0;
+  for (uint i = 0; i < nodeCount; ++i)
+  {
+    Node* node = nodes[i];
+    node->mAabb.mMin = bounds[i * 2];
+    node->mAabb.mMax = bounds[i * 2 + 1];
+    if (links[i] == 0)
+    {
+      node->mClientData = clientData[leafIndex++];
+      continue;
+    }
+
+    node->mChild1 = nodes[i + 1];
+    node->mChild2 = nodes[links[i]];
+    node->mLeaf = false;
+  }
+
+  return nodes[0];
 }
 
 template <typename ClientDataType>
-void SerializeAabbTree(Serializer& stream, StaticAabbTree<ClientDataType>& tree)
+bool SerializeAabbTree(Serializer& stream, StaticAabbTree<ClientDataType>& tree)
 {
   if (stream.GetMode() == SerializerMode::Saving)
   {
+    // The node by node tree is left empty so older versions still load
     stream.StartPolymorphic("StaticAabbTree");
-    SerializeAabbTree(stream, tree.mRoot);
     stream.EndPolymorphic();
+
+    stream.StartPolymorphic("FlatAabbTree");
+    SaveFlatAabbTree(stream, tree.mRoot);
+    stream.EndPolymorphic();
+    return false;
   }
-  else
+
+  PolymorphicNode node;
+  if (stream.GetPolymorphic(node))
   {
-    PolymorphicNode node;
-    if (stream.GetPolymorphic(node))
-    {
-      tree.mRoot = SerializeAabbTree<ClientDataType>(stream);
-      tree.CountProxies();
-      stream.EndPolymorphic();
-    }
+    tree.mRoot = SerializeAabbTree<ClientDataType>(stream);
+    stream.EndPolymorphic();
   }
+
+  bool loadedFlatTree = false;
+  if (tree.mRoot == nullptr && stream.GetPolymorphic(node))
+  {
+    tree.mRoot = LoadFlatAabbTree<ClientDataType>(stream, tree.mProxyCount);
+    loadedFlatTree = tree.mRoot != nullptr;
+    stream.EndPolymorphic();
+  }
+
+  if (!loadedFlatTree)
+    tree.CountProxies();
+  tree.mWideTree.Build(tree.mRoot);
+  return loadedFlatTree;
 }
 
 template <typename ClientDataType>
@@ -73,7 +73,7 @@ void StaticAabbTreeBroadPhase::SelfQuery(ClientPairArray& results)
 
 void StaticAabbTreeBroadPhase::Query(BroadPhaseData& data, ClientPairArray& results)
 {
-  forRangeBroadphaseTree(TreeType, mTree, Aabb, data.mAabb)
+  forRangeWideAabbTree(mTree.GetWideTree(), Aabb, data.mAabb)
       results.PushBack(ClientPair(data.mClientData, range.Front()));
 }
 
@@ -93,35 +93,35 @@ void StaticAabbTreeBroadPhase::CastRay(CastDataParam data, ProxyCastResults& res
 {
   SimpleRayCallback callback(mCastRayCallBack, &results);
 
-  forRangeBroadphaseTree(TreeType, mTree, Ray, data.GetRay()) callback.Refine(range.Front(), data);
+  forRangeWideAabbTree(mTree.GetWideTree(), Ray, data.GetRay()) callback.Refine(range.Front(), data);
 }
 
 void StaticAabbTreeBroadPhase::CastSegment(CastDataParam data, ProxyCastResults& results)
 {
   SimpleSegmentCallback callback(mCastSegmentCallBack, &results);
 
-  forRangeBroadphaseTree(TreeType, mTree, Segment, data.GetSegment()) callback.Refine(range.Front(), data);
+  forRangeWideAabbTree(mTree.GetWideTree(), Segment, data.GetSegment()) callback.Refine(range.Front(), data);
 }
 
 void StaticAabbTreeBroadPhase::CastAabb(CastDataParam data, ProxyCastResults& results)
 {
   SimpleAabbCallback callback(mCastAabbCallBack, &results);
 
-  forRangeBroadphaseTree(TreeType, mTree, Aabb, data.GetAabb()) callback.Refine(range.Front(), data);
+  forRangeWideAabbTree(mTree.GetWideTree(), Aabb, data.GetAabb()) callback.Refine(range.Front(), data);
 }
 
 void StaticAabbTreeBroadPhase::CastSphere(CastDataParam data, ProxyCastResults& results)
 {
   SimpleSphereCallback callback(mCastSphereCallBack, &results);
 
-  forRangeBroadphaseTree(TreeType, mTree, Sphere, data.GetSphere()) callback.Refine(range.Front(), data);
+  forRangeWideAabbTree(mTree.GetWideTree(), Sphere, data.GetSphere()) callback.Refine(range.Front(), data);
 }
 
 void StaticAabbTreeBroadPhase::CastFrustum(CastDataParam data, ProxyCastResults& results)
 {
   SimpleFrustumCallback callback(mCastFrustumCallBack, &results);
 
-  forRangeBroadphaseTree(TreeType, mTree, Frustum, data.GetFrustum()) callback.Refine(range.Front(), data);
+  forRangeWideAabbTree(mTree.GetWideTree(), Frustum, data.GetFrustum()) callback.Refine(range.Front(), data);
 }
 
 } // namespace Plasma
@@ -0,0 +1,156 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+/// How many children each node of a WideAabbTree has.
+const uint cWideAabbTreeWidth = 4;
+/// Set on a child reference when it refers to a leaf instead of a node.
+const uint cWideAabbTreeLeafBit = 0x80000000;
+const uint cInvalidWideAabbTreeIndex = uint(-1);
+
+/// A node of a WideAabbTree. The bounds of every child are stored as structure
+/// of arrays (one row per axis) so that one axis of all children can be tested
+/// at once. Unused children have inverted bounds so they never pass a test.
+struct WideAabbNode
+{
+  real mMin[3][cWideAabbTreeWidth];
+  real mMax[3][cWideAabbTreeWidth];
+  /// The index of each child node, or the index of the leaf with
+  /// cWideAabbTreeLeafBit set.
+  uint mChildren[cWideAabbTreeWidth];
+  uint mChildCount;
+};
+
+/// Tests a query object against all children of a wide node at once and
+/// returns a bit mask of the children it overlaps. The default tests each
+/// child's aabb with BroadPhasePolicy, the common query types have slab tests.
+template <typename QueryType>
+struct WideAabbTreePolicy
+{
+  WideAabbTreePolicy(const QueryType& queryObj);
+  uint Overlap(const WideAabbNode& node);
+
+  QueryType mQueryObj;
+};
+
+template <>
+struct WideAabbTreePolicy<Aabb>
+{
+  WideAabbTreePolicy(const Aabb& aabb);
+  uint Overlap(const WideAabbNode& node);
+
+  real mMin[3];
+  real mMax[3];
+};
+
+/// Ray and segment queries are both a slab test over an interval of t.
+struct WideAabbTreeRayPolicy
+{
+  WideAabbTreeRayPolicy(Vec3Param start, Vec3Param direction, real tMax);
+  uint Overlap(const WideAabbNode& node);
+
+  real mStart[3];
+  real mInvDirection[3];
+  /// Axes the ray is parallel to are tested by containment of the start.
+  bool mParallel[3];
+  /// Whether the ray enters an axis through the max side.
+  bool mNegative[3];
+  real mTMax;
+};
+
+template <>
+struct WideAabbTreePolicy<Ray> : public WideAabbTreeRayPolicy
+{
+  WideAabbTreePolicy(const Ray& ray);
+};
+
+template <>
+struct WideAabbTreePolicy<Segment> : public WideAabbTreeRayPolicy
+{
+  WideAabbTreePolicy(const Segment& segment);
+};
+
+template <typename ClientDataType>
+class WideAabbTree;
+
+/// A range for iterating through the leaves of a WideAabbTree that overlap a
+/// query object. The scratch buffer is used as the traversal stack (it never
+/// holds more entries than there are leaves).
+template <typename ClientDataType,
+          typename QueryType,
+          typename ArrayType = Array<uint>,
+          typename PolicyType = WideAabbTreePolicy<QueryType>>
+struct WideTreeRange
+{
+  typedef WideAabbTree<ClientDataType> TreeType;
+
+  WideTreeRange(ArrayType* scratchBuffer, TreeType* tree, const QueryType& queryObj);
+
+  void PopFront();
+  ClientDataType& Front();
+  bool Empty() const;
+
+  void SkipDead();
+
+  TreeType* mTree;
+  PolicyType mPolicy;
+  ArrayType* mScratchSpace;
+};
+
+/// A read-only tree with cWideAabbTreeWidth children per node that is collapsed
+/// from a binary AabbNode tree. Queries test all of a node's children with one
+/// lane-wise test per visit, which halves the depth of the traversal and the
+/// number of nodes touched compared to the binary tree.
+template <typename ClientDataType>
+class WideAabbTree
+{
+public:
+  typedef WideAabbTree<ClientDataType> TreeType;
+  typedef AabbNode<ClientDataType> BinaryNodeType;
+
+  WideAabbTree();
+
+  /// Rebuilds the tree from the binary tree starting at root (may be null).
+  void Build(BinaryNodeType* root);
+  void Clear();
+
+  uint GetLeafCount() const;
+  bool Empty() const;
+
+  /// Returns a range of the leaves overlapping the query object. The scratch
+  /// buffer must be able to hold GetLeafCount entries.
+  template <typename QueryType, typename ArrayType>
+  WideTreeRange<ClientDataType, QueryType, ArrayType> Query(const QueryType& queryObj, ArrayType& scratchBuffer)
+  {
+    typedef WideTreeRange<ClientDataType, QueryType, ArrayType> RangeType;
+    return RangeType(&scratchBuffer, this, queryObj);
+  }
+
+  Array<WideAabbNode> mNodes;
+  Array<ClientDataType> mLeaves;
+  uint mRoot;
+
+private:
+  /// Collects the up to cWideAabbTreeWidth binary nodes that become the
+  /// children of a wide node by opening the largest internal nodes first.
+  uint CollectChildren(BinaryNodeType* node, BinaryNodeType** children);
+  uint BuildNode(BinaryNodeType* node);
+};
+
+// Range to iterate over a query to a WideAabbTree. Same as
+// forRangeBroadphaseTree, except the traversal stack is made of node indices.
+#define forRangeWideAabbTree(tree, queryType, queryObj)                                                                \
+  Array<uint, LocalStackAllocator> wideStack_;                                                                         \
+  uint wideLeafCount_ = (tree).GetLeafCount();                                                                         \
+  LocalStackAllocator wideStackAllocator_(alloca(wideLeafCount_ * sizeof(uint)));                                      \
+  wideStack_.SetAllocator(wideStackAllocator_);                                                                        \
+  wideStack_.Reserve(wideLeafCount_);                                                                                  \
+  typedef decltype((tree).Query(queryObj, wideStack_)) _WideRangeType;                                                 \
+  _WideRangeType range = (tree).Query(queryObj, wideStack_);                                                           \
+  for (; !range.Empty(); range.PopFront())
+
+} // namespace Plasma
+
+#include "Core/SpatialPartition/WideAabbTree.inl"
@@ -0,0 +1,361 @@
+// MIT Licensed (see LICENSE.md).
+
+namespace Plasma
+{
+
+// The lane-wise tests. With sse one axis of every child is tested at once,
+// otherwise the children are looped over.
+#if defined(USESSE)
+
+inline uint WideAabbOverlapMask(const WideAabbNode& node, const real queryMin[3], const real queryMax[3])
+{
+  namespace Simd = Math::Simd;
+
+  Simd::SimVec separated = Simd::ZeroOutVec();
+  for (uint axis = 0; axis < 3; ++axis)
+  {
+    Simd::SimVec childMin = Simd::UnAlignedLoad(node.mMin[axis]);
+    Simd::SimVec childMax = Simd::UnAlignedLoad(node.mMax[axis]);
+    separated = Simd::OrVec(separated, Simd::Less(childMax, Simd::Set(queryMin[axis])));
+    separated = Simd::OrVec(separated, Simd::Greater(childMin, Simd::Set(queryMax[axis])));
+  }
+  return uint(~_mm_movemask_ps(separated)) & ((1 << node.mChildCount) - 1);
+}
+
+inline uint WideRayOverlapMask(const WideAabbNode& node, const WideAabbTreeRayPolicy& ray)
+{
+  namespace Simd = Math::Simd;
+
+  Simd::SimVec tMin = Simd::ZeroOutVec();
+  Simd::SimVec tMax = Simd::Set(ray.mTMax);
+  for (uint axis = 0; axis < 3; ++axis)
+  {
+    Simd::SimVec childMin = Simd::UnAlignedLoad(node.mMin[axis]);
+    Simd::SimVec childMax = Simd::UnAlignedLoad(node.mMax[axis]);
+    Simd::SimVec start = Simd::Set(ray.mStart[axis]);
+
+    if (ray.mParallel[axis])
+    {
+      // Children whose slab doesn't contain the start get an empty interval
+      Simd::SimVec outside = Simd::OrVec(Simd::Less(start, childMin), Simd::Greater(start, childMax));
+      tMax = Simd::Select(tMax, Simd::Set(real(-1.0)), outside);
+      continue;
+    }
+
+    Simd::SimVec nearPlane = ray.mNegative[axis] ? childMax : childMin;
+    Simd::SimVec farPlane = ray.mNegative[axis] ? childMin : childMax;
+    Simd::SimVec invDirection = Simd::Set(ray.mInvDirection[axis]);
+    tMin = Simd::Max(tMin, Simd::Multiply(Simd::Subtract(nearPlane, start), invDirection));
+    tMax = Simd::Min(tMax, Simd::Multiply(Simd::Subtract(farPlane, start), invDirection));
+  }
+  return uint(_mm_movemask_ps(Simd::LessEqual(tMin, tMax))) & ((1 << node.mChildCount) - 1);
+}
+
+#else
+
+inline uint WideAabbOverlapMask(const WideAabbNode& node, const real queryMin[3], const real queryMax[3])
+{
+  bool separated[cWideAabbTreeWidth] = {};
+  for (uint axis = 0; axis < 3; ++axis)
+  {
+    for (uint i = 0; i < cWideAabbTreeWidth; ++i)
+      separated[i] |= (node.mMax[axis][i] < queryMin[axis]) | (node.mMin[axis][i] > queryMax[axis]);
+  }
+
+  uint mask = 0;
+  for (uint i = 0; i < node.mChildCount; ++i)
+    mask |= uint(!separated[i]) << i;
+  return mask;
+}
+
+inline uint WideRayOverlapMask(const WideAabbNode& node, const WideAabbTreeRayPolicy& ray)
+{
+  real tMin[cWideAabbTreeWidth] = {};
+  real tMax[cWideAabbTreeWidth];
+  for (uint i = 0; i < cWideAabbTreeWidth; ++i)
+    tMax[i] = ray.mTMax;
+
+  for (uint axis = 0; axis < 3; ++axis)
+  {
+    const real* childMin = node.mMin[axis];
+    const real* childMax = node.mMax[axis];
+    real start = ray.mStart[axis];
+
+    if (ray.mParallel[axis])
+    {
+      // Children whose slab doesn't contain the start get an empty interval
+      for (uint i = 0; i < cWideAabbTreeWidth; ++i)
+      {
+        if (start < childMin[i] || start > childMax[i])
+          tMax[i] = real(-1.0);
+      }
+      continue;
+    }
+
+    const real* nearPlane = ray.mNegative[axis] ? childMax : childMin;
+    const real* farPlane = ray.mNegative[axis] ? childMin : childMax;
+    real invDirection = ray.mInvDirection[axis];
+    for (uint i = 0; i < cWideAabbTreeWidth; ++i)
+    {
+      tMin[i] = Math::Max(tMin[i], (nearPlane[i] - start) * invDirection);
+      tMax[i] = Math::Min(tMax[i], (farPlane[i] - start) * invDirection);
+    }
+  }
+
+  uint mask = 0;
+  for (uint i = 0; i < node.mChildCount; ++i)
+    mask |= uint(tMin[i] <= tMax[i]) << i;
+  return mask;
+}
+
+#endif
+
+template <typename QueryType>
+WideAabbTreePolicy<QueryType>::WideAabbTreePolicy(const QueryType& queryObj) : mQueryObj(queryObj)
+{
+}
+
+template <typename QueryType>
+uint WideAabbTreePolicy<QueryType>::Overlap(const WideAabbNode& node)
+{
+  BroadPhasePolicy<QueryType, Aabb> policy;
+
+  uint mask = 0;
+  for (uint i = 0; i < node.mChildCount; ++i)
+  {
+    Aabb aabb(Vec3(node.mMin[0][i], node.mMin[1][i], node.mMin[2][i]),
+              Vec3(node.mMax[0][i], node.mMax[1][i], node.mMax[2][i]));
+    if (policy.Overlap(mQueryObj, aabb))
+      mask |= 1 << i;
+  }
+  return mask;
+}
+
+inline WideAabbTreePolicy<Aabb>::WideAabbTreePolicy(const Aabb& aabb)
+{
+  for (uint axis = 0; axis < 3; ++axis)
+  {
+    mMin[axis] = aabb.mMin[axis];
+    mMax[axis] = aabb.mMax[axis];
+  }
+}
+
+inline uint WideAabbTreePolicy<Aabb>::Overlap(const WideAabbNode& node)
+{
+  return WideAabbOverlapMask(node, mMin, mMax);
+}
+
+inline WideAabbTreeRayPolicy::WideAabbTreeRayPolicy(Vec3Param start, Vec3Param direction, real tMax)
+{
+  mTMax = tMax;
+  for (uint axis = 0; axis < 3; ++axis)
+  {
+    mStart[axis] = start[axis];
+    // Same as Intersection::RayAabb, an axis is treated as parallel when the
+    // direction is zero on it.
+    mParallel[axis] = Math::IsZero(direction[axis]);
+    mNegative[axis] = direction[axis] < real(0.0);
+    mInvDirection[axis] = mParallel[axis] ? real(0.0) : real(1.0) / direction[axis];
+  }
+}
+
+inline uint WideAabbTreeRayPolicy::Overlap(const WideAabbNode& node)
+{
+  return WideRayOverlapMask(node, *this);
+}
+
+inline WideAabbTreePolicy<Ray>::WideAabbTreePolicy(const Ray& ray) :
+    WideAabbTreeRayPolicy(ray.Start, ray.Direction, Math::PositiveMax())
+{
+}
+
+inline WideAabbTreePolicy<Segment>::WideAabbTreePolicy(const Segment& segment) :
+    WideAabbTreeRayPolicy(segment.Start, segment.End - segment.Start, real(1.0))
+{
+}
+
+template <typename ClientDataType, typename QueryType, typename ArrayType, typename PolicyType>
+WideTreeRange<ClientDataType, QueryType, ArrayType, PolicyType>::WideTreeRange(ArrayType* scratchBuffer,
+                                                                               TreeType* tree,
+                                                                               const QueryType& queryObj) :
+    mTree(tree),
+    mPolicy(queryObj),
+    mScratchSpace(scratchBuffer)
+{
+  mScratchSpace->Clear();
+  if (tree->mRoot != cInvalidWideAabbTreeIndex)
+    mScratchSpace->PushBack(tree->mRoot);
+  SkipDead();
+}
+
+template <typename ClientDataType, typename QueryType, typename ArrayType, typename PolicyType>
+void WideTreeRange<ClientDataType, QueryType, ArrayType, PolicyType>::PopFront()
+{
+  mScratchSpace->PopBack();
+  SkipDead();
+}
+
+template <typename ClientDataType, typename QueryType, typename ArrayType, typename PolicyType>
+ClientDataType& WideTreeRange<ClientDataType, QueryType, ArrayType, PolicyType>::Front()
+{
+  ErrorIf(mScratchSpace->Empty(), "Cannot get the front of an empty range.");
+  return mTree->mLeaves[mScratchSpace->Back() & ~cWideAabbTreeLeafBit];
+}
+
+template <typename ClientDataType, typename QueryType, typename ArrayType, typename PolicyType>
+bool WideTreeRange<ClientDataType, QueryType, ArrayType, PolicyType>::Empty() const
+{
+  return mScratchSpace->Empty();
+}
+
+template <typename ClientDataType, typename QueryType, typename ArrayType, typename PolicyType>
+void WideTreeRange<ClientDataType, QueryType, ArrayType, PolicyType>::SkipDead()
+{
+  ArrayType& stack = *mScratchSpace;
+  while (!stack.Empty())
+  {
+    // Leaves are only pushed once their bounds passed, so they can be returned
+    uint child = stack.Back();
+    if (child & cWideAabbTreeLeafBit)
+      return;
+
+    stack.PopBack();
+    const WideAabbNode& node = mTree->mNodes[child];
+    uint mask = mPolicy.Overlap(node);
+
+    // Push in reverse so the first child is visited first
+    for (uint i = node.mChildCount; i > 0; --i)
+    {
+      if (mask & (1 << (i - 1)))
+        stack.PushBack(node.mChildren[i - 1]);
+    }
+  }
+}
+
+template <typename ClientDataType>
+WideAabbTree<ClientDataType>::WideAabbTree()
+{
+  mRoot = cInvalidWideAabbTreeIndex;
+}
+
+template <typename ClientDataType>
+void WideAabbTree<ClientDataType>::Build(BinaryNodeType* root)
+{
+  Clear();
+  if (root == nullptr)
+    return;
+
+  mRoot = BuildNode(root);
+}
+
+template <typename ClientDataType>
+void WideAabbTree<ClientDataType>::Clear()
+{
+  mNodes.Clear();
+  mLeaves.Clear();
+  mRoot = cInvalidWideAabbTreeIndex;
+}
+
+template <typename ClientDataType>
+uint WideAabbTree<ClientDataType>::GetLeafCount() const
+{
+  return mLeaves.Size();
+}
+
+template <typename ClientDataType>
+bool WideAabbTree<ClientDataType>::Empty() const
+{
+  return mRoot == cInvalidWideAabbTreeIndex;
+}
+
+template <typename ClientDataType>
+uint WideAabbTree<ClientDataType>::CollectChildren(BinaryNodeType* node, BinaryNodeType** children)
+{
+  // A leaf root still needs a node to hold its bounds
+  if (node->IsLeaf())
+  {
+    children[0] = node;
+    return 1;
+  }
+
+  uint count = 2;
+  children[0] = node->mChild1;
+  children[1] = node->mChild2;
+  while (count < cWideAabbTreeWidth)
+  {
+    // Open the internal child with the largest surface area since it is the
+    // most likely to be hit by a query
+    uint largest = cInvalidWideAabbTreeIndex;
+    real largestArea = -Math::PositiveMax();
+    for (uint i = 0; i < count; ++i)
+    {
+      if (children[i]->IsLeaf())
+        continue;
+
+      real area = children[i]->mAabb.GetSurfaceArea();
+      if (area > largestArea)
+      {
+        largest = i;
+        largestArea = area;
+      }
+    }
+
+    if (largest == cInvalidWideAabbTreeIndex)
+      break;
+
+    BinaryNodeType* opened = children[largest];
+    children[largest] = opened->mChild1;
+    children[count++] = opened->mChild2;
+  }
+  return count;
+}
+
+template <typename ClientDataType>
+uint WideAabbTree<ClientDataType>::BuildNode(BinaryNodeType* node)
+{
+  BinaryNodeType* children[cWideAabbTreeWidth];
+  uint childCount = CollectChildren(node, children);
+
+  // Allocate the node before its children so that a node's
+  // subtree follows it in memory (depth first order)
+  uint nodeIndex = mNodes.Size();
+  WideAabbNode& wideNode = mNodes.PushBack();
+  wideNode.mChildCount = childCount;
+  for (uint i = 0; i < cWideAabbTreeWidth; ++i)
+  {
+    // Inverted bounds so that unused children never overlap anything
+    for (uint axis = 0; axis < 3; ++axis)
+    {
+      wideNode.mMin[axis][i] = Math::PositiveMax();
+      wideNode.mMax[axis][i] = -Math::PositiveMax();
+    }
+    wideNode.mChildren[i] = cInvalidWideAabbTreeIndex;
+  }
+
+  for (uint i = 0; i < childCount; ++i)
+  {
+    BinaryNodeType* child = children[i];
+    uint childIndex;
+    if (child->IsLeaf())
+    {
+      childIndex = mLeaves.Size() | cWideAabbTreeLeafBit;
+      mLeaves.PushBack(child->mClientData);
+    }
+    else
+    {
+      childIndex = BuildNode(child);
+    }
+
+    // Building the child may have grown the node array
+    WideAabbNode& current = mNodes[nodeIndex];
+    current.mChildren[i] = childIndex;
+    for (uint axis = 0; axis < 3; ++axis)
+    {
+      current.mMin[axis][i] = child->mAabb.mMin[axis];
+      current.mMax[axis][i] = child->mAabb.mMax[axis];
+    }
+  }
+  return nodeIndex;
+}
+
+} // namespace Plasma
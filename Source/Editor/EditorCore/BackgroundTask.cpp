@@ -124,7 +124,9 @@ void BackgroundTask::Execute()
 
 void BackgroundTask::OnEngineUpdate(UpdateEvent* event)
 {
-  // Pass the task off to the job system
+  // Pass the task off to the job system (background tasks are long running
+  // imports/builds, so let anything latency sensitive go first)
+  mJob->mPriority = JobPriority::Low;
   PL::gJobs->AddJob(mJob);
 
   // Disconnect from this event so we don't do it again.
@@ -122,7 +122,7 @@ void Graphical::Detached(AttachmentInfo& info)
   UpdateBroadPhaseAabb();
 }
 
-void Graphical::MidPhaseQuery(Array<GraphicalEntry>& entries, Camera& camera, Frustum* frustum)
+void Graphical::MidPhaseQuery(FrameGraphicalEntryArray& entries, Camera& camera, Frustum* frustum)
 {
   mGraphicalEntryData.mGraphical = this;
   mGraphicalEntryData.mFrameNodeIndex = -1;
@@ -60,7 +60,7 @@ public:
   virtual Aabb GetLocalAabb() = 0;
   virtual void ExtractFrameData(FrameNode& frameNode, FrameBlock& frameBlock) = 0;
   virtual void ExtractViewData(ViewNode& viewNode, ViewBlock& viewBlock, FrameBlock& frameBlock) = 0;
-  virtual void MidPhaseQuery(Array<GraphicalEntry>& entries, Camera& camera, Frustum* frustum);
+  virtual void MidPhaseQuery(FrameGraphicalEntryArray& entries, Camera& camera, Frustum* frustum);
   virtual bool TestRay(GraphicsRayCast& rayCast, CastInfo& castInfo);
   virtual bool TestFrustum(const Frustum& frustum, CastInfo& castInfo);
   virtual void AddToSpace();
@@ -58,6 +58,8 @@ public:
 };
 
 typedef Array<GraphicalEntry>::range GraphicalEntryRange;
+// Entries gathered by Graphical::MidPhaseQuery, only valid for the current frame.
+typedef Array<GraphicalEntry, FrameAllocator> FrameGraphicalEntryArray;
 
 /// Sent for RenderGroups that require custom logic for sort values.
 class GraphicalSortEvent : public Event
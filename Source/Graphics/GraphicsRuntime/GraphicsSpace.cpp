@@ -258,7 +258,7 @@ void GraphicsSpace::RenderQueuesUpdate(RenderTasks& renderTasks, RenderQueues& r
     camera.GetViewData(viewBlock);
 
     uint totalViewNodesNeeded = 0;
-    Array<IndexRange> groupRanges;
+    Array<IndexRange, FrameAllocator> groupRanges;
     size_t indexRangeIndex = 0;
     IndexRange indexRange(0, 0);
     if (camera.mGraphicalIndexRanges.Size())
@@ -396,7 +396,7 @@ void GraphicsSpace::AddToVisibleGraphicals(
 
   graphical.mVisibleFlags.SetFlag(camera.mVisibilityId);
 
-  Array<GraphicalEntry> entries;
+  FrameGraphicalEntryArray entries;
   graphical.MidPhaseQuery(entries, camera, frustum);
   forRange (GraphicalEntry& entry, entries.All())
   {
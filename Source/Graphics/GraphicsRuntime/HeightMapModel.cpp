@@ -119,7 +119,7 @@ namespace Plasma
         viewNode.mLocalToPerspective = viewBlock.mViewToPerspective * viewNode.mLocalToView;
     }
 
-    void HeightMapModel::MidPhaseQuery(Array<GraphicalEntry>& entries, Camera& camera, Frustum* frustum)
+    void HeightMapModel::MidPhaseQuery(FrameGraphicalEntryArray& entries, Camera& camera, Frustum* frustum)
     {
         typedef HashMap<HeightPatch*, GraphicalHeightPatch>::pair GraphicalPatchPair;
         if (frustum == nullptr)
@@ -166,7 +166,7 @@ namespace Plasma
         return "DefaultHeightMapMaterial";
     }
 
-    void HeightMapModel::AddGraphicalPatchEntry(Array<GraphicalEntry>& entries,
+    void HeightMapModel::AddGraphicalPatchEntry(FrameGraphicalEntryArray& entries,
                                                 GraphicalHeightPatch& graphicalPatch,
                                                 PatchIndex index)
     {
@@ -50,13 +50,13 @@ public:
   Aabb GetLocalAabb() override;
   void ExtractFrameData(FrameNode& frameNode, FrameBlock& frameBlock) override;
   void ExtractViewData(ViewNode& viewNode, ViewBlock& viewBlock, FrameBlock& frameBlock) override;
-  void MidPhaseQuery(Array<GraphicalEntry>& entries, Camera& camera, Frustum* frustum) override;
+  void MidPhaseQuery(FrameGraphicalEntryArray& entries, Camera& camera, Frustum* frustum) override;
   bool TestRay(GraphicsRayCast& rayCast, CastInfo& castInfo) override;
   String GetDefaultMaterialName() override;
 
   // Internal
 
-  void AddGraphicalPatchEntry(Array<GraphicalEntry>& entries, GraphicalHeightPatch& graphicalPatch, PatchIndex index);
+  void AddGraphicalPatchEntry(FrameGraphicalEntryArray& entries, GraphicalHeightPatch& graphicalPatch, PatchIndex index);
 
   void OnPatchAdded(HeightMapEvent* event);
   void OnPatchRemoved(HeightMapEvent* event);
@@ -427,6 +427,7 @@ void RenderTasksEvent::AddRenderTaskRenderPass(GraphicsRenderSettings& renderSet
   IndexRange indexRange;
   indexRange.start = mGraphicsSpace->mVisibleGraphicals.Size();
 
+  FrameGraphicalEntryArray entries;
   forRange (Graphical* graphical, graphicalRange.mGraphicals.All())
   {
     // Do not allow a graphical from a different space
@@ -435,7 +436,9 @@ void RenderTasksEvent::AddRenderTaskRenderPass(GraphicsRenderSettings& renderSet
 
     // No sort values are needed, these entries are to be rendered in the order
     // given
-    graphical->MidPhaseQuery(mGraphicsSpace->mVisibleGraphicals, *mCamera, nullptr);
+    graphical->MidPhaseQuery(entries, *mCamera, nullptr);
+    mGraphicsSpace->mVisibleGraphicals.Append(entries.All());
+    entries.Clear();
     materials.Insert(graphical->mMaterial);
   }
 
@@ -106,7 +106,7 @@ void SelectionIcon::ExtractViewData(ViewNode& viewNode, ViewBlock& viewBlock, Fr
   frameBlock.mRenderQueues->AddStreamedQuad(viewNode, pos0, pos1, uv0, uv1, Vec4(1.0f), uvAux0, uvAux1);
 }
 
-void SelectionIcon::MidPhaseQuery(Array<GraphicalEntry>& entries, Camera& camera, Frustum* frustum)
+void SelectionIcon::MidPhaseQuery(FrameGraphicalEntryArray& entries, Camera& camera, Frustum* frustum)
 {
   mGraphicalEntryData.mGraphical = this;
   mGraphicalEntryData.mFrameNodeIndex = -1;
@@ -26,7 +26,7 @@ public:
   Aabb GetLocalAabb() override;
   void ExtractFrameData(FrameNode& frameNode, FrameBlock& frameBlock) override;
   void ExtractViewData(ViewNode& viewNode, ViewBlock& viewBlock, FrameBlock& frameBlock) override;
-  void MidPhaseQuery(Array<GraphicalEntry>& entries, Camera& camera, Frustum* frustum) override;
+  void MidPhaseQuery(FrameGraphicalEntryArray& entries, Camera& camera, Frustum* frustum) override;
   bool TestRay(GraphicsRayCast& rayCast, CastInfo& castInfo) override;
   bool TestFrustum(const Frustum& frustum, CastInfo& castInfo) override;
   void AddToSpace() override;
@@ -98,7 +98,15 @@ void Sprite::Initialize(CogInitializer& initializer)
   mCurrentFrame = mStartFrame;
   mFrameTime = 0.0f;
 
-  ConnectThisTo(GetSpace(), Events::LogicUpdate, OnLogicUpdate);
+  // Animating only touches this sprite, so sprites can be updated in parallel
+  GetSpace()->mLogicUpdates.Add<Sprite, &Sprite::OnLogicUpdate>(this, true);
+}
+
+void Sprite::OnDestroy(uint flags)
+{
+  if (Space* space = GetSpace())
+    space->mLogicUpdates.Remove(this);
+  BaseSprite::OnDestroy(flags);
 }
 
 void Sprite::DebugDraw()
@@ -665,7 +673,7 @@ void MultiSprite::ExtractViewData(ViewNode& viewNode, ViewBlock& viewBlock, Fram
   }
 }
 
-void MultiSprite::MidPhaseQuery(Array<GraphicalEntry>& entries, Camera& camera, Frustum* frustum)
+void MultiSprite::MidPhaseQuery(FrameGraphicalEntryArray& entries, Camera& camera, Frustum* frustum)
 {
   CogId cameraId = camera.GetOwner()->GetId();
 
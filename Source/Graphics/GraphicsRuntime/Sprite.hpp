@@ -47,6 +47,7 @@ public:
 
   void Serialize(Serializer& stream) override;
   void Initialize(CogInitializer& initializer) override;
+  void OnDestroy(uint flags = 0) override;
   void DebugDraw() override;
 
   // Graphical Interface
@@ -229,7 +230,7 @@ public:
   Aabb GetLocalAabb() override;
   void ExtractFrameData(FrameNode& frameNode, FrameBlock& frameBlock) override;
   void ExtractViewData(ViewNode& viewNode, ViewBlock& viewBlock, FrameBlock& frameBlock) override;
-  void MidPhaseQuery(Array<GraphicalEntry>& entries, Camera& camera, Frustum* frustum) override;
+  void MidPhaseQuery(FrameGraphicalEntryArray& entries, Camera& camera, Frustum* frustum) override;
   bool TestRay(GraphicsRayCast& rayCast, CastInfo& castInfo) override;
 
   // Properties
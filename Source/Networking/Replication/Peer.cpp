@@ -56,9 +56,7 @@ Peer::Peer(ProcessReceivedCustomPacketFn processReceivedCustomPacketFn,
 
     /// Packet Data
     mIpv4RawPackets(),
-    mIpv4RawPacketsLock(),
     mIpv6RawPackets(),
-    mIpv6RawPacketsLock(),
     mSendBitStream(),
     mReceiveStatsLock(),
     mReleasedCustomPackets(),
@@ -909,13 +907,8 @@ OsInt Peer::Ipv4ReceiveThreadFn()
       {
         Assert(rawPacket.mIpAddress.IsValid());
 
-        { //<>-<>-<>-<>-< IPv4 Raw Packets Locked >-<>-<>-<>-<>-
-          Lock lock(mIpv4RawPacketsLock);
-
-          // Push raw packet copy
-          mIpv4RawPackets.PushBack(rawPacket);
-
-        } //-<>-<>-<>-<>-< IPv4 Raw Packets Unlocked >-<>-<>-<>-<>
+        // Push raw packet copy
+        mIpv4RawPackets.Push(rawPacket);
 
         // Update stats
         UpdateReceiveStats(result);
@@ -962,13 +955,8 @@ OsInt Peer::Ipv6ReceiveThreadFn()
       {
         Assert(rawPacket.mIpAddress.IsValid());
 
-        { //<>-<>-<>-<>-< IPv6 Raw Packets Locked >-<>-<>-<>-<>-
-          Lock lock(mIpv6RawPacketsLock);
-
-          // Push raw packet copy
-          mIpv6RawPackets.PushBack(rawPacket);
-
-        } //-<>-<>-<>-<>-< IPv6 Raw Packets Unlocked >-<>-<>-<>-<>
+        // Push raw packet copy
+        mIpv6RawPackets.Push(rawPacket);
 
         // Update stats
         UpdateReceiveStats(result);
@@ -1111,13 +1099,8 @@ void Peer::UpdatePeerState()
   // Translate Raw IPv4 Packets
   //
   Assert(rawPackets.Empty());
-  { //<>-<>-<>-<>-< IPv4 Raw Packets Locked >-<>-<>-<>-<>-
-    Lock lock(mIpv4RawPacketsLock);
-
-    // Get raw IPv4 packets
-    rawPackets.Swap(mIpv4RawPackets);
-
-  } //-<>-<>-<>-<>-< IPv4 Raw Packets Unlocked >-<>-<>-<>-<>
+  // Get raw IPv4 packets
+  mIpv4RawPackets.Drain(rawPackets);
 
   // Translate raw IPv4 packets
   TranslateRawPackets(rawPackets, inPackets);
@@ -1126,13 +1109,8 @@ void Peer::UpdatePeerState()
   // Translate Raw IPv6 Packets
   //
   Assert(rawPackets.Empty());
-  { //<>-<>-<>-<>-< IPv6 Raw Packets Locked >-<>-<>-<>-<>-
-    Lock lock(mIpv6RawPacketsLock);
-
-    // Get raw IPv6 packets
-    rawPackets.Swap(mIpv6RawPackets);
-
-  } //-<>-<>-<>-<>-< IPv6 Raw Packets Unlocked >-<>-<>-<>-<>
+  // Get raw IPv6 packets
+  mIpv6RawPackets.Drain(rawPackets);
 
   // Translate raw IPv6 packets
   TranslateRawPackets(rawPackets, inPackets);
@@ -327,10 +327,8 @@ public:
   uint64 mLocalFrameId; /// Local update frame ID
 
   /// Packet Data
-  Array<RawPacket> mIpv4RawPackets;              /// Raw incoming IPv4 packets
-  mutable ThreadLock mIpv4RawPacketsLock;        /// Raw incoming IPv4 packets thread lock
-  Array<RawPacket> mIpv6RawPackets;              /// Raw incoming IPv6 packets
-  mutable ThreadLock mIpv6RawPacketsLock;        /// Raw incoming IPv6 packets thread lock
+  MpscQueue<RawPacket> mIpv4RawPackets;          /// Raw incoming IPv4 packets
+  MpscQueue<RawPacket> mIpv6RawPackets;          /// Raw incoming IPv6 packets
   BitStream mSendBitStream;                      /// Reusable outgoing packet bitstream
   mutable ThreadLock mReceiveStatsLock;          /// Receive stats thread lock
   Array<InPacket> mReleasedCustomPackets;        /// Released incoming user packets
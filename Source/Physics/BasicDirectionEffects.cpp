@@ -118,6 +118,17 @@ void ForceEffect::ApplyEffect(RigidBody* obj, real dt)
   obj->ApplyForceNoWakeUp(force);
 }
 
+void ForceEffect::ApplyEffect(Physics::BodyStateArrays& bodies, real dt)
+{
+  if(!GetActive())
+    return;
+
+  uint start = 0;
+  uint end = 0;
+  while(GetNextAffectedRange(bodies, start, end))
+    bodies.AddForces(start, end, mWorldForce);
+}
+
 //-------------------------------------------------------------------GravityEffect
  LightningDefineType(GravityEffect, builder, type)
 {
@@ -143,6 +154,18 @@ void GravityEffect::ApplyEffect(RigidBody* obj, real dt)
   obj->ApplyForceNoWakeUp(force);
 }
 
+void GravityEffect::ApplyEffect(Physics::BodyStateArrays& bodies, real dt)
+{
+  if(!GetActive())
+    return;
+
+  // Same as Mass::ApplyInverted (axes with no mass get the acceleration as the force)
+  uint start = 0;
+  uint end = 0;
+  while(GetNextAffectedRange(bodies, start, end))
+    bodies.AddAccelerations(start, end, mWorldForce);
+}
+
 void GravityEffect::ApplyEffect(SpringSystem* obj, real dt)
 {
   if(!GetActive())
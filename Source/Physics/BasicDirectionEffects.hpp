@@ -64,6 +64,7 @@ public:
 
   // PhysicsEffect Interface
   void ApplyEffect(RigidBody* obj, real dt) override;
+  void ApplyEffect(Physics::BodyStateArrays& bodies, real dt) override;
 };
 
 //-------------------------------------------------------------------GravityEffect
@@ -80,6 +81,7 @@ public:
   // PhysicsEffect Interface
   void ApplyEffect(RigidBody* obj, real dt) override;
   void ApplyEffect(SpringSystem* obj, real dt) override;
+  void ApplyEffect(Physics::BodyStateArrays& bodies, real dt) override;
 };
 
 }//namespace Plasma
@@ -0,0 +1,328 @@
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+//Fewer bodies than this are integrated on the calling thread.
+const uint cMinParallelIntegrationBodies = 512;
+
+//Runs one of the integration loops over chunks of the bodies (used with JobSystem::ParallelFor).
+struct BodyIntegrator
+{
+  void operator()(uint begin, uint end)
+  {
+    for(uint chunkIndex = begin; chunkIndex < end; ++chunkIndex)
+    {
+      uint start = (uint)((u64)mBodyCount * chunkIndex / mChunkCount);
+      uint stop = (uint)((u64)mBodyCount * (chunkIndex + 1) / mChunkCount);
+      if(mPositions)
+        mStates->IntegratePositions(start, stop, mDt);
+      else
+        mStates->IntegrateVelocities(start, stop, mDt, mMaxVelocity);
+    }
+  }
+
+  BodyStateArrays* mStates;
+  uint mBodyCount;
+  uint mChunkCount;
+  real mDt;
+  real mMaxVelocity;
+  bool mPositions;
+};
+
+//How many reals the effect kernels process per block (cSimdLaneCount Vec3s).
+const uint cVec3LaneBlock = 3 * cSimdLaneCount;
+
+//The components of a Vec3 array from the given index on as a flat array of reals.
+real* GetComponents(Array<Vec3>& vectors, uint index)
+{
+  static_assert(sizeof(Vec3) == 3 * sizeof(real), "Vec3 must be tightly packed");
+  return vectors.Data()[index].array;
+}
+
+//Splits a vector into the three lane values that line up with a block of
+//cSimdLaneCount consecutive Vec3s (x,y,z,x | y,z,x,y | z,x,y,z).
+void SplatVec3Lanes(Vec3Param vector, LaneValue lanes[3])
+{
+  static_assert(cSimdLaneCount == 4, "The Vec3 lane patterns assume 4 lanes");
+  lanes[0] = SetLanes(vector.x, vector.y, vector.z, vector.x);
+  lanes[1] = SetLanes(vector.y, vector.z, vector.x, vector.y);
+  lanes[2] = SetLanes(vector.z, vector.x, vector.y, vector.z);
+}
+
+void RunBodyIntegrator(BodyIntegrator& integrator)
+{
+  uint workerCount = PL::gJobs->GetWorkerCount();
+  if(workerCount == 0 || integrator.mBodyCount < cMinParallelIntegrationBodies)
+  {
+    integrator.mChunkCount = 1;
+    integrator(0, 1);
+    return;
+  }
+
+  uint maxChunkCount = JobSystem::cMaxParallelTasks;
+  uint bodyChunkCount = integrator.mBodyCount / (cMinParallelIntegrationBodies / 4);
+  integrator.mChunkCount = Math::Min(Math::Min((workerCount + 1) * 4, bodyChunkCount), maxChunkCount);
+  PL::gJobs->ParallelFor(0, integrator.mChunkCount, integrator, 1);
+}
+
+void BodyStateArrays::Clear()
+{
+  mBodies.Clear();
+  mVelocities.Clear();
+  mAngularVelocities.Clear();
+  mForces.Clear();
+  mTorques.Clear();
+  mInvMasses.Clear();
+  mMasses.Clear();
+  mInvWorldInertias.Clear();
+  mInvModelInertias.Clear();
+  mCentersOfMass.Clear();
+  mRotations.Clear();
+  mMode2D.Clear();
+  mEffectsToIgnore.Clear();
+}
+
+uint BodyStateArrays::Size() const
+{
+  return mBodies.Size();
+}
+
+void BodyStateArrays::AddVelocityState(RigidBody* body)
+{
+  bool mode2D = body->mState.IsSet(RigidBodyStates::Mode2D);
+  //deal with the case of applying velocity outside of 2d mode that isn't
+  //handled by the mass being zeroed (see Integration::IntegrateVelocity)
+  if(mode2D)
+  {
+    body->mVelocity.z = real(0.0);
+    body->mAngularVelocity.x = real(0.0);
+    body->mAngularVelocity.y = real(0.0);
+  }
+
+  mBodies.PushBack(body);
+  mVelocities.PushBack(body->mVelocity);
+  mAngularVelocities.PushBack(body->mAngularVelocity);
+  mForces.PushBack(body->mForceAccumulator);
+  mTorques.PushBack(body->mTorqueAccumulator);
+  mInvMasses.PushBack(body->mInvMass.GetInvMasses());
+  mMasses.PushBack(body->mInvMass.ApplyInverted(Vec3(real(1.0), real(1.0), real(1.0))));
+  mInvWorldInertias.PushBack(body->mInvInertia.GetInvWorldTensor());
+  mInvModelInertias.PushBack(body->mInvInertia.GetInvModelTensor());
+  mRotations.PushBack(body->mRotationQuat);
+  mMode2D.PushBack(mode2D);
+  mEffectsToIgnore.PushBack(body->mSpaceEffectsToIgnore);
+}
+
+void BodyStateArrays::AddPositionState(RigidBody* body)
+{
+  mBodies.PushBack(body);
+  mVelocities.PushBack(body->mVelocity);
+  mAngularVelocities.PushBack(body->mAngularVelocity);
+  mForces.PushBack(body->mForceAccumulator);
+  mInvMasses.PushBack(body->mInvMass.GetInvMasses());
+  mCentersOfMass.PushBack(body->mCenterOfMass);
+  mRotations.PushBack(body->mRotationQuat);
+}
+
+void BodyStateArrays::AddForces(uint start, uint end, Vec3Param force)
+{
+  if(start >= end)
+    return;
+
+  real* forces = GetComponents(mForces, start);
+  uint count = (end - start) * 3;
+  LaneValue forceLanes[3];
+  SplatVec3Lanes(force, forceLanes);
+
+  uint i = 0;
+  for(; i + cVec3LaneBlock <= count; i += cVec3LaneBlock)
+  {
+    for(uint lane = 0; lane < 3; ++lane)
+    {
+      real* values = forces + i + lane * cSimdLaneCount;
+      StoreLanes(AddLanes(LoadLanes(values), forceLanes[lane]), values);
+    }
+  }
+  //blocks start on a body so the rest line up with the vector's axes
+  for(; i < count; ++i)
+    forces[i] += force[i % 3];
+}
+
+void BodyStateArrays::AddAccelerations(uint start, uint end, Vec3Param acceleration)
+{
+  if(start >= end)
+    return;
+
+  real* forces = GetComponents(mForces, start);
+  real* masses = GetComponents(mMasses, start);
+  uint count = (end - start) * 3;
+  LaneValue accelerationLanes[3];
+  SplatVec3Lanes(acceleration, accelerationLanes);
+
+  uint i = 0;
+  for(; i + cVec3LaneBlock <= count; i += cVec3LaneBlock)
+  {
+    for(uint lane = 0; lane < 3; ++lane)
+    {
+      uint offset = i + lane * cSimdLaneCount;
+      LaneValue force = MultiplyAddLanes(accelerationLanes[lane], LoadLanes(masses + offset), LoadLanes(forces + offset));
+      StoreLanes(force, forces + offset);
+    }
+  }
+  for(; i < count; ++i)
+    forces[i] += acceleration[i % 3] * masses[i];
+}
+
+void BodyStateArrays::AddLinearDrag(uint start, uint end, real drag, real damping)
+{
+  if(start >= end)
+    return;
+
+  real* forces = GetComponents(mForces, start);
+  real* velocities = GetComponents(mVelocities, start);
+  real* masses = GetComponents(mMasses, start);
+  uint count = (end - start) * 3;
+  LaneValue dragLanes = SplatLanes(drag);
+  LaneValue dampingLanes = SplatLanes(damping);
+
+  uint i = 0;
+  for(; i + cSimdLaneCount <= count; i += cSimdLaneCount)
+  {
+    LaneValue scale = MultiplyAddLanes(dampingLanes, LoadLanes(masses + i), dragLanes);
+    LaneValue force = SubtractLanes(LoadLanes(forces + i), MultiplyLanes(LoadLanes(velocities + i), scale));
+    StoreLanes(force, forces + i);
+  }
+  for(; i < count; ++i)
+    forces[i] -= velocities[i] * (drag + damping * masses[i]);
+}
+
+void BodyStateArrays::AddAngularDrag(uint start, uint end, real drag)
+{
+  if(start >= end)
+    return;
+
+  real* torques = GetComponents(mTorques, start);
+  real* angularVelocities = GetComponents(mAngularVelocities, start);
+  uint count = (end - start) * 3;
+  LaneValue dragLanes = SplatLanes(drag);
+
+  uint i = 0;
+  for(; i + cSimdLaneCount <= count; i += cSimdLaneCount)
+  {
+    LaneValue torque = SubtractLanes(LoadLanes(torques + i), MultiplyLanes(LoadLanes(angularVelocities + i), dragLanes));
+    StoreLanes(torque, torques + i);
+  }
+  for(; i < count; ++i)
+    torques[i] -= angularVelocities[i] * drag;
+}
+
+void BodyStateArrays::IntegrateVelocities(real dt, real maxVelocity)
+{
+  BodyIntegrator integrator;
+  integrator.mStates = this;
+  integrator.mBodyCount = Size();
+  integrator.mDt = dt;
+  integrator.mMaxVelocity = maxVelocity;
+  integrator.mPositions = false;
+  RunBodyIntegrator(integrator);
+}
+
+void BodyStateArrays::IntegratePositions(real dt)
+{
+  BodyIntegrator integrator;
+  integrator.mStates = this;
+  integrator.mBodyCount = Size();
+  integrator.mDt = dt;
+  integrator.mMaxVelocity = real(0.0);
+  integrator.mPositions = true;
+  RunBodyIntegrator(integrator);
+}
+
+void BodyStateArrays::IntegrateVelocities(uint start, uint end, real dt, real maxVelocity)
+{
+  Vec3* velocities = mVelocities.Data();
+  Vec3* angularVelocities = mAngularVelocities.Data();
+  const Vec3* forces = mForces.Data();
+  const Vec3* torques = mTorques.Data();
+  const Vec3* invMasses = mInvMasses.Data();
+  const Mat3* invWorldInertias = mInvWorldInertias.Data();
+
+  //Linear velocity (the same as Integration::IntegrateRk2Velocity)
+  for(uint i = start; i < end; ++i)
+  {
+    Vec3 velocity = Math::MultiplyAdd(velocities[i], forces[i] * invMasses[i], dt);
+    velocities[i] = Math::Clamped(velocity, -maxVelocity, maxVelocity);
+  }
+
+  //Angular velocity, split into an explicit and an implicit (gyroscopic) step
+  for(uint i = start; i < end; ++i)
+  {
+    Vec3 explicitW = Math::Transform(invWorldInertias[i], torques[i]) * dt;
+    Vec3 implicitW = Vec3::cZero;
+    if(!mMode2D[i])
+      implicitW = Integration::ComputeGyroscopicVelocity(angularVelocities[i], mRotations[i], mInvModelInertias[i], dt);
+
+    Vec3 angularVelocity = angularVelocities[i] + explicitW + implicitW;
+    angularVelocities[i] = Math::Clamped(angularVelocity, -maxVelocity, maxVelocity);
+  }
+}
+
+void BodyStateArrays::IntegratePositions(uint start, uint end, real dt)
+{
+  const Vec3* velocities = mVelocities.Data();
+  const Vec3* angularVelocities = mAngularVelocities.Data();
+  const Vec3* forces = mForces.Data();
+  const Vec3* invMasses = mInvMasses.Data();
+  Vec3* centersOfMass = mCentersOfMass.Data();
+  Quat* rotations = mRotations.Data();
+
+  //The same as Integration::IntegrateRk2Position
+  real halfDt = dt * real(.5);
+  for(uint i = start; i < end; ++i)
+  {
+    Vec3 velocity = Math::MultiplyAdd(velocities[i], forces[i] * invMasses[i], halfDt);
+    centersOfMass[i] += velocity * dt;
+  }
+
+  for(uint i = start; i < end; ++i)
+  {
+    Vec3 angularVelocity = angularVelocities[i];
+    Quat rotation = rotations[i];
+    Quat Qw(angularVelocity.x, angularVelocity.y, angularVelocity.z, real(0.0));
+    rotation += (Qw * rotation) * real(0.5) * dt;
+    rotation.Normalize();
+    rotations[i] = rotation;
+  }
+}
+
+void BodyStateArrays::CommitVelocities()
+{
+  for(uint i = 0; i < mBodies.Size(); ++i)
+  {
+    RigidBody* body = mBodies[i];
+    body->mVelocityOld = body->mVelocity;
+    body->mAngularVelocityOld = body->mAngularVelocity;
+    body->mVelocity = mVelocities[i];
+    body->mAngularVelocity = mAngularVelocities[i];
+  }
+}
+
+void BodyStateArrays::CommitPositions(real dt)
+{
+  for(uint i = 0; i < mBodies.Size(); ++i)
+  {
+    RigidBody* body = mBodies[i];
+    body->SetIntegratedTransform(mCentersOfMass[i], mRotations[i]);
+    body->GenerateIntegrationUpdate();
+    // Attempt to sleep the body.
+    body->UpdateSleepTimer(dt);
+  }
+}
+
+}//namespace Physics
+
+}//namespace Plasma
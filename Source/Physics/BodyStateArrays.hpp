@@ -0,0 +1,71 @@
+#pragma once
+
+namespace Plasma
+{
+
+class RigidBody;
+class IgnoreSpaceEffects;
+
+namespace Physics
+{
+
+///The state of the awake dynamic bodies of a space that integration uses,
+///stored as structure of arrays so each integration step is a contiguous loop
+///over the bodies (split between the job workers for large spaces). The
+///bodies are gathered at the start of each step and the results are committed
+///back to the RigidBody components at the end of it.
+struct BodyStateArrays
+{
+  void Clear();
+  uint Size() const;
+
+  ///Adds the state of a body that velocity integration needs.
+  void AddVelocityState(RigidBody* body);
+  ///Adds the state of a body that position integration needs.
+  void AddPositionState(RigidBody* body);
+
+  ///Integrates the velocities of all bodies (see Integration::IntegrateRk2Velocity).
+  void IntegrateVelocities(real dt, real maxVelocity);
+  ///Integrates the center of mass and rotation of all bodies
+  ///(see Integration::IntegrateRk2Position).
+  void IntegratePositions(real dt);
+  ///The loops of the two integration steps for the bodies in [start, end).
+  void IntegrateVelocities(uint start, uint end, real dt, real maxVelocity);
+  void IntegratePositions(uint start, uint end, real dt);
+
+  ///Effect kernels for the bodies in [start, end). The Vec3 arrays are walked as
+  ///flat arrays of reals so cSimdLaneCount components are processed at once.
+  ///Adds the same force to each body.
+  void AddForces(uint start, uint end, Vec3Param force);
+  ///Adds the force that gives each body the same acceleration (see GravityEffect).
+  void AddAccelerations(uint start, uint end, Vec3Param acceleration);
+  ///Adds -velocity * (drag + damping * mass) to each body's force (see DragEffect).
+  void AddLinearDrag(uint start, uint end, real drag, real damping);
+  ///Adds -angularVelocity * drag to each body's torque.
+  void AddAngularDrag(uint start, uint end, real drag);
+
+  ///Writes the integrated velocities back to the bodies.
+  void CommitVelocities();
+  ///Writes the integrated transforms back to the bodies and queues their updates.
+  void CommitPositions(real dt);
+
+  Array<RigidBody*> mBodies;
+  Array<Vec3> mVelocities;
+  Array<Vec3> mAngularVelocities;
+  Array<Vec3> mForces;
+  Array<Vec3> mTorques;
+  Array<Vec3> mInvMasses;
+  ///The mass of each axis, 1 for axes without mass (same as Mass::ApplyInverted).
+  Array<Vec3> mMasses;
+  Array<Mat3> mInvWorldInertias;
+  Array<Mat3> mInvModelInertias;
+  Array<Vec3> mCentersOfMass;
+  Array<Quat> mRotations;
+  Array<bool> mMode2D;
+  ///The space effects each body ignores (only filled for velocity integration).
+  Array<IgnoreSpaceEffects*> mEffectsToIgnore;
+};
+
+}//namespace Physics
+
+}//namespace Plasma
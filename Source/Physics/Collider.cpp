@@ -65,13 +65,15 @@ Collider::Collider()
   mActiveRigidBody = nullptr;
   mCollisionGroupInstance = nullptr;
   mSpace = nullptr;
+  mIsland = nullptr;
 }
 
 void Collider::Serialize(Serializer& stream)
 {
   /// There's quite a few flags that only store run-time state that we need to ignore when serializing.
   u32 mask = ColliderFlags::OnIsland | ColliderFlags::Uninitialized | 
-             ColliderFlags::HasPairFilter | ColliderFlags::MasslessBody | ColliderFlags::MasslessCollider | ColliderFlags::Seamless;
+             ColliderFlags::HasPairFilter | ColliderFlags::MasslessBody | ColliderFlags::MasslessCollider | ColliderFlags::Seamless |
+             ColliderFlags::IslandQueued;
   // The default state is to be not ghost
   SerializeBits(stream, mState, ColliderFlags::Names, mask, ~ColliderFlags::Ghost);
 
@@ -3,14 +3,15 @@
 namespace Plasma
 {
 
-DeclareBitField8(ColliderFlags, Ghost,
+DeclareBitField9(ColliderFlags, Ghost,
                                 SendsEvents,
                                 OnIsland,
                                 HasPairFilter,
                                 Uninitialized,
                                 Seamless,
                                 MasslessBody,
-                                MasslessCollider);
+                                MasslessCollider,
+                                IslandQueued);
 
 /// A collider controls how collision detection is performed for an object.
 /// A collider also gives mass properties to a RigidBody (via the material and volume).
@@ -275,6 +276,8 @@ public:
   /// for consistent ordering and forming pair ids.
   u32 mId;
   Link<Collider> mIslandLink;
+  /// The island this collider is on (null if it isn't on one).
+  Physics::Island* mIsland;
   /// Link for composite bodies
   Link<Collider> mBodyLink;
   // Space Information
@@ -39,6 +39,11 @@ Contact* ContactManager::AddManifold(Manifold& manifold)
     contact->mContactManager = this;
     contact->SetPair(manifold.Objects);
     contact->SetManifold(new Manifold(manifold));
+    // If the contact existed in a state that was just restored, continue from its
+    // saved points (and impulses) the same way as if it had never been removed
+    Physics::PhysicsSnapshot* restoredState = mSpace->mRestoredState;
+    if(restoredState != nullptr && restoredState->RestoreManifold(contact->mManifold))
+      contact->mManifold->AddPoints(manifold.Contacts, manifold.ContactCount);
     ++contact->GetCollider(0)->mContactCount;
     ++contact->GetCollider(1)->mContactCount;
 
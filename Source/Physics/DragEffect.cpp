@@ -65,6 +65,41 @@ void DragEffect::ApplyEffect(RigidBody* obj, real dt)
   obj->ApplyTorqueNoWakeUp(torque);
 }
 
+void DragEffect::ApplyEffect(Physics::BodyStateArrays& bodies, real dt)
+{
+  if(!GetActive())
+    return;
+
+  ZoneScoped;
+
+  // Same as applying to each body above
+  real invDt = 0;
+  if(dt != 0)
+    invDt = 1 / dt;
+  real linearDamping = Math::Min(mLinearDamping, invDt);
+  real angularDamping = Math::Min(mAngularDamping, invDt);
+
+  uint start = 0;
+  uint end = 0;
+  while(GetNextAffectedRange(bodies, start, end))
+  {
+    bodies.AddLinearDrag(start, end, mLinearDrag, linearDamping);
+
+    // Angular damping needs each body's world inertia so it stays per body
+    if(angularDamping == 0.0f)
+    {
+      bodies.AddAngularDrag(start, end, mAngularDrag);
+      continue;
+    }
+
+    for(uint i = start; i < end; ++i)
+    {
+      Vec3 angularAcceleration = -bodies.mAngularVelocities[i] * angularDamping;
+      bodies.mTorques[i] += bodies.mBodies[i]->mInvInertia.ApplyInverted(angularAcceleration);
+    }
+  }
+}
+
 real DragEffect::GetLinearDamping() const
 {
   return mLinearDamping;
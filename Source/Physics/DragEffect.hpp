@@ -19,6 +19,7 @@ public:
 
   // Physics Effect Interface
   void ApplyEffect(RigidBody* obj, real dt) override;
+  void ApplyEffect(Physics::BodyStateArrays& bodies, real dt) override;
 
   //Properties
 
@@ -69,6 +69,7 @@ struct PhysicsNodeManager;
 struct PhysicsEventManager;
 class Island;
 struct PhysicsQueue;
+struct BodyStateArrays;
 
 }//namespace Physics
 
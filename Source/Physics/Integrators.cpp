@@ -28,15 +28,17 @@ Vec3 SolveGyroscopic(RigidBody* body, float dt)
   if(body->mState.IsSet(RigidBodyStates::Mode2D))
     return Vec3::cZero;
 
-  Quat rotation = body->mRotationQuat;
-  Mat3 invInertia = body->mInvInertia.GetInvModelTensor();
+  return Integration::ComputeGyroscopicVelocity(body->mAngularVelocity, body->mRotationQuat, body->mInvInertia.GetInvModelTensor(), dt);
+}
+
+Vec3 Integration::ComputeGyroscopicVelocity(Vec3Param angularVelocity, QuatParam rotation, Mat3Param invInertia, real dt)
+{
   real invInertiaDeterminant = invInertia.Determinant();
   // If the body can't be rotated then don't we can't do anything so return
   if(invInertiaDeterminant == 0)
     return Vec3::cZero;
 
   Mat3 inertiaBody = invInertia.Inverted();
-  Vec3 angularVelocity = body->mAngularVelocity;
 
   // Convert to body coordinates
   Quat invRotation = rotation.Inverted();
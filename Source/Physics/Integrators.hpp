@@ -26,6 +26,10 @@ struct Integration
   static void IntegrateRk2Velocity(RigidBody* body, real dt);
   static void IntegrateRk2Position(RigidBody* body, real dt);
 
+  /// Returns the change in angular velocity from the gyroscopic term of a body
+  /// with the given local-space inverse inertia (not used in 2d).
+  static Vec3 ComputeGyroscopicVelocity(Vec3Param angularVelocity, QuatParam rotation, Mat3Param invInertia, real dt);
+
   static Vec3 VelocityApproximation(Vec3Param startPosition, Vec3Param endPosition, real dt);
   static Vec3 AngularVelocityApproximation(QuatParam startRotation, QuatParam endRotation, real dt);
   static Vec3 AngularVelocityApproximation(Mat3Param startRotation, Mat3Param endRotation, real dt);
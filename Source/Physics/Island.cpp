@@ -25,6 +25,8 @@ Island::Island()
   JointCount = 0;
   ColliderCount = 0;
   mOwnsSolver = true;
+  mNeedsSplit = false;
+  mAsleep = false;
 }
 
 Island::~Island()
@@ -45,11 +47,19 @@ void Island::MergeIsland(Island& island)
   ColliderCount += island.ColliderCount;
   ContactCount += island.ContactCount;
   JointCount += island.JointCount;
+  mNeedsSplit = mNeedsSplit || island.mNeedsSplit;
 
-  
-  mColliders.Splice(mColliders.End(), island.mColliders);
+  //the colliders have to know which island they're on now
+  Colliders::range range = island.mColliders.All();
+  for(; !range.Empty(); range.PopFront())
+    range.Front().mIsland = this;
+
+  if(!island.mColliders.Empty())
+    mColliders.Splice(mColliders.End(), island.mColliders);
   if(!island.mJoints.Empty())
     mJoints.Splice(mJoints.End(), island.mJoints.All());
+  if(!island.mUnSolvableJoints.Empty())
+    mUnSolvableJoints.Splice(mUnSolvableJoints.End(), island.mUnSolvableJoints.All());
   if(!island.mContacts.Empty())
     mContacts.Splice(mContacts.End(), island.mContacts.All());
 }
@@ -58,6 +68,7 @@ void Island::Add(Collider* collider)
 {
   ++ColliderCount;
 
+  collider->mIsland = this;
   mColliders.PushBack(collider);
 }
 
@@ -166,6 +177,12 @@ void Island::Solve(real dt, bool allowSleeping, uint debugFlags)
   UpdateSleep(dt, allowSleeping, debugFlags);
 }
 
+void Island::SolveWithoutEvents(real dt)
+{
+  CommitConstraints();
+  mSolver->SolveWithoutEvents(dt);
+}
+
 void Island::SolvePositions(real dt)
 {
   mSolver->SolvePositions();
@@ -221,10 +238,27 @@ void Island::UpdateSleep(real dt, bool allowSleeping, uint debugFlags)
   }
 }
 
+bool Island::HasAwakeCollider()
+{
+  Colliders::range range = mColliders.All();
+  for(; !range.Empty(); range.PopFront())
+  {
+    Collider& collider = range.Front();
+    if(!collider.IsAsleep() && !collider.IsStatic())
+      return true;
+  }
+  return false;
+}
+
 void Island::ClearIslandFlags(Collider& collider)
 {
   collider.mState.ClearFlag(ColliderFlags::OnIsland);
-  
+  collider.mIsland = nullptr;
+  ClearConstraintFlags(collider);
+}
+
+void Island::ClearConstraintFlags(Collider& collider)
+{
   Collider::JointEdgeList::range jointRange = collider.mJointEdges.All();
   for(; !jointRange.Empty(); jointRange.PopFront())
     jointRange.Front().mJoint->SetOnIsland(false);
@@ -239,6 +273,21 @@ void Island::ClearIslandFlags(Collider& collider)
     body->mState.ClearFlag(RigidBodyStates::SleepAccumulated);
 }
 
+void Island::ClearConstraints()
+{
+  Colliders::range range = mColliders.All();
+  for(; !range.Empty(); range.PopFront())
+    ClearConstraintFlags(range.Front());
+
+  mJoints.Clear();
+  mContacts.Clear();
+  mUnSolvableJoints.Clear();
+  mSolver->Clear();
+
+  ContactCount = 0;
+  JointCount = 0;
+}
+
 void Island::Clear()
 {
   Colliders::range range = mColliders.All();
@@ -255,6 +304,13 @@ void Island::Clear()
   ContactCount = 0;
   JointCount = 0;
   ColliderCount = 0;
+  mNeedsSplit = false;
+}
+
+void Island::ConstraintRemoved(Collider* collider)
+{
+  if(collider != nullptr && collider->mIsland != nullptr)
+    collider->mIsland->mNeedsSplit = true;
 }
 
 bool Island::ContainsCollider(const Collider* collider)
@@ -34,12 +34,25 @@ public:
   void IntegratePosition(real dt);
   void CommitConstraints();
   void Solve(real dt, bool allowSleeping, uint debugFlags);
+  ///Commits and solves the constraints without batching events or updating sleep.
+  ///Safe to run at the same time as other islands (that have their own solver).
+  void SolveWithoutEvents(real dt);
   void SolvePositions(real dt);
   void UpdateSleep(real dt, bool allowSleeping, uint debugFlags);
+  ///Returns if any collider on this island is neither asleep nor static.
+  bool HasAwakeCollider();
   ///Helper function to mark everything as not on an island.
   void ClearIslandFlags(Collider& collider);
+  ///Helper function to mark the collider's constraints as not on an island.
+  void ClearConstraintFlags(Collider& collider);
+  ///Removes all constraints (but not colliders) so the island can be walked again.
+  void ClearConstraints();
   void Clear();
 
+  ///Called when a constraint is unlinked from the given collider so that
+  ///the collider's island knows it might have to be split.
+  static void ConstraintRemoved(Collider* collider);
+
   ///Returns if the provided collider is in the island.
   bool ContainsCollider(const Collider* collider);
 
@@ -57,6 +70,11 @@ public:
   JointList mUnSolvableJoints;
 
   bool mOwnsSolver;
+  ///Set when a constraint or collider was removed, the island might not be
+  ///connected anymore and has to be rebuilt from its colliders.
+  bool mNeedsSplit;
+  ///The island's bodies were all asleep so it isn't walked or solved.
+  bool mAsleep;
 
   uint ContactCount;
   uint JointCount;
@@ -256,6 +256,50 @@ struct ConstraintCountPreProcessing
   }
 };
 
+//Islands with fewer constraints than this in total are solved on the calling thread.
+const uint cMinParallelIslandConstraints = 128;
+
+struct IslandCost
+{
+  Island* mIsland;
+  uint mCost;
+  //Position in the island list, used to break ties so the order is stable.
+  uint mIndex;
+};
+
+bool IslandCostSorter(const IslandCost& lhs, const IslandCost& rhs)
+{
+  if(lhs.mCost != rhs.mCost)
+    return lhs.mCost > rhs.mCost;
+  return lhs.mIndex < rhs.mIndex;
+}
+
+//Solves batches of islands (used with JobSystem::ParallelFor). Every island has
+//its own solver and islands only share static and kinematic bodies (which the
+//solvers never write to), so the result doesn't depend on which thread ran what.
+//Islands with custom joints aren't batched since those dispatch to script.
+struct IslandBatchSolver
+{
+  void operator()(uint begin, uint end)
+  {
+    for(uint batch = begin; batch < end; ++batch)
+    {
+      for(uint i = mBatchStarts[batch]; i < mBatchStarts[batch + 1]; ++i)
+      {
+        if(mSolvePositions)
+          mIslands[i]->SolvePositions(mDt);
+        else
+          mIslands[i]->SolveWithoutEvents(mDt);
+      }
+    }
+  }
+
+  Island** mIslands;
+  uint* mBatchStarts;
+  real mDt;
+  bool mSolvePositions;
+};
+
 IslandManager::IslandManager(PhysicsSolverConfig* config)
 {
   mIslandCount = 0;
@@ -266,6 +310,8 @@ IslandManager::IslandManager(PhysicsSolverConfig* config)
   mPostProcess = false;
   mSharedSolver = nullptr;
   mShareSolver = false;
+  mIncremental = false;
+  mSolverType = PhysicsSolverType::Basic;
 }
 
 IslandManager::~IslandManager()
@@ -287,16 +333,28 @@ void IslandManager::SetSolverConfig(PhysicsSolverConfig* config)
   if(mSharedSolver != nullptr)
     mSharedSolver->SetConfiguration(mPhysicsSolverConfig);
 
-  IslandList::range range = mIslands.All();
-  for(; !range.Empty(); range.PopFront())
+  IslandList* islandLists[] = {&mIslands, &mSleepingIslands, &mWokenIslands};
+  for(uint i = 0; i < 3; ++i)
   {
-    Island& island = range.Front();
-    island.mSolver->SetConfiguration(mPhysicsSolverConfig);
+    IslandList::range range = islandLists[i]->All();
+    for(; !range.Empty(); range.PopFront())
+    {
+      Island& island = range.Front();
+      island.mSolver->SetConfiguration(mPhysicsSolverConfig);
+    }
   }
 }
 
 void IslandManager::BuildIslands(ColliderList& colliders)
 {
+  ProfileScopeTree("BuildIslands", "NarrowPhase", Color::Coral);
+
+  if(IsIncremental())
+  {
+    BuildIncrementalIslands(colliders);
+    return;
+  }
+
   Clear();
 
   if(mShareSolver)
@@ -387,17 +445,34 @@ void IslandManager::Solve(real dt, bool allowSleeping, uint debugFlags)
     return;
   }
 
-  //solve all of the islands.
+  //solve all of the islands (in parallel when there's enough work)
+  SolveIslands(dt, false);
+
+  //Batching events and sleeping send events and can destroy joints, so they're
+  //done afterwards in island order. Serial and parallel solves always run these
+  //steps in the same order so they match exactly.
   IslandList::range islandRange = mIslands.All();
   for(; !islandRange.Empty(); islandRange.PopFront())
-    islandRange.Front().Solve(dt, allowSleeping, debugFlags);
+  {
+    Island& island = islandRange.Front();
+    island.mSolver->BatchEvents();
+    island.UpdateSleep(dt, allowSleeping, debugFlags);
+  }
 }
 
 void IslandManager::SolvePositions(real dt)
 {
-  IslandList::range islandRange = mIslands.All();
-  for(; !islandRange.Empty(); islandRange.PopFront())
-    islandRange.Front().SolvePositions(dt);
+  //islands that share a solver can't be solved at the same time
+  if(mShareSolver)
+  {
+    IslandList::range islandRange = mIslands.All();
+    for(; !islandRange.Empty(); islandRange.PopFront())
+      islandRange.Front().SolvePositions(dt);
+    return;
+  }
+
+  UpdateSharedBodyTransforms();
+  SolveIslands(dt, true);
 }
 
 void IslandManager::Draw(uint flags)
@@ -410,8 +485,22 @@ void IslandManager::Draw(uint flags)
   }
 }
 
+void IslandManager::AddCollider(Collider* collider)
+{
+  //colliders are only queued up when islands are kept between steps,
+  //otherwise every collider is visited when the islands are built
+  if(mIncremental)
+    QueueCollider(collider);
+}
+
 void IslandManager::RemoveCollider(Collider* collider)
 {
+  if(collider->mState.IsSet(ColliderFlags::IslandQueued))
+  {
+    UnqueueCollider(collider);
+    return;
+  }
+
   //have the collider unlink itself if it is on an island
   if(collider->mState.IsSet(ColliderFlags::OnIsland))
   {
@@ -421,6 +510,47 @@ void IslandManager::RemoveCollider(Collider* collider)
     Physics::JointHelpers::UnlinkJointsFromSolver(collider);
     Physics::Island::Colliders::Unlink(collider);
     collider->mState.ClearFlag(ColliderFlags::OnIsland);
+
+    //the rest of the island might not be connected without this collider
+    Island* island = collider->mIsland;
+    collider->mIsland = nullptr;
+    if(island == nullptr)
+      return;
+
+    --island->ColliderCount;
+    island->mNeedsSplit = true;
+    //sleeping islands aren't being solved so an empty one can be deleted right away
+    if(island->mAsleep && island->mColliders.Empty())
+    {
+      IslandList::Unlink(island);
+      delete island;
+    }
+  }
+}
+
+void IslandManager::WakeBody(RigidBody* body)
+{
+  //islands aren't kept between steps otherwise
+  if(!mIncremental)
+    return;
+
+  RigidBody::CompositeColliderRange colliders = body->mColliders.All();
+  for(; !colliders.Empty(); colliders.PopFront())
+  {
+    Collider* collider = &colliders.Front();
+    Island* island = collider->mIsland;
+    if(island == nullptr)
+    {
+      QueueCollider(collider);
+      continue;
+    }
+
+    if(island->mAsleep)
+    {
+      island->mAsleep = false;
+      IslandList::Unlink(island);
+      mWokenIslands.PushBack(island);
+    }
   }
 }
 
@@ -429,6 +559,12 @@ void IslandManager::Clear()
   mIslandCount = 0;
 
   DeleteObjectsIn<Island, &Island::ManagerLink>(mIslands);
+  DeleteObjectsIn<Island, &Island::ManagerLink>(mSleepingIslands);
+  DeleteObjectsIn<Island, &Island::ManagerLink>(mWokenIslands);
+  while(!mQueuedColliders.Empty())
+    UnqueueCollider(&mQueuedColliders.Front());
+  mIncremental = false;
+
   if(mShareSolver && mSharedSolver != nullptr)
   {
     mSharedSolver->Clear();
@@ -438,15 +574,7 @@ void IslandManager::Clear()
 
 Island* IslandManager::GetObjectsIsland(const Collider* collider)
 {
-  IslandList::range islandRange = mIslands.All();
-  for(; !islandRange.Empty(); islandRange.PopFront())
-  {
-    Island* island = &islandRange.Front();
-    if(island->ContainsCollider(collider))
-      return island;
-  }
-
-  return nullptr;
+  return collider->mIsland;
 }
 
 template <typename Policy> 
@@ -536,6 +664,243 @@ void IslandManager::CreateSingleIsland(Policy policy, ColliderList& colliders)
   mIslands.PushBack(island);
 }
 
+bool IslandManager::IsIncremental()
+{
+  //the other settings are for testing and regroup everything every step
+  return mIslandingType == PhysicsIslandType::Kinematics &&
+         mPreProcessingType == PhysicsIslandPreProcessingMode::None &&
+         !mPostProcess && !mShareSolver;
+}
+
+void IslandManager::BuildIncrementalIslands(ColliderList& colliders)
+{
+  //everything has to be regrouped if the islands were built some other way
+  //last time or if the islands' solvers are the wrong type now
+  if(!mIncremental || mSolverType != mPhysicsSolverConfig->mSolverType)
+  {
+    Clear();
+    mIncremental = true;
+    mSolverType = mPhysicsSolverConfig->mSolverType;
+
+    ColliderList::range colliderRange = colliders.All();
+    for(; !colliderRange.Empty(); colliderRange.PopFront())
+      QueueCollider(&colliderRange.Front());
+  }
+
+  //the islands solved last step and the ones woken up since then are walked
+  //again, sleeping islands aren't touched at all
+  IslandList islands;
+  if(!mIslands.Empty())
+    islands.Splice(islands.End(), mIslands);
+  if(!mWokenIslands.Empty())
+    islands.Splice(islands.End(), mWokenIslands);
+
+  {
+    ProfileScopeTree("SplitIslands", "BuildIslands", Color::LightCoral);
+
+    //islands that lost a constraint or collider might have come apart. Rather than
+    //finding where, their colliders are queued up and regrouped like new ones.
+    IslandList::range islandRange = islands.All();
+    while(!islandRange.Empty())
+    {
+      Island* island = &islandRange.Front();
+      islandRange.PopFront();
+
+      if(island->mNeedsSplit)
+      {
+        IslandList::Unlink(island);
+        SplitIsland(island);
+      }
+      else
+        island->ClearConstraints();
+    }
+  }
+
+  //start new islands from the queued colliders that are connected to something
+  Island::Colliders queued;
+  if(!mQueuedColliders.Empty())
+    queued.Splice(queued.End(), mQueuedColliders);
+  while(!queued.Empty())
+  {
+    Collider* collider = &queued.Front();
+
+    //sleeping and static colliders are only put on an island once
+    //something awake is connected to them
+    if(collider->IsAsleep() || collider->IsStatic())
+    {
+      if(collider->IsAsleep())
+        collider->mState.ClearFlag(ColliderFlags::Uninitialized);
+      UnqueueCollider(collider);
+      continue;
+    }
+
+    //nothing to solve yet, so wait for a constraint
+    if(collider->mContactEdges.Empty() && collider->mJointEdges.Empty())
+    {
+      queued.Unlink(collider);
+      mQueuedColliders.PushBack(collider);
+      continue;
+    }
+
+    Island* island = CreateNewIsland();
+    islands.PushBack(island);
+    AddTreeToIsland(collider, island);
+  }
+
+  //walk the islands to add their constraints, merging in every island they
+  //are connected to (the merged in colliders get walked as well)
+  while(!islands.Empty())
+  {
+    Island* island = &islands.Front();
+    islands.Unlink(island);
+
+    if(!island->HasAwakeCollider())
+    {
+      PutIslandToSleep(island);
+      continue;
+    }
+
+    Island::Colliders::range range = island->mColliders.All();
+    for(; !range.Empty(); range.PopFront())
+    {
+      Collider* collider = &range.Front();
+      collider->mState.ClearFlag(ColliderFlags::Uninitialized);
+
+      //don't extend the island over static objects
+      if(collider->IsStatic())
+        continue;
+
+      AddEdgesToIsland(collider->mJointEdges, island);
+      AddEdgesToIsland(collider->mContactEdges, island);
+      AddTreeToIsland(collider, island);
+    }
+
+    mIslands.PushBack(island);
+  }
+
+  mIslandCount = 0;
+  IslandList::range range = mIslands.All();
+  for(; !range.Empty(); range.PopFront())
+    ++mIslandCount;
+}
+
+void IslandManager::SplitIsland(Island* island)
+{
+  Island::Colliders::range range = island->mColliders.All();
+  while(!range.Empty())
+  {
+    Collider* collider = &range.Front();
+    range.PopFront();
+
+    island->ClearIslandFlags(*collider);
+    Island::Colliders::Unlink(collider);
+    QueueCollider(collider);
+  }
+
+  delete island;
+}
+
+void IslandManager::PutIslandToSleep(Island* island)
+{
+  //same as for queued colliders, sleeping objects only need to be initialized once
+  Island::Colliders::range range = island->mColliders.All();
+  for(; !range.Empty(); range.PopFront())
+    range.Front().mState.ClearFlag(ColliderFlags::Uninitialized);
+
+  island->mAsleep = true;
+  mSleepingIslands.PushBack(island);
+}
+
+void IslandManager::AddTreeToIsland(Collider* collider, Island* island)
+{
+  //if any collider in a tree is on an island, that
+  //means the whole tree was put on that island
+  if(collider->mIsland != nullptr)
+  {
+    if(collider->mIsland != island)
+      MergeIslands(island, collider->mIsland);
+    return;
+  }
+
+  ColliderStack stack;
+  stack.SetAllocator(HeapAllocator(mSpace->mHeap));
+  AddTreeToStack(collider, stack);
+  //make sure the collider itself ends up on the island even
+  //if it couldn't be found by walking down from the root body
+  stack.PushBack(collider);
+
+  for(uint i = 0; i < stack.Size(); ++i)
+  {
+    Collider* treeCollider = stack[i];
+    if(treeCollider->mIsland == island)
+      continue;
+
+    if(treeCollider->mIsland != nullptr)
+    {
+      MergeIslands(island, treeCollider->mIsland);
+      continue;
+    }
+
+    if(treeCollider->mState.IsSet(ColliderFlags::IslandQueued))
+      UnqueueCollider(treeCollider);
+    treeCollider->mState.SetFlag(ColliderFlags::OnIsland);
+    island->Add(treeCollider);
+  }
+}
+
+template <typename EdgeListType>
+void IslandManager::AddEdgesToIsland(EdgeListType& edgeList, Island* island)
+{
+  typename EdgeListType::range edgeRange = edgeList.All();
+
+  while(!edgeRange.Empty())
+  {
+    typename EdgeListType::value_type& edge = edgeRange.Front();
+    edgeRange.PopFront();
+
+    if(edge.mJoint->GetOnIsland())
+      continue;
+
+    // If the joint isn't valid for some reason (one of the colliders/cogs is null)
+    // then don't solve or traverse this edge
+    if(!edge.mJoint->GetValid())
+    {
+      DestroyJoint(edge.mJoint);
+      continue;
+    }
+
+    island->Add(edge.mJoint);
+
+    //islands don't extend over static objects
+    Collider* otherCollider = edge.mOther;
+    if(otherCollider->GetActiveBody() != nullptr)
+      AddTreeToIsland(otherCollider, island);
+  }
+}
+
+void IslandManager::MergeIslands(Island* island, Island* other)
+{
+  IslandList::Unlink(other);
+  island->MergeIsland(*other);
+  //everything was moved over so this only deletes the solver
+  delete other;
+}
+
+void IslandManager::QueueCollider(Collider* collider)
+{
+  if(collider->mState.IsSet(ColliderFlags::IslandQueued))
+    return;
+
+  collider->mState.SetFlag(ColliderFlags::IslandQueued);
+  mQueuedColliders.PushBack(collider);
+}
+
+void IslandManager::UnqueueCollider(Collider* collider)
+{
+  collider->mState.ClearFlag(ColliderFlags::IslandQueued);
+  Island::Colliders::Unlink(collider);
+}
+
 IConstraintSolver* IslandManager::GetNewSolver()
 {
   IConstraintSolver* solver = nullptr;
@@ -547,6 +912,8 @@ IConstraintSolver* IslandManager::GetNewSolver()
     solver = new NormalSolver();
   else if(mPhysicsSolverConfig->mSolverType == PhysicsSolverType::Threaded)
     solver = new ThreadedSolver();
+  else if(mPhysicsSolverConfig->mSolverType == PhysicsSolverType::Simd)
+    solver = new SimdSolver();
   else
     ErrorIf(true,"Invalid Solver type specified.");
 
@@ -569,6 +936,149 @@ Island* IslandManager::CreateNewIsland()
   return island;
 }
 
+//Custom joints update their objects' transforms and send an event to script
+//every time their atoms are updated, so they can't be solved on a worker.
+bool HasCustomJoint(Island& island)
+{
+  Island::JointList::range jointRange = island.mJoints.All();
+  for(; !jointRange.Empty(); jointRange.PopFront())
+  {
+    if(jointRange.Front().GetJointType() == JointEnums::CustomJointType)
+      return true;
+  }
+  return false;
+}
+
+void UpdateSharedBodyTransform(Collider* collider)
+{
+  RigidBody* body = collider->GetActiveBody();
+  if(body != nullptr && !body->IsDynamic())
+  {
+    UpdateHierarchyTransform(body);
+    body->UpdateWorldInertiaTensor();
+  }
+}
+
+uint IslandManager::BuildSolveBatches()
+{
+  mSolveOrder.Clear();
+  mBatchStarts.Clear();
+  mSerialIslands.Clear();
+
+  //Every island costs at least one so that islands without constraints still get spread out
+  Array<IslandCost> costs;
+  uint totalCost = 0;
+  IslandList::range islandRange = mIslands.All();
+  for(; !islandRange.Empty(); islandRange.PopFront())
+  {
+    if(HasCustomJoint(islandRange.Front()))
+    {
+      mSerialIslands.PushBack(&islandRange.Front());
+      continue;
+    }
+
+    IslandCost& cost = costs.PushBack();
+    cost.mIsland = &islandRange.Front();
+    cost.mCost = cost.mIsland->ContactCount + cost.mIsland->JointCount + 1;
+    cost.mIndex = costs.Size() - 1;
+    totalCost += cost.mCost;
+  }
+
+  //Not worth splitting up, solve everything in one batch in island order
+  uint workerCount = PL::gJobs->GetWorkerCount();
+  if(workerCount == 0 || costs.Size() < 2 || totalCost < cMinParallelIslandConstraints)
+  {
+    for(uint i = 0; i < costs.Size(); ++i)
+      mSolveOrder.PushBack(costs[i].mIsland);
+    mBatchStarts.PushBack(0);
+    mBatchStarts.PushBack(mSolveOrder.Size());
+    return 1;
+  }
+
+  //One batch per thread (the workers plus the calling thread). Going from the
+  //largest island to the smallest, each island is given to the batch with the
+  //least work so far. This puts the large islands in batches of their own and
+  //spreads the small ones over the remaining batches.
+  Sort(costs.All(), &IslandCostSorter);
+  uint batchCount = Math::Min(workerCount + 1, (uint)costs.Size());
+  uint maxBatchCount = JobSystem::cMaxParallelTasks;
+  batchCount = Math::Min(batchCount, maxBatchCount);
+
+  Array<uint> batchCosts;
+  batchCosts.Resize(batchCount, 0);
+  Array<uint> islandBatches;
+  islandBatches.Resize(costs.Size());
+  for(uint i = 0; i < costs.Size(); ++i)
+  {
+    uint batch = 0;
+    for(uint j = 1; j < batchCount; ++j)
+    {
+      if(batchCosts[j] < batchCosts[batch])
+        batch = j;
+    }
+    islandBatches[i] = batch;
+    batchCosts[batch] += costs[i].mCost;
+  }
+
+  //Group the islands by batch
+  mBatchStarts.Resize(batchCount + 1, 0);
+  for(uint i = 0; i < costs.Size(); ++i)
+    ++mBatchStarts[islandBatches[i] + 1];
+  for(uint i = 0; i < batchCount; ++i)
+    mBatchStarts[i + 1] += mBatchStarts[i];
+
+  Array<uint> nextIndices(mBatchStarts);
+  mSolveOrder.Resize(costs.Size());
+  for(uint i = 0; i < costs.Size(); ++i)
+    mSolveOrder[nextIndices[islandBatches[i]]++] = costs[i].mIsland;
+
+  return batchCount;
+}
+
+void IslandManager::SolveIslands(real dt, bool positions)
+{
+  IslandBatchSolver solver;
+  solver.mDt = dt;
+  solver.mSolvePositions = positions;
+  uint batchCount = BuildSolveBatches();
+  solver.mIslands = mSolveOrder.Data();
+  solver.mBatchStarts = mBatchStarts.Data();
+  PL::gJobs->ParallelFor(0, batchCount, solver, 1);
+
+  for(uint i = 0; i < mSerialIslands.Size(); ++i)
+  {
+    if(positions)
+      mSerialIslands[i]->SolvePositions(dt);
+    else
+      mSerialIslands[i]->SolveWithoutEvents(dt);
+  }
+}
+
+void IslandManager::UpdateSharedBodyTransforms()
+{
+  //Static and kinematic bodies can be on several islands at once. Kinematic
+  //bodies were just integrated, so bring them up to date once here instead
+  //of from every constraint that touches them.
+  IslandList::range islandRange = mIslands.All();
+  for(; !islandRange.Empty(); islandRange.PopFront())
+  {
+    Island& island = islandRange.Front();
+    Island::ContactList::range contactRange = island.mContacts.All();
+    for(; !contactRange.Empty(); contactRange.PopFront())
+    {
+      UpdateSharedBodyTransform(contactRange.Front().GetCollider(0));
+      UpdateSharedBodyTransform(contactRange.Front().GetCollider(1));
+    }
+
+    Island::JointList::range jointRange = island.mJoints.All();
+    for(; !jointRange.Empty(); jointRange.PopFront())
+    {
+      UpdateSharedBodyTransform(jointRange.Front().GetCollider(0));
+      UpdateSharedBodyTransform(jointRange.Front().GetCollider(1));
+    }
+  }
+}
+
 }//namespace Physics
 
 }//namespace Plasma
@@ -4,7 +4,7 @@ namespace Plasma
 {
 
 /// What kind of a constraint solver should be used. A few pre-defined types meant for comparing performance.
-DeclareEnum4(PhysicsSolverType, Basic, Normal, GenericBasic, Threaded);
+DeclareEnum5(PhysicsSolverType, Basic, Normal, GenericBasic, Threaded, Simd);
 /// How should islands be built. Internal for testing (mostly legacy).
 DeclareEnum3(PhysicsIslandType, Composites, Kinematics, ForcedOne);
 /// What kind of pre-processing strategy should be used for merging islands.
@@ -16,7 +16,10 @@ namespace Physics
 class Island;
 
 
-///Builds, solves and debug draws islands.
+///Builds, solves and debug draws islands. With the default islanding settings
+///islands are kept between steps: new constraints merge islands, islands that
+///lose constraints are split up the next time they're built and islands where
+///everything is asleep aren't touched until a body on them wakes up.
 class IslandManager
 {
 public:
@@ -32,7 +35,11 @@ public:
   void SolvePositions(real dt);
   void Draw(uint flags);
 
+  ///Queues a dynamic collider to be put on an island.
+  void AddCollider(Collider* collider);
   void RemoveCollider(Collider* collider);
+  ///Moves the islands of a body that woke up back into the islands that get built.
+  void WakeBody(RigidBody* body);
   void Clear();
 
   ///Returns the Island that Contains the given collider. null if none exists.
@@ -43,14 +50,49 @@ public:
   template <typename Policy, typename PreProcessing> void CreateCompactIslands(Policy policy, PreProcessing prePolicy, ColliderList& colliders);
   template <typename Policy> void CreateSingleIsland(Policy policy, ColliderList& colliders);
 
+  ///Returns if islands are kept between steps (only done for the default settings).
+  bool IsIncremental();
+  void BuildIncrementalIslands(ColliderList& colliders);
+  ///Puts the island's colliders back on the queue and deletes it.
+  void SplitIsland(Island* island);
+  void PutIslandToSleep(Island* island);
+  ///Puts the collider and the rest of its body tree on the island, merging in
+  ///any island the tree is already on.
+  void AddTreeToIsland(Collider* collider, Island* island);
+  ///Adds the constraints to the island and merges in whatever they connect to.
+  template <typename EdgeListType> void AddEdgesToIsland(EdgeListType& edgeList, Island* island);
+  ///Merges the other island into the island and deletes the other island.
+  void MergeIslands(Island* island, Island* other);
+  void QueueCollider(Collider* collider);
+  void UnqueueCollider(Collider* collider);
+
   IConstraintSolver* GetNewSolver();
   Island* CreateNewIsland();
+  ///Splits the islands into batches of roughly equal cost for solving on the
+  ///job system (largest islands first). Returns the number of batches.
+  ///Islands that can't be solved on a worker go in mSerialIslands instead.
+  uint BuildSolveBatches();
+  ///Solves the batches on the job system and then the serial islands.
+  void SolveIslands(real dt, bool positions);
+  ///Updates the cached transforms of the static and kinematic bodies the
+  ///islands touch (the position solvers only update dynamic bodies).
+  void UpdateSharedBodyTransforms();
 
   uint mIslandCount;
   typedef InList<Island,&Island::ManagerLink> IslandList;
   IslandList mIslands;
   bool mPostProcess;
 
+  ///Islands where everything is asleep (only when building incrementally).
+  IslandList mSleepingIslands;
+  ///Sleeping islands that were woken up since islands were last built.
+  IslandList mWokenIslands;
+  ///Dynamic colliders that are waiting to be put on an island.
+  Island::Colliders mQueuedColliders;
+  ///Whether the current islands were built incrementally.
+  bool mIncremental;
+
+  ///The type of solver the islands were created with.
   PhysicsSolverType::Enum mSolverType;
   PhysicsIslandType::Enum mIslandingType;
   PhysicsIslandPreProcessingMode::Enum mPreProcessingType;
@@ -61,6 +103,13 @@ public:
   PhysicsSpace* mSpace;
   bool mShareSolver;
   IConstraintSolver* mSharedSolver;
+
+  ///The islands grouped by batch, where batch i is [mBatchStarts[i], mBatchStarts[i + 1]).
+  ///Kept around so they don't have to be reallocated every solve.
+  Array<Island*> mSolveOrder;
+  Array<uint> mBatchStarts;
+  ///Islands solved on the calling thread after the batches, in island order.
+  Array<Island*> mSerialIslands;
 };
 
 }//namespace Physics
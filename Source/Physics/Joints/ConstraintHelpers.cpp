@@ -125,12 +125,14 @@ void CommitVelocities(Collider* obj0, Collider* obj1, JointVelocity& velocities)
   RigidBody* body0 = obj0->GetActiveBody();
   RigidBody* body1 = obj1->GetActiveBody();
 
-  if(body0)
+  //Only dynamic bodies can be changed by a constraint. Static and kinematic
+  //bodies can be on several islands that are solved at the same time, so skip them.
+  if(body0 && body0->IsDynamic())
   {
     body0->mVelocity = velocities.Linear[0];
     body0->mAngularVelocity = velocities.Angular[0];
   }
-  if(body1)
+  if(body1 && body1->IsDynamic())
   {
     body1->mVelocity = velocities.Linear[1];
     body1->mAngularVelocity = velocities.Angular[1];
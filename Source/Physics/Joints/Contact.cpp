@@ -133,6 +133,10 @@ void Contact::UnLinkPair()
   if(GetOnIsland() && !GetGhost() && GetActive())
     InList<Contact, &Contact::SolverLink>::Unlink(this);
 
+  // The colliders might not be connected anymore
+  Island::ConstraintRemoved(mEdges[0].mCollider);
+  Island::ConstraintRemoved(mEdges[1].mCollider);
+
   Collider::ContactEdgeList::Unlink(&mEdges[0]);
   Collider::ContactEdgeList::Unlink(&mEdges[1]);
 }
@@ -446,6 +446,29 @@ void CustomJoint::UpdateTransform(int colliderIndex)
   body->PublishTransform();
 }
 
+void SaveJointImpulses(CustomJoint* joint, Array<real>& impulses)
+{
+  for(size_t i = 0; i < joint->mConstraints.Size(); ++i)
+  {
+    CustomConstraintInfo* constraint = joint->mConstraints[i];
+    impulses.PushBack(constraint != nullptr ? constraint->mImpulse : real(0));
+  }
+}
+
+bool RestoreJointImpulses(CustomJoint* joint, const real* impulses, uint count)
+{
+  if(count != joint->mConstraints.Size())
+    return false;
+
+  for(size_t i = 0; i < joint->mConstraints.Size(); ++i)
+  {
+    CustomConstraintInfo* constraint = joint->mConstraints[i];
+    if(constraint != nullptr)
+      constraint->mImpulse = impulses[i];
+  }
+  return true;
+}
+
 }//namespace Physics
 
 }//namespace Plasma
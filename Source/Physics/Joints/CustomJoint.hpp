@@ -156,6 +156,10 @@ struct CustomJoint : public Joint
   Array<ConstraintInfoReference> mConstraints;
 };
 
+// Custom joints don't have atoms, their impulses are stored on each constraint.
+void SaveJointImpulses(CustomJoint* joint, Array<real>& impulses);
+bool RestoreJointImpulses(CustomJoint* joint, const real* impulses, uint count);
+
 }//namespace Physics
 
 typedef Physics::CustomJoint CustomJoint;
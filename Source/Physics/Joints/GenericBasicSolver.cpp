@@ -242,7 +242,8 @@ void GenericBasicSolver::ConstraintObjectData::ApplyImpulse(Vec3Param linear, Ve
 
 void GenericBasicSolver::ConstraintObjectData::CommitVelocities()
 {
-  if(Body)
+  //static and kinematic bodies can be shared with islands solved at the same time
+  if(Body && Body->IsDynamic())
   {
     Body->mVelocity = Velocity;
     Body->mAngularVelocity = AngularVelocity;
@@ -11,8 +11,11 @@ size_t GetMaxSolverSize()
   size_t basicSolver = sizeof(BasicSolver);
   size_t normalSolver = sizeof(NormalSolver);
   size_t basicGenericSolver = sizeof(GenericBasicSolver);
+  size_t threadedSolver = sizeof(ThreadedSolver);
+  size_t simdSolver = sizeof(SimdSolver);
   
-  return Math::Max(basicSolver, Math::Max(normalSolver,basicGenericSolver));
+  size_t maxSize = Math::Max(basicSolver, Math::Max(normalSolver,basicGenericSolver));
+  return Math::Max(maxSize, Math::Max(threadedSolver,simdSolver));
 }
 
 Memory::Pool* IConstraintSolver::sPool = 
@@ -40,6 +43,14 @@ void IConstraintSolver::AddContacts(ContactList& contacts)
   }
 }
 
+void IConstraintSolver::SolveWithoutEvents(real dt)
+{
+  UpdateData();
+  WarmStart();
+  SolveVelocities();
+  Commit();
+}
+
 uint IConstraintSolver::GetSolverIterationCount() const
 {
   return mSolverConfig->mSolverIterationCount;
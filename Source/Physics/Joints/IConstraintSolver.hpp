@@ -59,6 +59,11 @@ public:
   virtual void Commit() {};
   virtual void BatchEvents() {};
 
+  ///Runs the same steps as Solve but leaves BatchEvents to the caller. Solvers
+  ///for different islands can run this at the same time since batching events
+  ///touches the space's event list and can destroy joints.
+  void SolveWithoutEvents(real dt);
+
   /// Returns the number of iterations this solver should use (determined by the config).
   uint GetSolverIterationCount() const;
   uint GetSolverPositionIterationCount() const;
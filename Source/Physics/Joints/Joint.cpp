@@ -220,11 +220,12 @@ void Joint::UnLinkPair()
     JointList::Unlink(this);
   }
 
-  // Unlink from both colliders
+  // Unlink from both colliders (which might not be connected anymore)
   for(size_t i = 0; i < 2; ++i)
   {
     if(mEdges[i].mCollider != nullptr)
     {
+      Physics::Island::ConstraintRemoved(mEdges[i].mCollider);
       Collider::JointEdgeList::Unlink(&mEdges[i]);
       mEdges[i].mCollider = nullptr;
     }
@@ -255,7 +256,10 @@ void Joint::Relink(uint index, Cog* cog)
   // Unlink the old edge but only if that edge was to a
   // valid collider (aka the edge hasn't been cleared already).
   if(mainEdge.mJoint != nullptr && mainEdge.mCollider != nullptr)
+  {
+    Physics::Island::ConstraintRemoved(mainEdge.mCollider);
     Collider::JointEdgeList::Unlink(&mainEdge);
+  }
 
   // Fix the colliders on the edges and add this edge to the new collider
   mainEdge.mJoint = this;
@@ -84,6 +84,10 @@ struct Joint : public Component
   /// Also returns the atom type (AtomFilter: Linear or Angular).
   virtual uint GetAtomIndexFilterVirtual(uint atomIndex, real& desiredConstraintValue) const;
   virtual void BatchEventsVirtual() {};
+  /// Appends the impulses kept between steps for warm starting (used for physics snapshots).
+  virtual void SaveImpulsesVirtual(Array<real>& impulses) {};
+  /// Sets the impulses written by SaveImpulsesVirtual. Returns false if the count doesn't match.
+  virtual bool RestoreImpulsesVirtual(const real* impulses, uint count) { return false; };
   // Type identification
   virtual JointEnums::JointTypes GetJointType() const { return JointEnums::JointCount; }
   virtual cstr GetJointName() const { return "Joint"; }
@@ -297,6 +301,8 @@ struct Joint : public Component
   void DebugDrawVirtual() override;                                                            \
   uint GetAtomIndexFilterVirtual(uint atomIndex, real& desiredConstraintValue) const override; \
   void BatchEventsVirtual() override;                                                          \
+  void SaveImpulsesVirtual(Array<real>& impulses) override;                                    \
+  bool RestoreImpulsesVirtual(const real* impulses, uint count) override;                      \
   real GetLinearBaumgarte() const;                                                             \
   real GetAngularBaumgarte() const;                                                            \
   real GetLinearErrorCorrection() const;                                                       \
@@ -323,6 +329,11 @@ struct Joint : public Component
     return GetAtomIndexFilter(atomIndex, desiredConstraintValue);                                                              \
   }                                                                                                                            \
   void jointType::BatchEventsVirtual() { BatchEvents(); }                                                                      \
+  void jointType::SaveImpulsesVirtual(Array<real>& impulses) { Physics::SaveJointImpulses(this, impulses); }                   \
+  bool jointType::RestoreImpulsesVirtual(const real* impulses, uint count)                                                     \
+  {                                                                                                                            \
+    return Physics::RestoreJointImpulses(this, impulses, count);                                                               \
+  }                                                                                                                            \
   real jointType::GetLinearBaumgarte() const                                                                                   \
   {                                                                                                                            \
     return Joint::GetLinearBaumgarte(StaticGetJointType());                                                                    \
@@ -340,4 +351,37 @@ struct Joint : public Component
     return Joint::GetAngularErrorCorrection(StaticGetJointType());                                                             \
   }
 
+namespace Physics
+{
+
+// The warm starting impulses of a joint are the impulse of each atom followed by the motor's.
+template <typename JointType>
+void SaveJointImpulses(JointType* joint, Array<real>& impulses)
+{
+  uint atomCount = sizeof(joint->mAtoms) / sizeof(joint->mAtoms[0]);
+  for(uint i = 0; i < atomCount; ++i)
+    impulses.PushBack(joint->mAtoms[i].mImpulse);
+
+  auto motor = joint->mNode->mMotor;
+  if(motor != nullptr)
+    impulses.PushBack(motor->mImpulse);
+}
+
+template <typename JointType>
+bool RestoreJointImpulses(JointType* joint, const real* impulses, uint count)
+{
+  uint atomCount = sizeof(joint->mAtoms) / sizeof(joint->mAtoms[0]);
+  auto motor = joint->mNode->mMotor;
+  if(count != atomCount + (motor != nullptr ? 1 : 0))
+    return false;
+
+  for(uint i = 0; i < atomCount; ++i)
+    joint->mAtoms[i].mImpulse = impulses[i];
+  if(motor != nullptr)
+    motor->mImpulse = impulses[atomCount];
+  return true;
+}
+
+}//namespace Physics
+
 }//namespace Plasma
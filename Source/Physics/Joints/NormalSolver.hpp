@@ -35,7 +35,7 @@ public:
   void Commit() override;
   void BatchEvents() override;
 
-private:
+protected:
   typedef InList<Joint,&Joint::SolverLink> JointList;
   typedef InList<Contact,&Contact::SolverLink> ContactList;
   typedef Array<ConstraintMolecule> MoleculeList;
@@ -114,7 +114,9 @@ void ApplyPositionCorrection(RigidBody* body, Vec3Param linearOffset, Vec3Param
   //(since we need its velocity), but we don't want to updated it during
   //position correction (we don't want to update based upon its center of mass).
   //This is also convenient because there's no reason to position correct kinematics anyways.
-  if(body != nullptr && body->GetKinematic() == false)
+  //Static bodies don't move either, and since they can be on several islands that
+  //are solved at the same time they must not be written to here.
+  if(body != nullptr && body->IsDynamic())
   {
     //translation is very simple to update, just offset by the linear offset
     body->UpdateCenterMass(linearOffset);
@@ -92,10 +92,12 @@ void JointBlockSolvePositions(JointType& joint, PositionSolverData& data, Update
   //position integration (hence they start out invalid). This function updates the
   //entire hierarchy, however this should probably be optimized by only updating the
   //chain of this collider (since this doesn't happen at the end anymore we
-  //only need to update ourself, not the entire hierarchy).
-  if(b0 != nullptr)
+  //only need to update ourself, not the entire hierarchy). Static and kinematic
+  //bodies are shared between islands solved at the same time, so they're
+  //updated beforehand instead (see IslandManager::UpdateSharedBodyTransforms).
+  if(b0 != nullptr && b0->IsDynamic())
     UpdateHierarchyTransform(b0);
-  if(b1 != nullptr)
+  if(b1 != nullptr && b1->IsDynamic())
     UpdateHierarchyTransform(b1);
 
   //Update atoms can alter the molecule count so it needs to be called
@@ -152,9 +154,9 @@ void JointBlockSolvePositions(JointType& joint, PositionSolverData& data, Update
   data.mLambdas.Resize(activeConstraints);
   data.mPartialMasses.Resize(activeConstraints);
 
-  if(b0 != nullptr)
+  if(b0 != nullptr && b0->IsDynamic())
     b0->UpdateWorldInertiaTensor();
-  if(b1 != nullptr)
+  if(b1 != nullptr && b1->IsDynamic())
     b1->UpdateWorldInertiaTensor();
   WorldTransformation* t0 = c0->GetWorldTransform();
   WorldTransformation* t1 = c1->GetWorldTransform();
@@ -280,9 +282,10 @@ inline void SolveConstraintPosition(ListType& jointList, UpdateFunctor functor)
     Collider* c1 = joint.GetCollider(1);
     RigidBody* b0 = c0->GetActiveBody();
     RigidBody* b1 = c1->GetActiveBody();
-    if(b0 != nullptr)
+    //see JointBlockSolvePositions for why non-dynamic bodies are skipped
+    if(b0 != nullptr && b0->IsDynamic())
       UpdateHierarchyTransform(b0);
-    if(b1 != nullptr)
+    if(b1 != nullptr && b1->IsDynamic())
       UpdateHierarchyTransform(b1);
 
     //have to update atoms once so we have the correct number of molecules (soooo bad!)
@@ -291,9 +294,9 @@ inline void SolveConstraintPosition(ListType& jointList, UpdateFunctor functor)
     uint activeJoints = joint.PositionMoleculeCount();
     for(uint i = 0; i < activeJoints; ++i)
     {
-      if(b0 != nullptr)
+      if(b0 != nullptr && b0->IsDynamic())
         b0->UpdateWorldInertiaTensor();
-      if(b1 != nullptr)
+      if(b1 != nullptr && b1->IsDynamic())
         b1->UpdateWorldInertiaTensor();
 
       MoleculeWalker molecules(moleculeList,sizeof(ConstraintMolecule),0);
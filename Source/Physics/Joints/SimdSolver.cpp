@@ -0,0 +1,339 @@
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+//How many of the open groups are checked for a free lane before starting a new group.
+const uint cSimdGroupSearchCount = 8;
+
+//Solves the normal and then the friction rows of every lane in the group. This is
+//the same math as Contact::Solve, just for several contact points at once.
+void SolveContactGroup(SimdContactGroup& group, SimdSolverBody* bodies)
+{
+  //gather each lane's velocities by component (linear0, angular0, linear1, angular1)
+  SimdLanes gathered[12];
+  for(uint lane = 0; lane < cSimdLaneCount; ++lane)
+  {
+    SimdSolverBody& body0 = bodies[group.mBodies[0][lane]];
+    SimdSolverBody& body1 = bodies[group.mBodies[1][lane]];
+    for(uint axis = 0; axis < 3; ++axis)
+    {
+      gathered[axis].mLanes[lane] = body0.mVelocity[axis];
+      gathered[axis + 3].mLanes[lane] = body0.mAngularVelocity[axis];
+      gathered[axis + 6].mLanes[lane] = body1.mVelocity[axis];
+      gathered[axis + 9].mLanes[lane] = body1.mAngularVelocity[axis];
+    }
+  }
+
+  LaneValue velocities[12];
+  for(uint i = 0; i < 12; ++i)
+    velocities[i] = LoadLanes(gathered[i]);
+
+  LaneValue zero = SplatLanes(real(0.0));
+  LaneValue normalImpulse = zero;
+  for(uint rowIndex = 0; rowIndex < 3; ++rowIndex)
+  {
+    SimdContactRow& row = group.mRows[rowIndex];
+
+    //the normal only pushes, friction is limited by how hard the normal pushed
+    LaneValue minImpulse = zero;
+    LaneValue maxImpulse = SplatLanes(Math::PositiveMax());
+    if(rowIndex != 0)
+    {
+      maxImpulse = MultiplyLanes(LoadLanes(group.mFrictionRatio), normalImpulse);
+      minImpulse = SubtractLanes(zero, maxImpulse);
+    }
+
+    //compute JV
+    LaneValue cDot = MultiplyLanes(LoadLanes(row.mJacobian[0]), velocities[0]);
+    for(uint i = 1; i < 12; ++i)
+      cDot = MultiplyAddLanes(LoadLanes(row.mJacobian[i]), velocities[i], cDot);
+
+    //add in the bias and gamma and get the mass weighted lambda
+    LaneValue impulse = LoadLanes(row.mImpulse);
+    cDot = AddLanes(cDot, LoadLanes(row.mBias));
+    cDot = MultiplyAddLanes(LoadLanes(row.mGamma), impulse, cDot);
+    LaneValue lambda = SubtractLanes(zero, MultiplyLanes(LoadLanes(row.mMass), cDot));
+
+    //clamp the accumulated impulse and apply the change
+    LaneValue newImpulse = ClampLanes(AddLanes(impulse, lambda), minImpulse, maxImpulse);
+    lambda = SubtractLanes(newImpulse, impulse);
+    StoreLanes(newImpulse, row.mImpulse);
+    if(rowIndex == 0)
+      normalImpulse = newImpulse;
+
+    for(uint i = 0; i < 12; ++i)
+      velocities[i] = MultiplyAddLanes(LoadLanes(row.mVelocityChange[i]), lambda, velocities[i]);
+  }
+
+  //scatter back to the dynamic bodies (which are unique within a group)
+  for(uint i = 0; i < 12; ++i)
+    StoreLanes(velocities[i], gathered[i]);
+
+  for(uint lane = 0; lane < group.mLaneCount; ++lane)
+  {
+    SimdSolverBody& body0 = bodies[group.mBodies[0][lane]];
+    SimdSolverBody& body1 = bodies[group.mBodies[1][lane]];
+    if(body0.mDynamic)
+    {
+      body0.mVelocity.Set(gathered[0].mLanes[lane], gathered[1].mLanes[lane], gathered[2].mLanes[lane]);
+      body0.mAngularVelocity.Set(gathered[3].mLanes[lane], gathered[4].mLanes[lane], gathered[5].mLanes[lane]);
+    }
+    if(body1.mDynamic)
+    {
+      body1.mVelocity.Set(gathered[6].mLanes[lane], gathered[7].mLanes[lane], gathered[8].mLanes[lane]);
+      body1.mAngularVelocity.Set(gathered[9].mLanes[lane], gathered[10].mLanes[lane], gathered[11].mLanes[lane]);
+    }
+  }
+}
+
+//Copies a molecule into one lane of a row.
+void SetRowLane(SimdContactRow& row, uint lane, ConstraintMolecule& molecule, JointMass& masses)
+{
+  const Jacobian& jacobian = molecule.mJacobian;
+  Vec3 velocityChanges[4];
+  velocityChanges[0] = masses.mInvMass[0].Apply(jacobian.Linear[0]);
+  velocityChanges[1] = Math::Transform(masses.InverseInertia[0], jacobian.Angular[0]);
+  velocityChanges[2] = masses.mInvMass[1].Apply(jacobian.Linear[1]);
+  velocityChanges[3] = Math::Transform(masses.InverseInertia[1], jacobian.Angular[1]);
+
+  for(uint axis = 0; axis < 3; ++axis)
+  {
+    row.mJacobian[axis].mLanes[lane] = jacobian.Linear[0][axis];
+    row.mJacobian[axis + 3].mLanes[lane] = jacobian.Angular[0][axis];
+    row.mJacobian[axis + 6].mLanes[lane] = jacobian.Linear[1][axis];
+    row.mJacobian[axis + 9].mLanes[lane] = jacobian.Angular[1][axis];
+
+    for(uint i = 0; i < 4; ++i)
+      row.mVelocityChange[axis + i * 3].mLanes[lane] = velocityChanges[i][axis];
+  }
+
+  row.mMass.mLanes[lane] = molecule.mMass;
+  row.mBias.mLanes[lane] = molecule.mBias;
+  row.mGamma.mLanes[lane] = molecule.mGamma;
+  row.mImpulse.mLanes[lane] = molecule.mImpulse;
+}
+
+SimdSolver::SimdSolver()
+{
+  mFirstOpenGroup = 0;
+  mContactMoleculeStart = 0;
+}
+
+void SimdSolver::Solve(real dt)
+{
+  SimdSolver::UpdateData();
+  NormalSolver::WarmStart();
+  SimdSolver::SolveVelocities();
+  SimdSolver::Commit();
+  NormalSolver::BatchEvents();
+}
+
+void SimdSolver::Clear()
+{
+  NormalSolver::Clear();
+
+  mContactGroups.Clear();
+  mBodies.Clear();
+  mBodyIndices.Clear();
+  mFirstOpenGroup = 0;
+}
+
+void SimdSolver::UpdateData()
+{
+  NormalSolver::UpdateData();
+  BuildContactGroups();
+}
+
+void SimdSolver::SolveVelocities()
+{
+  uint iterationCount = GetSolverIterationCount();
+
+  //without joints the contacts are the only thing changing velocities,
+  //so the bodies only have to be gathered and scattered once
+  if(mContactMoleculeStart == 0)
+  {
+    GatherVelocities();
+    for(uint iteration = 0; iteration < iterationCount; ++iteration)
+    {
+      for(uint i = 0; i < mContactGroups.Size(); ++i)
+        SolveContactGroup(mContactGroups[i], mBodies.Data());
+    }
+    ScatterVelocities();
+    return;
+  }
+
+  for(uint iteration = 0; iteration < iterationCount; ++iteration)
+    IterateVelocities(iteration);
+}
+
+void SimdSolver::IterateVelocities(uint iteration)
+{
+  MoleculeWalker molecules(mMolecules.Data(),sizeof(ConstraintMolecule),0);
+
+#define JointType(type) \
+  IterateVelocitiesFragmentList(m##type##List,molecules,iteration);
+
+#include "Physics/Joints/JointList.hpp"
+
+#undef JointType
+
+  //pick up the joints' changes before solving the contacts
+  GatherVelocities();
+  for(uint i = 0; i < mContactGroups.Size(); ++i)
+    SolveContactGroup(mContactGroups[i], mBodies.Data());
+  ScatterVelocities();
+}
+
+void SimdSolver::Commit()
+{
+  //copy the accumulated impulses back to the molecules the contacts commit from
+  for(uint i = 0; i < mContactGroups.Size(); ++i)
+  {
+    SimdContactGroup& group = mContactGroups[i];
+    for(uint lane = 0; lane < group.mLaneCount; ++lane)
+    {
+      uint moleculeIndex = group.mMoleculeIndices[lane];
+      for(uint rowIndex = 0; rowIndex < 3; ++rowIndex)
+        mMolecules[moleculeIndex + rowIndex].mImpulse = group.mRows[rowIndex].mImpulse.mLanes[lane];
+    }
+  }
+
+  NormalSolver::Commit();
+}
+
+void SimdSolver::BuildContactGroups()
+{
+  mContactGroups.Clear();
+  mBodies.Clear();
+  mBodyIndices.Clear();
+  mFirstOpenGroup = 0;
+
+  //index 0 stands in for a missing body and is used by unused lanes
+  SimdSolverBody& noBody = mBodies.PushBack();
+  noBody.mVelocity.ZeroOut();
+  noBody.mAngularVelocity.ZeroOut();
+  noBody.mBody = nullptr;
+  noBody.mDynamic = false;
+
+  //the contacts' molecules come after all of the joints'
+  uint contactMoleculeCount = 0;
+  ContactList::range range = mContacts.All();
+  for(; !range.Empty(); range.PopFront())
+    contactMoleculeCount += range.Front().MoleculeCount();
+  mContactMoleculeStart = mMolecules.Size() - contactMoleculeCount;
+
+  uint moleculeIndex = mContactMoleculeStart;
+  for(range = mContacts.All(); !range.Empty(); range.PopFront())
+  {
+    Contact& contact = range.Front();
+    uint bodyIndex0 = GetBodyIndex(contact.GetCollider(0));
+    uint bodyIndex1 = GetBodyIndex(contact.GetCollider(1));
+
+    JointMass masses;
+    JointHelpers::GetMasses(contact.GetCollider(0), contact.GetCollider(1), masses);
+
+    uint pointCount = contact.GetContactCount();
+    real frictionRatio = contact.mManifold->DynamicFriction / pointCount;
+    for(uint point = 0; point < pointCount; ++point)
+    {
+      SimdContactGroup& group = FindContactGroup(bodyIndex0, bodyIndex1);
+      uint lane = group.mLaneCount;
+      ++group.mLaneCount;
+
+      group.mBodies[0][lane] = bodyIndex0;
+      group.mBodies[1][lane] = bodyIndex1;
+      group.mMoleculeIndices[lane] = moleculeIndex;
+      group.mFrictionRatio.mLanes[lane] = frictionRatio;
+      for(uint rowIndex = 0; rowIndex < 3; ++rowIndex)
+        SetRowLane(group.mRows[rowIndex], lane, mMolecules[moleculeIndex + rowIndex], masses);
+
+      moleculeIndex += 3;
+    }
+  }
+}
+
+uint SimdSolver::GetBodyIndex(Collider* collider)
+{
+  RigidBody* body = collider->GetActiveBody();
+  if(body == nullptr)
+    return 0;
+
+  uint* existingIndex = mBodyIndices.FindPointer(body);
+  if(existingIndex != nullptr)
+    return *existingIndex;
+
+  uint index = mBodies.Size();
+  SimdSolverBody& solverBody = mBodies.PushBack();
+  solverBody.mVelocity.ZeroOut();
+  solverBody.mAngularVelocity.ZeroOut();
+  solverBody.mBody = body;
+  solverBody.mDynamic = body->IsDynamic();
+  mBodyIndices.Insert(body, index);
+  return index;
+}
+
+SimdContactGroup& SimdSolver::FindContactGroup(uint bodyIndex0, uint bodyIndex1)
+{
+  while(mFirstOpenGroup < mContactGroups.Size() && mContactGroups[mFirstOpenGroup].mLaneCount == cSimdLaneCount)
+    ++mFirstOpenGroup;
+
+  //only a few groups are checked so packing stays linear in the number of points
+  uint searchEnd = Math::Min(mFirstOpenGroup + cSimdGroupSearchCount, (uint)mContactGroups.Size());
+  for(uint i = mFirstOpenGroup; i < searchEnd; ++i)
+  {
+    SimdContactGroup& group = mContactGroups[i];
+    if(group.mLaneCount == cSimdLaneCount)
+      continue;
+
+    //static and kinematic bodies are only read so any number of lanes can use them
+    bool sharesBody = false;
+    for(uint lane = 0; lane < group.mLaneCount && !sharesBody; ++lane)
+    {
+      for(uint side = 0; side < 2; ++side)
+      {
+        uint bodyIndex = group.mBodies[side][lane];
+        if(mBodies[bodyIndex].mDynamic && (bodyIndex == bodyIndex0 || bodyIndex == bodyIndex1))
+          sharesBody = true;
+      }
+    }
+
+    if(!sharesBody)
+      return group;
+  }
+
+  //unused lanes are all zero so they never change anything
+  SimdContactGroup& group = mContactGroups.PushBack();
+  memset(&group, 0, sizeof(SimdContactGroup));
+  return group;
+}
+
+void SimdSolver::GatherVelocities()
+{
+  for(uint i = 1; i < mBodies.Size(); ++i)
+  {
+    SimdSolverBody& solverBody = mBodies[i];
+    solverBody.mVelocity = solverBody.mBody->mVelocity;
+    solverBody.mAngularVelocity = solverBody.mBody->mAngularVelocity;
+  }
+}
+
+void SimdSolver::ScatterVelocities()
+{
+  for(uint i = 1; i < mBodies.Size(); ++i)
+  {
+    SimdSolverBody& solverBody = mBodies[i];
+    if(solverBody.mDynamic)
+    {
+      solverBody.mBody->mVelocity = solverBody.mVelocity;
+      solverBody.mBody->mAngularVelocity = solverBody.mAngularVelocity;
+    }
+  }
+}
+
+}//namespace Physics
+
+}//namespace Plasma
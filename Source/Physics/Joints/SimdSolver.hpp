@@ -0,0 +1,88 @@
+#pragma once
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+///One constraint row (the normal or a friction axis) of a group of contact
+///points stored as structure of arrays so each value can be loaded for every lane at once.
+struct SimdContactRow
+{
+  ///The jacobian (linear0, angular0, linear1, angular1) by component.
+  SimdLanes mJacobian[12];
+  ///The jacobian transformed by the inverse mass and inertia of each body
+  ///(how much each body's velocity changes per unit of impulse).
+  SimdLanes mVelocityChange[12];
+  SimdLanes mMass;
+  SimdLanes mBias;
+  SimdLanes mGamma;
+  SimdLanes mImpulse;
+};
+
+///Up to cSimdLaneCount contact points that don't share any dynamic body.
+struct SimdContactGroup
+{
+  ///The normal row followed by the two friction rows.
+  SimdContactRow mRows[3];
+  ///The friction coefficient split between the contact's points.
+  SimdLanes mFrictionRatio;
+  ///Index of each lane's bodies in the solver's body list (0 for unused lanes).
+  uint mBodies[2][cSimdLaneCount];
+  ///Index of each lane's normal molecule (the friction molecules follow it).
+  uint mMoleculeIndices[cSimdLaneCount];
+  uint mLaneCount;
+};
+
+///The velocities of a body the contacts are solved against.
+struct SimdSolverBody
+{
+  Vec3 mVelocity;
+  Vec3 mAngularVelocity;
+  RigidBody* mBody;
+  ///Only dynamic bodies are written back (and have to be unique in a group).
+  bool mDynamic;
+};
+
+///A normal solver that solves contacts cSimdLaneCount points at a time. Contact points
+///are packed into groups where no two points share a dynamic body, and each group is
+///solved lane-wise with body velocities gathered from and scattered back to a flat list.
+///Joints are solved the same way as the normal solver.
+class SimdSolver : public NormalSolver
+{
+public:
+  SimdSolver();
+
+  // Solve Functions
+  void Solve(real dt) override;
+  void Clear() override;
+  // Iteration functions
+  void UpdateData() override;
+  void SolveVelocities() override;
+  void IterateVelocities(uint iteration) override;
+  void Commit() override;
+
+private:
+  ///Packs the contacts' molecules into groups of lanes.
+  void BuildContactGroups();
+  ///Returns the index of the body in the body list (adding it if needed).
+  uint GetBodyIndex(Collider* collider);
+  ///Finds a group with a free lane that doesn't use either dynamic body.
+  SimdContactGroup& FindContactGroup(uint bodyIndex0, uint bodyIndex1);
+  ///Copies the body velocities in and out of the body list.
+  void GatherVelocities();
+  void ScatterVelocities();
+
+  Array<SimdContactGroup> mContactGroups;
+  Array<SimdSolverBody> mBodies;
+  FlatHashMap<RigidBody*, uint> mBodyIndices;
+  ///The first group that may still have a free lane.
+  uint mFirstOpenGroup;
+  ///Index of the first contact molecule (the joints' molecules come first).
+  uint mContactMoleculeStart;
+};
+
+}//namespace Physics
+
+}//namespace Plasma
@@ -6,28 +6,35 @@ namespace Plasma
 namespace Physics
 {
 
+///The most phases constraints are colored into. The last phase takes whatever
+///doesn't fit in the others, so it may share bodies and is always solved serially.
+const uint cMaxConstraintPhases = 64;
+///Each phase is split into batches of about this many molecules.
+const uint cConstraintBatchSize = 64;
+
 template <typename JointType>
 struct ConstraintBatch
 {
-  ConstraintBatch() { ConstraintCount = 0; }
+  ConstraintBatch() { ConstraintCount = 0; MoleculeStart = 0; }
   ~ConstraintBatch() { Joints.Clear(); }
   uint ConstraintCount;
+  ///Index of this batch's first molecule (a batch's molecules are contiguous).
+  uint MoleculeStart;
   typedef InList<JointType,&JointType::SolverLink> JointList;
   JointList Joints;
-
-  IntrusiveLink(ConstraintBatch<JointType>,link);
 };
 
 template <typename JointType>
 struct ConstraintPhase
 {
-  ConstraintPhase() { BatchCount = 0; }
-  ~ConstraintPhase() { DeleteObjectsIn(Batches); }
-  uint BatchCount;
+  ConstraintPhase() { Serial = false; }
+  ~ConstraintPhase() { DeleteObjectsInContainer(Batches); }
 
   typedef ConstraintBatch<JointType> JointBatch;
-  typedef InList<JointBatch> JointBatches;
-  JointBatches Batches;
+  ///No two batches in a phase share a dynamic body so they can be solved
+  ///at the same time (unless the phase is serial).
+  Array<JointBatch*> Batches;
+  bool Serial;
 
   IntrusiveLink(ConstraintPhase<JointType>,link);
 };
@@ -46,6 +53,7 @@ struct ConstraintGroup
     
       delete phase;
     }
+    PhaseCount = 0;
   }
   uint PhaseCount;
   typedef ConstraintPhase<JointType> PhaseType;
@@ -63,9 +71,8 @@ void GroupOperationFragment(ConstraintGroup<typename ListType::value_type>& grou
   for(; !jointRange.Empty(); jointRange.PopFront())
   {
     JointPhase& phase = jointRange.Front();
-    typename JointPhase::JointBatches::range range = phase.Batches.All();
-    for(; !range.Empty(); range.PopFront())
-      operation(range.Front().Joints);
+    for(uint i = 0; i < phase.Batches.Size(); ++i)
+      operation(phase.Batches[i]->Joints);
   }
 }
 
@@ -79,9 +86,8 @@ void GroupOperationParamFragment(ConstraintGroup<typename ListType::value_type>&
   for(; !jointRange.Empty(); jointRange.PopFront())
   {
     JointPhase& phase = jointRange.Front();
-    typename JointPhase::JointBatches::range range = phase.Batches.All();
-    for(; !range.Empty(); range.PopFront())
-      operation(range.Front().Joints,param);
+    for(uint i = 0; i < phase.Batches.Size(); ++i)
+      operation(phase.Batches[i]->Joints,param);
   }
 }
 
@@ -95,86 +101,103 @@ void GroupOperationTwoParamFragment(ConstraintGroup<typename ListType::value_typ
   for(; !jointRange.Empty(); jointRange.PopFront())
   {
     JointPhase& phase = jointRange.Front();
-    typename JointPhase::JointBatches::range range = phase.Batches.All();
-    for(; !range.Empty(); range.PopFront())
-      operation(range.Front().Joints,param1,param2);
+    for(uint i = 0; i < phase.Batches.Size(); ++i)
+      operation(phase.Batches[i]->Joints,param1,param2);
   }
 }
 
+///Returns the body a constraint on this collider writes to, or null if it only
+///reads from it (static and kinematic bodies are never written by the solver).
+inline RigidBody* GetColoringBody(Collider* collider)
+{
+  RigidBody* body = collider->GetActiveBody();
+  if(body == nullptr || !body->IsDynamic())
+    return nullptr;
+  return body;
+}
+
+///Colors the constraints into phases where no two constraints share a dynamic
+///body (each constraint goes in the first phase neither of its bodies is in)
+///and then splits each phase into batches. The phases are solved in order, so
+///the order things are solved in only depends on the order they were added.
 template <typename ListType>
-void SplitConstraints(ListType& joints, ConstraintGroup<typename ListType::value_type>& phases)
+void SplitConstraints(ListType& joints, ConstraintGroup<typename ListType::value_type>& group)
 {
   typedef ConstraintPhase<typename ListType::value_type> PhaseType;
   typedef ConstraintBatch<typename ListType::value_type> BatchType;
 
-  HashSet<uint> bodySet;
-  uint batchSize = 32;
-  uint batchesPerPhase = 2;
-
-  PhaseType* phase = nullptr;
-  BatchType* batch = nullptr;
-
-  bool newPhaseStarted = false;
+  //which phases each dynamic body is in (one bit per phase)
+  FlatHashMap<RigidBody*, u64> bodyPhases;
+  PhaseType* phases[cMaxConstraintPhases] = {};
+  const uint lastPhase = cMaxConstraintPhases - 1;
 
   while(!joints.Empty())
   {
-    if(newPhaseStarted == false)
+    typename ListType::pointer joint = &(joints.Front());
+    ListType::Unlink(joint);
+
+    RigidBody* body0 = GetColoringBody(joint->GetCollider(0));
+    RigidBody* body1 = GetColoringBody(joint->GetCollider(1));
+    u64 usedPhases = 0;
+    if(body0 != nullptr)
+      usedPhases |= bodyPhases.FindValue(body0, 0);
+    if(body1 != nullptr)
+      usedPhases |= bodyPhases.FindValue(body1, 0);
+
+    uint phaseIndex = 0;
+    while(phaseIndex < lastPhase && (usedPhases & ((u64)1 << phaseIndex)))
+      ++phaseIndex;
+
+    u64 phaseBit = (u64)1 << phaseIndex;
+    if(body0 != nullptr)
+      bodyPhases[body0] |= phaseBit;
+    if(body1 != nullptr)
+      bodyPhases[body1] |= phaseBit;
+
+    PhaseType*& phase = phases[phaseIndex];
+    if(phase == nullptr)
     {
       phase = new PhaseType();
-      phases.Phases.PushBack(phase);
-      ++phases.PhaseCount;
-      batch = new BatchType();
-      phase->Batches.PushBack(batch);
-      ++phase->BatchCount;
-      bodySet.Clear();
+      phase->Serial = (phaseIndex == lastPhase);
+    }
+
+    uint constraintCount = joint->MoleculeCount();
+    if(phase->Batches.Empty() || phase->Batches.Back()->ConstraintCount + constraintCount > cConstraintBatchSize)
+      phase->Batches.PushBack(new BatchType());
+
+    BatchType* batch = phase->Batches.Back();
+    batch->Joints.PushBack(joint);
+    batch->ConstraintCount += constraintCount;
+  }
+
+  for(uint i = 0; i < cMaxConstraintPhases; ++i)
+  {
+    if(phases[i] != nullptr)
+    {
+      group.Phases.PushBack(phases[i]);
+      ++group.PhaseCount;
     }
-    newPhaseStarted = false;
+  }
+}
 
-    typename ListType::range range = joints.All();
-    while(!range.Empty())
+///Lays the batches' molecules out one after another (in the order the phases
+///are walked) starting at the given index. Returns the index after the last one.
+template <typename JointType>
+uint AssignMoleculeStarts(ConstraintGroup<JointType>& group, uint moleculeIndex)
+{
+  typedef ConstraintPhase<JointType> JointPhase;
+
+  typename ConstraintGroup<JointType>::PhaseTypeList::range range = group.Phases.All();
+  for(; !range.Empty(); range.PopFront())
+  {
+    JointPhase& phase = range.Front();
+    for(uint i = 0; i < phase.Batches.Size(); ++i)
     {
-      typename ListType::pointer joint = &(range.Front());
-      range.PopFront();
-
-      //get the id of the two bodies involved in this joint
-      uint idA = joint->GetCollider(0)->mId;
-      uint idB = joint->GetCollider(1)->mId;
-
-      //if either of the bodies have been used in this phase, then skip this joint
-      if(!bodySet.Find(idA).Empty() || !bodySet.Find(idB).Empty())
-        continue;
-
-      //if adding this joint would make the batch too large, make a new batch and add the old to the phase
-      uint ConstraintCount = joint->MoleculeCount();
-      if(ConstraintCount + batch->ConstraintCount > batchSize)
-      {
-        //if this will be too many batches for this phase, then make a new phase
-        if(phase->BatchCount >= batchesPerPhase)
-        {
-          phase = new PhaseType();
-          phases.Phases.PushBack(phase);
-          ++phases.PhaseCount;
-          //since this is a new phase, all bodies are valid again
-          bodySet.Clear();
-          newPhaseStarted = true;
-        }
-
-        batch = new BatchType();
-        phase->Batches.PushBack(batch);
-        ++phase->BatchCount;
-      }
-
-      //mark both of these bodies as being used for this phase
-      bodySet.Insert(idA);
-      bodySet.Insert(idB);
-
-      //put the joint in this batch
-      ListType::Unlink(joint);
-
-      batch->Joints.PushBack(joint);
-      batch->ConstraintCount += ConstraintCount;
+      phase.Batches[i]->MoleculeStart = moleculeIndex;
+      moleculeIndex += phase.Batches[i]->ConstraintCount;
     }
   }
+  return moleculeIndex;
 }
 
 template <typename ListType>
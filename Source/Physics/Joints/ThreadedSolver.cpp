@@ -23,18 +23,80 @@ namespace Plasma
 namespace Physics
 {
 
-template <typename JointList>
-void ThreadSolveFunction(JointList& joints, MoleculeWalker molecules, uint startIndex)
+//Solvers with fewer molecules than this are solved entirely on the calling thread.
+const uint cMinParallelMoleculeCount = 512;
+
+namespace ThreadedSolverStep
+{
+enum Enum
+{
+  UpdateData,
+  WarmStart,
+  IterateVelocities,
+  Commit
+};
+}//namespace ThreadedSolverStep
+
+//Runs one step of the solver on a range of a phase's batches (used with JobSystem::ParallelFor).
+template <typename ListType>
+struct PhaseBatchSolver
+{
+  typedef ConstraintBatch<typename ListType::value_type> BatchType;
+
+  void operator()(uint begin, uint end)
+  {
+    for(uint i = begin; i < end; ++i)
+    {
+      BatchType* batch = mBatches[i];
+      MoleculeWalker molecules(mMolecules, sizeof(ConstraintMolecule), batch->MoleculeStart * sizeof(ConstraintMolecule));
+
+      if(mStep == ThreadedSolverStep::UpdateData)
+        UpdateDataFragmentList(batch->Joints, molecules);
+      else if(mStep == ThreadedSolverStep::WarmStart)
+        WarmStartFragmentList(batch->Joints, molecules);
+      else if(mStep == ThreadedSolverStep::IterateVelocities)
+        IterateVelocitiesFragmentList(batch->Joints, molecules, mIteration);
+      else
+        CommitFragmentList(batch->Joints, molecules);
+    }
+  }
+
+  BatchType** mBatches;
+  ConstraintMolecule* mMolecules;
+  ThreadedSolverStep::Enum mStep;
+  uint mIteration;
+};
+
+//Runs a step over every phase in order. The batches within a phase don't share
+//any dynamic bodies, so running them on different threads gives the same result.
+template <typename ListType>
+void RunPhases(ConstraintGroup<typename ListType::value_type>& group, Array<ConstraintMolecule>& molecules,
+               ThreadedSolverStep::Enum step, uint iteration, bool parallel)
 {
-  MoleculeWalker mols = molecules;
-  mols += startIndex;
+  typedef ConstraintPhase<typename ListType::value_type> JointPhase;
+
+  PhaseBatchSolver<ListType> solver;
+  solver.mMolecules = molecules.Data();
+  solver.mStep = step;
+  solver.mIteration = iteration;
 
-  IterateVelocitiesFragment(joints,mols,0);
+  typename ConstraintGroup<typename ListType::value_type>::PhaseTypeList::range range = group.Phases.All();
+  for(; !range.Empty(); range.PopFront())
+  {
+    JointPhase& phase = range.Front();
+    solver.mBatches = phase.Batches.Data();
+    uint batchCount = phase.Batches.Size();
+
+    if(parallel && !phase.Serial)
+      PL::gJobs->ParallelFor(0, batchCount, solver, 1);
+    else
+      solver(0, batchCount);
+  }
 }
 
 ThreadedSolver::ThreadedSolver()
 {
-  mConstraintCount = 0;
+  mParallel = false;
 }
 
 ThreadedSolver::~ThreadedSolver()
@@ -46,7 +108,6 @@ void ThreadedSolver::AddJoint(Joint* joint)
 {
   joint->mSolver = this;
   joint->UpdateAtomsVirtual();
-  mConstraintCount += joint->MoleculeCountVirtual();
   mJoints.PushBack(joint);
 }
 
@@ -54,7 +115,6 @@ void ThreadedSolver::AddContact(Contact* contact)
 {
   contact->mSolver = this;
   contact->UpdateAtoms();
-  mConstraintCount += contact->MoleculeCount();
   mContacts.PushBack(contact);
 }
 
@@ -66,7 +126,6 @@ void ThreadedSolver::AddJoints(JointList& joints)
     Joint* joint = &(range.Front());
     joint->mSolver = this;
     joint->UpdateAtomsVirtual();
-    mConstraintCount += joint->MoleculeCountVirtual();
   }
   mJoints.Splice(mJoints.End(),joints.All());
 }
@@ -79,7 +138,6 @@ void ThreadedSolver::AddContacts(ContactList& contacts)
     Contact* contact = &(range.Front());
     contact->mSolver = this;
     contact->UpdateAtoms();
-    mConstraintCount += contact->MoleculeCount();
   }
   mContacts.Splice(mContacts.End(),contacts.All());
 }
@@ -116,15 +174,18 @@ void ThreadedSolver::Clear()
 
 void ThreadedSolver::UpdateData()
 {
-  mMolecules.Resize(mConstraintCount);
-
-  MoleculeWalker molecules(mMolecules.Data(),sizeof(ConstraintMolecule),0);
-
   SplitConstraints(mContacts,mContactPhases);
   SplitConstraints(mJoints,mJointPhases);
 
-  GroupOperationParamFragment<ContactList>(mContactPhases,molecules,UpdateDataFragmentList<ContactList>);
-  GroupOperationParamFragment<JointList>(mJointPhases,molecules,UpdateDataFragmentList<JointList>);
+  //molecules are laid out by batch so each batch can walk its own
+  uint moleculeCount = AssignMoleculeStarts(mContactPhases, 0);
+  moleculeCount = AssignMoleculeStarts(mJointPhases, moleculeCount);
+  mMolecules.Resize(moleculeCount);
+
+  mParallel = PL::gJobs->GetWorkerCount() != 0 && moleculeCount >= cMinParallelMoleculeCount;
+
+  RunPhases<ContactList>(mContactPhases, mMolecules, ThreadedSolverStep::UpdateData, 0, mParallel);
+  RunPhases<JointList>(mJointPhases, mMolecules, ThreadedSolverStep::UpdateData, 0, mParallel);
 }
 
 void ThreadedSolver::WarmStart()
@@ -132,10 +193,8 @@ void ThreadedSolver::WarmStart()
   if(mSolverConfig->mWarmStart == false)
     return;
 
-  MoleculeWalker molecules(mMolecules.Data(),sizeof(ConstraintMolecule),0);
-
-  GroupOperationParamFragment<ContactList>(mContactPhases,molecules, WarmStartFragmentList<ContactList>);
-  GroupOperationParamFragment<JointList>(mJointPhases,molecules, WarmStartFragmentList<JointList>);
+  RunPhases<ContactList>(mContactPhases, mMolecules, ThreadedSolverStep::WarmStart, 0, mParallel);
+  RunPhases<JointList>(mJointPhases, mMolecules, ThreadedSolverStep::WarmStart, 0, mParallel);
 }
 
 void ThreadedSolver::SolveVelocities()
@@ -147,10 +206,8 @@ void ThreadedSolver::SolveVelocities()
 
 void ThreadedSolver::IterateVelocities(uint iteration)
 {
-  MoleculeWalker molecules(mMolecules.Data(),sizeof(ConstraintMolecule),0);
-
-  GroupOperationTwoParamFragment<ContactList>(mContactPhases,molecules,iteration,IterateVelocitiesFragmentList<ContactList>);
-  GroupOperationTwoParamFragment<JointList>(mJointPhases,molecules,iteration,IterateVelocitiesFragmentList<JointList>);
+  RunPhases<ContactList>(mContactPhases, mMolecules, ThreadedSolverStep::IterateVelocities, iteration, mParallel);
+  RunPhases<JointList>(mJointPhases, mMolecules, ThreadedSolverStep::IterateVelocities, iteration, mParallel);
 }
 
 void ThreadedSolver::SolvePositions()
@@ -187,14 +244,14 @@ void ThreadedSolver::SolvePositions()
 
 void ThreadedSolver::Commit()
 {
-  MoleculeWalker molecules(mMolecules.Data(),sizeof(ConstraintMolecule),0);
-
-  GroupOperationParamFragment<ContactList>(mContactPhases,molecules,CommitFragmentList<ContactList>);
-  GroupOperationParamFragment<JointList>(mJointPhases,molecules,CommitFragmentList<JointList>);
+  RunPhases<ContactList>(mContactPhases, mMolecules, ThreadedSolverStep::Commit, 0, mParallel);
+  RunPhases<JointList>(mJointPhases, mMolecules, ThreadedSolverStep::Commit, 0, mParallel);
 }
 
 void ThreadedSolver::BatchEvents()
 {
+  //events are always batched on the calling thread in phase order
+
   GroupOperationFragment<JointList>(mJointPhases,BatchEventsFragmentList<JointList>);
 }
 
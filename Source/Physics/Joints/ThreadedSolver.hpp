@@ -7,7 +7,9 @@ namespace Physics
 {
 
 /// A constraint solver designed to thread the constraints
-/// into as many threads as possible.
+/// into as many threads as possible. Constraints are colored into phases where
+/// no two constraints share a dynamic body and each phase's batches are solved
+/// on the job system.
 class ThreadedSolver : public IConstraintSolver
 {
 public:
@@ -43,7 +45,8 @@ private:
   JointList mJoints;
   ContactList mContacts;
   MoleculeList mMolecules;
-  uint mConstraintCount;
+  /// Whether this solve has enough constraints to be worth threading.
+  bool mParallel;
 
   typedef ConstraintGroup<Contact> ContactGroup;
   typedef ConstraintGroup<Joint> JointGroup;
@@ -508,6 +508,12 @@ void Manifold::PersistentAdd(ManifoldPoint* points, uint count)
   //AddPoint(points[maxDepthIndex]);
 }
 
+void NarrowPhaseBuffer::Clear()
+{
+  mManifolds.Clear();
+  mPairs.Clear();
+}
+
 }//namespace Physics
 
 }//namespace Plasma
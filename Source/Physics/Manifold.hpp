@@ -92,6 +92,27 @@ public:
 
 typedef PodArray<Manifold> ManifoldArray;
 
+///The narrow phase results for a contiguous range of broadphase pairs. Each
+///buffer is filled by one task and then committed in pair order.
+struct NarrowPhaseBuffer
+{
+  ///Which manifolds in the buffer belong to a colliding pair.
+  struct PairResult
+  {
+    uint mPairIndex;
+    uint mManifoldStart;
+    uint mManifoldCount;
+    ///The pair couldn't be tested by the task, so it's tested (and its
+    ///manifolds are added) when the buffer is committed.
+    bool mDeferred;
+  };
+
+  void Clear();
+
+  ManifoldArray mManifolds;
+  Array<PairResult> mPairs;
+};
+
 }//namespace Physics
 
 }//namespace Plasma
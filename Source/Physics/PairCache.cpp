@@ -0,0 +1,189 @@
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+//An axis only counts as separating if the pair is at least this far apart
+//along it, so pairs that the collision tests would still consider touching
+//are always fully tested.
+const real cPairCacheSeparationSlop = real(0.01);
+//How many steps to wait before running gjk again after it didn't find an axis.
+const uint cPairCacheSearchDelay = 8;
+
+bool IsPairCacheable(Collider* collider)
+{
+  //only the simple shapes have a support function for the whole collider
+  //(and a convex mesh collider without a mesh doesn't return a support point)
+  Collider::ColliderType type = collider->GetColliderType();
+  if(type == Collider::cConvexMesh)
+    return static_cast<ConvexMeshCollider*>(collider)->GetConvexMesh() != nullptr;
+  return type < Collider::cConvexMesh;
+}
+
+//Returns how far apart the colliders are along the axis (negative if their
+//projections overlap). The axis points from the first to the second collider.
+real GetSeparation(Collider* collider1, Collider* collider2, Vec3Param axis)
+{
+  real length = axis.Length();
+  if(length == real(0.0))
+    return real(0.0);
+
+  Vec3 direction = axis / length;
+  Vec3 support1 = Vec3::cZero;
+  Vec3 support2 = Vec3::cZero;
+  collider1->Support(direction, &support1);
+  collider2->Support(-direction, &support2);
+  return Math::Dot(direction, support2) - Math::Dot(direction, support1);
+}
+
+PairCache::PairCache()
+{
+  mTestCount = 0;
+  mHitCount = 0;
+  mStep = 0;
+}
+
+void PairCache::BeginStep(const ClientPairArray& pairs)
+{
+  ++mStep;
+  mPairEntries.Resize(pairs.Size());
+
+  for(uint i = 0; i < pairs.Size(); ++i)
+  {
+    Collider* collider1 = static_cast<Collider*>(pairs[i].mClientData[0]);
+    Collider* collider2 = static_cast<Collider*>(pairs[i].mClientData[1]);
+    u64 pairId = GetLexicographicId(collider1->mId, collider2->mId);
+
+    uint entryIndex;
+    uint* existingIndex = mEntryIndices.FindPointer(pairId);
+    if(existingIndex != nullptr)
+      entryIndex = *existingIndex;
+    else
+    {
+      entryIndex = mEntries.Size();
+      PairCacheEntry& entry = mEntries.PushBack();
+      entry.mLocalSeparatingAxis = Vec3::cZero;
+      entry.mPairId = pairId;
+      entry.mSearchDelay = 0;
+      mEntryIndices.Insert(pairId, entryIndex);
+    }
+
+    PairCacheEntry& entry = mEntries[entryIndex];
+    entry.mLastStep = mStep;
+    entry.mTested = false;
+    entry.mHit = false;
+    mPairEntries[i] = entryIndex;
+  }
+}
+
+void PairCache::EndStep()
+{
+  mTestCount = 0;
+  mHitCount = 0;
+
+  uint i = 0;
+  while(i < mEntries.Size())
+  {
+    PairCacheEntry& entry = mEntries[i];
+    if(entry.mLastStep == mStep)
+    {
+      mTestCount += entry.mTested;
+      mHitCount += entry.mHit;
+      ++i;
+      continue;
+    }
+
+    //the pair left the broad phase, move the last entry into its place
+    mEntryIndices.Erase(entry.mPairId);
+    if(i != mEntries.Size() - 1)
+    {
+      entry = mEntries.Back();
+      mEntryIndices[entry.mPairId] = i;
+    }
+    mEntries.PopBack();
+  }
+
+  mPairEntries.Clear();
+}
+
+void PairCache::Clear()
+{
+  mEntries.Clear();
+  mEntryIndices.Clear();
+  mPairEntries.Clear();
+  mTestCount = 0;
+  mHitCount = 0;
+}
+
+PairCacheEntry& PairCache::GetEntry(uint pairIndex)
+{
+  return mEntries[mPairEntries[pairIndex]];
+}
+
+bool PairCache::IsSeparated(PairCacheEntry& entry, Collider* collider1, Collider* collider2)
+{
+  if(entry.mLocalSeparatingAxis == Vec3::cZero)
+    return false;
+  //a convex mesh could have been removed since the axis was found
+  if(!IsPairCacheable(collider1) || !IsPairCacheable(collider2))
+    return false;
+
+  //the axis is stored relative to the collider with the lower id
+  if(collider2->mId < collider1->mId)
+    Math::Swap(collider1, collider2);
+
+  entry.mTested = true;
+  Vec3 axis = Math::Transform(collider1->GetWorldRotation(), entry.mLocalSeparatingAxis);
+  entry.mHit = GetSeparation(collider1, collider2, axis) > cPairCacheSeparationSlop;
+  return entry.mHit;
+}
+
+void PairCache::UpdateSeparatingAxis(PairCacheEntry& entry, Collider* collider1, Collider* collider2)
+{
+  entry.mLocalSeparatingAxis = Vec3::cZero;
+  if(!IsPairCacheable(collider1) || !IsPairCacheable(collider2))
+    return;
+
+  if(collider2->mId < collider1->mId)
+    Math::Swap(collider1, collider2);
+
+  //the direction between the centers separates most pairs that aren't close
+  Vec3 axis = collider2->GetWorldTranslation() - collider1->GetWorldTranslation();
+  if(GetSeparation(collider1, collider2, axis) <= cPairCacheSeparationSlop)
+  {
+    //pairs that are too close for gjk to find an axis (or that are
+    //only apart because of a filter) would just run it again every step
+    if(entry.mSearchDelay != 0)
+    {
+      --entry.mSearchDelay;
+      return;
+    }
+
+    //gjk stops as soon as it finds a separating axis
+    Intersection::SupportShape shape1 = collider1->GetSupportShape();
+    Intersection::SupportShape shape2 = collider2->GetSupportShape();
+    Intersection::Gjk gjk;
+    gjk.Test(&shape1, &shape2);
+    axis = gjk.mSupportVector;
+    if(GetSeparation(collider1, collider2, axis) <= cPairCacheSeparationSlop)
+    {
+      entry.mSearchDelay = cPairCacheSearchDelay;
+      return;
+    }
+  }
+
+  entry.mLocalSeparatingAxis = Math::TransposedTransform(collider1->GetWorldRotation(), axis);
+}
+
+void PairCache::ClearSeparatingAxis(PairCacheEntry& entry)
+{
+  entry.mLocalSeparatingAxis = Vec3::cZero;
+  entry.mSearchDelay = 0;
+}
+
+}//namespace Physics
+
+}//namespace Plasma
@@ -0,0 +1,69 @@
+#pragma once
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+///Narrow phase data kept between steps for one pair of colliders.
+struct PairCacheEntry
+{
+  ///An axis that separated the pair the last time it was tested, in the space
+  ///of the collider with the lower id so that it turns along with the pair.
+  ///Zero if the pair was touching or no axis was found.
+  Vec3 mLocalSeparatingAxis;
+  u64 mPairId;
+  ///The last step the pair came out of the broad phase.
+  uint mLastStep;
+  ///How many more steps to wait before searching for an axis with gjk again.
+  uint mSearchDelay;
+  ///Whether there was an axis to check this step and if it still separated the pair.
+  bool mTested;
+  bool mHit;
+};
+
+///Keeps the axis that last separated each pair of simple (convex) colliders
+///from the broad phase. Pairs that are resting near each other barely move
+///relative to each other, so the same axis keeps separating them. Checking
+///that only takes one support query per collider, so the full collision test
+///is skipped whenever the axis still works. Entries for pairs that leave the
+///broad phase are removed at the end of the step.
+class PairCache
+{
+public:
+  PairCache();
+
+  ///Finds or creates the entries of all of this step's pairs. Entries can't be
+  ///added while the pairs are tested (possibly on several threads), only updated.
+  void BeginStep(const ClientPairArray& pairs);
+  ///Removes the entries of pairs that weren't returned this step and counts the hits.
+  void EndStep();
+  void Clear();
+
+  ///The entry of a pair passed to the last BeginStep.
+  PairCacheEntry& GetEntry(uint pairIndex);
+
+  ///Returns true if the entry's axis still separates the colliders.
+  bool IsSeparated(PairCacheEntry& entry, Collider* collider1, Collider* collider2);
+  ///Called when the pair didn't collide to find an axis for the next step.
+  void UpdateSeparatingAxis(PairCacheEntry& entry, Collider* collider1, Collider* collider2);
+  ///Called when the pair collided (there's no separating axis).
+  void ClearSeparatingAxis(PairCacheEntry& entry);
+
+  ///How many pairs had an axis to check last step and how many of them
+  ///skipped the collision test because of it. For tuning.
+  uint mTestCount;
+  uint mHitCount;
+
+private:
+  Array<PairCacheEntry> mEntries;
+  HashMap<u64, uint> mEntryIndices;
+  ///The index of the entry of each of this step's pairs.
+  Array<uint> mPairEntries;
+  uint mStep;
+};
+
+}//namespace Physics
+
+}//namespace Plasma
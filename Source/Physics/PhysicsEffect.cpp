@@ -149,6 +149,44 @@ void PhysicsEffect::ComponentRemoved(BoundType* typeId, Component* component)
   }
 }
 
+void PhysicsEffect::ApplyEffect(Physics::BodyStateArrays& bodies, real dt)
+{
+  for(uint i = 0; i < bodies.Size(); ++i)
+  {
+    if(IsIgnored(bodies, i))
+      continue;
+
+    // Collect what the effect applies to the body and move it into the arrays
+    RigidBody* body = bodies.mBodies[i];
+    ApplyEffect(body, dt);
+    bodies.mForces[i] += body->mForceAccumulator;
+    bodies.mTorques[i] += body->mTorqueAccumulator;
+    body->mForceAccumulator.ZeroOut();
+    body->mTorqueAccumulator.ZeroOut();
+  }
+}
+
+bool PhysicsEffect::IsIgnored(Physics::BodyStateArrays& bodies, uint index)
+{
+  IgnoreSpaceEffects* effectsToIgnore = bodies.mEffectsToIgnore[index];
+  return effectsToIgnore != nullptr && effectsToIgnore->IsIgnored(this);
+}
+
+bool PhysicsEffect::GetNextAffectedRange(Physics::BodyStateArrays& bodies, uint& start, uint& end)
+{
+  uint size = bodies.Size();
+  start = end;
+  while(start < size && IsIgnored(bodies, start))
+    ++start;
+  if(start >= size)
+    return false;
+
+  end = start + 1;
+  while(end < size && !IsIgnored(bodies, end))
+    ++end;
+  return true;
+}
+
 Vec3 PhysicsEffect::TransformLocalDirectionToWorld(Vec3Param localDir) const
 {
   Vec3 worldDir = localDir;
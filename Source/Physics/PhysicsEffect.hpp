@@ -48,6 +48,16 @@ public:
   /// effects that actually want to apply an acceleration (masked as a force).
   virtual void ApplyEffect(RigidBody* obj, real dt) = 0;
   virtual void ApplyEffect(SpringSystem* obj, real dt) {};
+  /// Apply the effect to all of the awake bodies of a space at once by adding to
+  /// their forces and torques in the arrays (used for space and level effects).
+  /// Bodies that ignore this effect are skipped. The default calls ApplyEffect on each body.
+  virtual void ApplyEffect(Physics::BodyStateArrays& bodies, real dt);
+
+  /// Whether the body at the given index of the arrays ignores this effect (see IgnoreSpaceEffects).
+  bool IsIgnored(Physics::BodyStateArrays& bodies, uint index);
+  /// Finds the next run [start, end) of bodies that don't ignore this effect, starting
+  /// from the end of the last run (start from 0, 0). Returns false when there are no more.
+  bool GetNextAffectedRange(Physics::BodyStateArrays& bodies, uint& start, uint& end);
 
   // Helpers
   Vec3 TransformLocalDirectionToWorld(Vec3Param localDir) const;
@@ -17,10 +17,15 @@ LightningDefineType(PhysicsMesh, builder, type)
   LightningBindMethod(RuntimeClone);
 }
 
+PhysicsMesh::PhysicsMesh()
+{
+  mTreeLoaded = false;
+}
+
 void PhysicsMesh::Serialize(Serializer& stream)
 {
   GenericPhysicsMesh::Serialize(stream);
-  SerializeAabbTree(stream, mTree);
+  mTreeLoaded = SerializeAabbTree(stream, mTree);
 }
 
 void PhysicsMesh::Initialize()
@@ -52,6 +57,14 @@ void PhysicsMesh::ForceRebuild()
 
 void PhysicsMesh::RebuildMidPhase()
 {
+  // A tree loaded with the mesh is already built (the content processor
+  // builds it the same way as GenerateTree), so it only has to be generated
+  // again once the mesh is modified
+  bool treeValid = mTreeLoaded && mTree.GetTotalProxyCount() == GetTriangleCount();
+  mTreeLoaded = false;
+  if(treeValid)
+    return;
+
   GenerateTree();
 }
 
@@ -66,7 +79,7 @@ bool PhysicsMesh::CastRay(const Ray& localRay, ProxyResult& result, BaseCastFilt
   result.mTime = Math::PositiveMax();
 
   // Query the aabb tree for possible triangles. Test all triangles whose aabbs we hit.
-  forRangeBroadphaseTree(StaticAabbTree<uint>, mTree, Ray, localRay)
+  forRangeWideAabbTree(mTree.GetWideTree(), Ray, localRay)
   {
     uint triIndex = range.Front();
     Triangle tri = GetTriangle(triIndex);
@@ -78,7 +91,7 @@ bool PhysicsMesh::CastRay(const Ray& localRay, ProxyResult& result, BaseCastFilt
 
 void PhysicsMesh::GetOverlappingTriangles(Aabb& aabb, TriangleArray& triangles, Array<uint>& triangleIds)
 {
-  forRangeBroadphaseTree(StaticAabbTree<uint>, mTree, Aabb, aabb)
+  forRangeWideAabbTree(mTree.GetWideTree(), Aabb, aabb)
   {
     // Get the triangle index
     uint triIndex = range.Front();
@@ -98,13 +111,23 @@ StaticAabbTree<uint>* PhysicsMesh::GetAabbTree()
   return &mTree;
 }
 
+/// Runs the subtree builds of StaticAabbTree::Construct on the job system.
+struct TreeBuildParallelFor
+{
+  template <typename FunctorType>
+  void operator()(uint begin, uint end, FunctorType& functor)
+  {
+    PL::gJobs->ParallelFor(begin, end, functor, 1);
+  }
+};
+
 void PhysicsMesh::GenerateTree()
 {
   // Clear the old tree
   mTree.DeleteTree();
 
   // Build the Aabb-Tree
-  mTree.SetPartitionMethod(PartitionMethods::MinimizeVolumeSum);
+  mTree.SetPartitionMethod(PartitionMethods::BinnedSurfaceAreaHeuristic);
 
   // Dummy proxy. They will not be needed.
   BroadPhaseProxy proxy;
@@ -123,8 +146,9 @@ void PhysicsMesh::GenerateTree()
     mTree.CreateProxy(proxy, data);
   }
 
-  // Construct the tree
-  mTree.Construct();
+  // Construct the tree (large meshes build their subtrees on the job system)
+  TreeBuildParallelFor parallelFor;
+  mTree.Construct(parallelFor);
 }
 
 //-------------------------------------------------------------------PhysicsMeshManager
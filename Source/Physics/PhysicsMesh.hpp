@@ -12,6 +12,8 @@ public:
   LightningDeclareType(PhysicsMesh, TypeCopyMode::ReferenceType);
   typedef StaticAabbTree<uint> AabbTree;
 
+  PhysicsMesh();
+
   //-------------------------------------------------------------------Resource Interface
   void Serialize(Serializer& stream) override;
   void Initialize();
@@ -46,6 +48,9 @@ private:
 
   /// Aabb Tree used for fast ray casts and triangle lookups.
   StaticAabbTree<uint> mTree;
+  /// Whether mTree was loaded already built, so the next
+  /// mid-phase rebuild doesn't have to generate it again.
+  bool mTreeLoaded;
 };
 
 //-------------------------------------------------------------------PhysicsMeshManager
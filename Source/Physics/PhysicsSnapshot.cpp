@@ -0,0 +1,144 @@
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+//A pair can have several contacts (one per sub-shape of a mesh) so the
+//contact id is mixed into the key. Keys that collide are checked on lookup.
+u64 GetContactKey(u64 pairId, uint contactId)
+{
+  return pairId ^ ((u64)contactId * 0x9E3779B97F4A7C15ull);
+}
+
+PhysicsSnapshot::PhysicsSnapshot()
+{
+  mStateId = 0;
+}
+
+void PhysicsSnapshot::Clear()
+{
+  mStateId = 0;
+  mBodies.Clear();
+  mContacts.Clear();
+  mPoints.Clear();
+  mJoints.Clear();
+  mJointImpulses.Clear();
+  mContactIndices.Clear();
+}
+
+ContactSnapshot* PhysicsSnapshot::FindContact(u64 pairId, uint contactId)
+{
+  uint* index = mContactIndices.FindPointer(GetContactKey(pairId, contactId));
+  if(index == nullptr)
+    return nullptr;
+
+  ContactSnapshot& contact = mContacts[*index];
+  if(contact.mPairId != pairId || contact.mContactId != contactId)
+    return nullptr;
+  return &contact;
+}
+
+void PhysicsSnapshot::SaveContact(Manifold* manifold)
+{
+  u64 pairId = manifold->Objects.GetId();
+  u64 key = GetContactKey(pairId, manifold->ContactId);
+  if(mContactIndices.FindPointer(key) != nullptr)
+    return;
+  mContactIndices.Insert(key, mContacts.Size());
+
+  ContactSnapshot& contact = mContacts.PushBack();
+  contact.mPairId = pairId;
+  contact.mContactId = manifold->ContactId;
+  contact.mPointStart = mPoints.Size();
+  contact.mPointCount = manifold->ContactCount;
+
+  bool swapped = manifold->Objects[1]->mId < manifold->Objects[0]->mId;
+  for(uint i = 0; i < manifold->ContactCount; ++i)
+  {
+    mPoints.PushBack(manifold->Contacts[i]);
+    ManifoldPoint& point = mPoints.Back();
+    if(swapped)
+    {
+      point.Normal = -point.Normal;
+      Math::Swap(point.BodyPoints[0], point.BodyPoints[1]);
+      Math::Swap(point.WorldPoints[0], point.WorldPoints[1]);
+    }
+  }
+}
+
+bool PhysicsSnapshot::RestoreManifold(Manifold* manifold)
+{
+  ContactSnapshot* contact = FindContact(manifold->Objects.GetId(), manifold->ContactId);
+  if(contact == nullptr)
+    return false;
+
+  //put the pair in the saved order, copy the points and then swap back
+  bool swapped = manifold->Objects[1]->mId < manifold->Objects[0]->mId;
+  if(swapped)
+    manifold->SwapPair();
+
+  manifold->ContactCount = contact->mPointCount;
+  for(uint i = 0; i < contact->mPointCount; ++i)
+    manifold->Contacts[i] = mPoints[contact->mPointStart + i];
+
+  if(swapped)
+    manifold->SwapPair();
+  return true;
+}
+
+PhysicsSnapshotBuffer::PhysicsSnapshotBuffer()
+{
+  mNextStateId = 1;
+}
+
+uint PhysicsSnapshotBuffer::GetCapacity() const
+{
+  return mSnapshots.Size();
+}
+
+void PhysicsSnapshotBuffer::SetCapacity(uint capacity)
+{
+  Clear();
+  mSnapshots.Resize(capacity);
+}
+
+PhysicsSnapshot& PhysicsSnapshotBuffer::Push()
+{
+  uint stateId = mNextStateId++;
+  PhysicsSnapshot& snapshot = mSnapshots[stateId % mSnapshots.Size()];
+  snapshot.Clear();
+  snapshot.mStateId = stateId;
+  return snapshot;
+}
+
+PhysicsSnapshot* PhysicsSnapshotBuffer::Find(uint stateId)
+{
+  if(mSnapshots.Empty() || stateId == 0 || stateId >= mNextStateId)
+    return nullptr;
+
+  PhysicsSnapshot& snapshot = mSnapshots[stateId % mSnapshots.Size()];
+  if(snapshot.mStateId != stateId)
+    return nullptr;
+  return &snapshot;
+}
+
+void PhysicsSnapshotBuffer::DiscardAfter(uint stateId)
+{
+  //the discarded snapshots fail the id check in Find until they're overwritten
+  if(stateId < mNextStateId)
+    mNextStateId = stateId + 1;
+}
+
+void PhysicsSnapshotBuffer::Clear()
+{
+  for(uint i = 0; i < mSnapshots.Size(); ++i)
+    mSnapshots[i].Clear();
+  mNextStateId = 1;
+}
+
+}//namespace Physics
+
+}//namespace Plasma
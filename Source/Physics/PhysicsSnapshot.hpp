@@ -0,0 +1,93 @@
+#pragma once
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+///The saved state of a dynamic rigid body.
+struct BodySnapshot
+{
+  CogId mCogId;
+  Vec3 mCenterOfMass;
+  Quat mRotation;
+  Vec3 mVelocity;
+  Vec3 mAngularVelocity;
+  Vec3 mForce;
+  Vec3 mTorque;
+  real mSleepTimer;
+  bool mAsleep;
+};
+
+///The saved manifold of a contact. The points hold the impulses used to warm start
+///it and are stored with the collider with the lower id first.
+struct ContactSnapshot
+{
+  u64 mPairId;
+  uint mContactId;
+  uint mPointStart;
+  uint mPointCount;
+};
+
+///The saved warm starting impulses of a joint.
+struct JointSnapshot
+{
+  CogId mCogId;
+  uint mImpulseStart;
+  uint mImpulseCount;
+};
+
+///The state of a physics space at the end of a frame. Everything is stored in
+///flat arrays that keep their memory when the snapshot is overwritten.
+struct PhysicsSnapshot
+{
+  PhysicsSnapshot();
+
+  void Clear();
+
+  ///Finds the saved contact for a pair (null if the contact didn't exist).
+  ContactSnapshot* FindContact(u64 pairId, uint contactId);
+  void SaveContact(Manifold* manifold);
+  ///Replaces the points of the manifold with the saved ones. Returns false
+  ///if the contact didn't exist when the snapshot was saved.
+  bool RestoreManifold(Manifold* manifold);
+
+  ///The id returned by PhysicsSpace::SaveState (0 if the snapshot is unused).
+  uint mStateId;
+  Array<BodySnapshot> mBodies;
+  Array<ContactSnapshot> mContacts;
+  Array<ManifoldPoint> mPoints;
+  Array<JointSnapshot> mJoints;
+  Array<real> mJointImpulses;
+  ///Index of each contact by pair (see GetContactKey).
+  HashMap<u64, uint> mContactIndices;
+};
+
+///A ring of snapshots. Saving a new state overwrites the oldest one once
+///the capacity is reached so saving every frame doesn't allocate.
+class PhysicsSnapshotBuffer
+{
+public:
+  PhysicsSnapshotBuffer();
+
+  uint GetCapacity() const;
+  ///Changing the capacity discards all saved states.
+  void SetCapacity(uint capacity);
+
+  ///Returns the snapshot to save the next state into (with its id already set).
+  PhysicsSnapshot& Push();
+  ///Returns the snapshot with the given id or null if it was overwritten or discarded.
+  PhysicsSnapshot* Find(uint stateId);
+  ///Discards all states saved after the given one so the ids continue from it.
+  void DiscardAfter(uint stateId);
+  void Clear();
+
+private:
+  Array<PhysicsSnapshot> mSnapshots;
+  uint mNextStateId;
+};
+
+}//namespace Physics
+
+}//namespace Plasma
@@ -128,6 +128,9 @@ LightningDefineType(PhysicsSpace, builder, type)
   PlasmaBindEvent(Events::PhysicsUpdateFinished, ObjectEvent);
 
   LightningBindGetterSetterProperty(SubStepCount);
+  LightningBindGetterSetterProperty(FixedTimestep);
+  LightningBindGetterSetterProperty(FixedTimestepLength);
+  LightningBindGetterSetterProperty(MaxStepsPerFrame);
   LightningBindGetterSetterProperty(AllowSleep);
   LightningBindGetterSetterProperty(Mode2D);
   LightningBindGetterSetterProperty(Deterministic);
@@ -145,6 +148,11 @@ LightningDefineType(PhysicsSpace, builder, type)
 
   LightningBindMethod(FlushPhysicsQueue);
 
+  // Rewinding
+  LightningBindGetterSetter(SavedStateCount);
+  LightningBindMethod(SaveState);
+  LightningBindMethod(RestoreState);
+
   // Ray Cast
   LightningBindOverloadedMethod(CastRayFirst, LightningInstanceOverload(CastResult, const Ray&));
   LightningBindOverloadedMethod(CastRayFirst, LightningInstanceOverload(CastResult, const Ray&, CastFilter&));
@@ -208,6 +216,12 @@ PhysicsSpace::PhysicsSpace()
 
   mInvalidVelocityOccurred = false;
   mMaxVelocity = real(1e+10);
+
+  mTimeAccumulator = real(0);
+  mInterpolationFactor = real(1);
+  mRestoredState = nullptr;
+  mSpringGroupCount = 0;
+  mSpringStep = 0;
 }
 
 PhysicsSpace::~PhysicsSpace()
@@ -238,6 +252,8 @@ void PhysicsSpace::Serialize(Serializer& stream)
   uint defaultFlags = PhysicsSpaceFlags::AllowSleep | PhysicsSpaceFlags::Deterministic;
   SerializeBits(stream, mStateFlags, PhysicsSpaceFlags::Names, 0, defaultFlags);
   SerializeNameDefault(mSubStepCount, 1u);
+  SerializeNameDefault(mFixedTimestepLength, real(1.0 / 60.0));
+  SerializeNameDefault(mMaxStepsPerFrame, 4u);
   SerializeResourceName(mCollisionTable, CollisionTableManager);
   SerializeResourceName(mPhysicsSolverConfig, PhysicsSolverConfigManager);
 
@@ -333,6 +349,16 @@ uint PhysicsSpace::GetIslandCount() const
   return mIslandManager->mIslandCount;
 }
 
+uint PhysicsSpace::GetPairCacheTestCount() const
+{
+  return mPairCache.mTestCount;
+}
+
+uint PhysicsSpace::GetPairCacheHitCount() const
+{
+  return mPairCache.mHitCount;
+}
+
 bool PhysicsSpace::GetIsSolverShared() const
 {
   return mIslandManager->mShareSolver;
@@ -618,9 +644,14 @@ void PhysicsSpace::SystemLogicUpdate(UpdateEvent* updateEvent)
     if(!GetSpace()->IsPreviewMode())
     {
       real frameTime = updateEvent->Dt;
-      real dt = frameTime / real(mSubStepCount);
-      for(uint i = 0; i < mSubStepCount; ++i)
-        IterateTimestep(dt);
+      if(GetFixedTimestep())
+        IterateFixedTimesteps(frameTime);
+      else
+      {
+        real dt = frameTime / real(mSubStepCount);
+        for(uint i = 0; i < mSubStepCount; ++i)
+          IterateTimestep(dt);
+      }
     }
   }
 
@@ -639,6 +670,161 @@ void PhysicsSpace::FlushPhysicsQueue()
   PushBroadPhaseQueue();
 }
 
+uint PhysicsSpace::GetSavedStateCount() const
+{
+  return mSavedStates.GetCapacity();
+}
+
+void PhysicsSpace::SetSavedStateCount(uint count)
+{
+  if(256 < count)
+  {
+    count = 256;
+    DoNotifyWarning("Invalid SavedStateCount", "Physics can save at most 256 states. The value has been clamped.");
+  }
+  mRestoredState = nullptr;
+  mSavedStates.SetCapacity(count);
+}
+
+uint PhysicsSpace::SaveState()
+{
+  ZoneScoped;
+  ReturnIf(mSavedStates.GetCapacity() == 0, 0, "SavedStateCount must be set before states can be saved.");
+
+  // Make sure any changes made since the last update are part of the state
+  PushBroadPhaseQueue();
+
+  Physics::PhysicsSnapshot& snapshot = mSavedStates.Push();
+
+  RigidBodyList* bodyLists[] = {&mRigidBodies, &mInactiveRigidBodies};
+  for(uint i = 0; i < 2; ++i)
+  {
+    RigidBodyList::range bodies = bodyLists[i]->All();
+    for(; !bodies.Empty(); bodies.PopFront())
+    {
+      RigidBody& body = bodies.Front();
+      if(!body.IsDynamic())
+        continue;
+
+      Physics::BodySnapshot& bodyState = snapshot.mBodies.PushBack();
+      bodyState.mCogId = body.GetOwner()->GetId();
+      bodyState.mCenterOfMass = body.mCenterOfMass;
+      bodyState.mRotation = body.mRotationQuat;
+      bodyState.mVelocity = body.mVelocity;
+      bodyState.mAngularVelocity = body.mAngularVelocity;
+      bodyState.mForce = body.mForceAccumulator;
+      bodyState.mTorque = body.mTorqueAccumulator;
+      bodyState.mSleepTimer = body.mSleepTimer;
+      bodyState.mAsleep = body.IsAsleep();
+    }
+  }
+
+  // Every contact has at least one dynamic collider (contacts with two are only saved once)
+  ColliderList::range colliders = mDynamicColliders.All();
+  for(; !colliders.Empty(); colliders.PopFront())
+  {
+    Collider::ContactEdgeList::range edges = colliders.Front().mContactEdges.All();
+    for(; !edges.Empty(); edges.PopFront())
+      snapshot.SaveContact(edges.Front().mContact->GetManifold());
+  }
+
+  JointList::range joints = mJoints.All();
+  for(; !joints.Empty(); joints.PopFront())
+  {
+    Joint& joint = joints.Front();
+    Physics::JointSnapshot& jointState = snapshot.mJoints.PushBack();
+    jointState.mCogId = joint.GetOwner()->GetId();
+    jointState.mImpulseStart = snapshot.mJointImpulses.Size();
+    joint.SaveImpulsesVirtual(snapshot.mJointImpulses);
+    jointState.mImpulseCount = snapshot.mJointImpulses.Size() - jointState.mImpulseStart;
+  }
+
+  return snapshot.mStateId;
+}
+
+bool PhysicsSpace::RestoreState(uint stateId)
+{
+  ZoneScoped;
+  Physics::PhysicsSnapshot* snapshot = mSavedStates.Find(stateId);
+  if(snapshot == nullptr)
+  {
+    DoNotifyWarning("Invalid state", "The physics state to restore was never saved or has been overwritten.");
+    return false;
+  }
+
+  PushBroadPhaseQueue();
+
+  for(uint i = 0; i < snapshot->mBodies.Size(); ++i)
+  {
+    Physics::BodySnapshot& bodyState = snapshot->mBodies[i];
+    Cog* cog = bodyState.mCogId.ToCog();
+    RigidBody* body = cog != nullptr ? cog->has(RigidBody) : nullptr;
+    if(body == nullptr || body->mSpace != this || !body->IsDynamic())
+      continue;
+
+    // Change the sleep state first as it clears the velocities
+    if(bodyState.mAsleep != body->IsAsleep())
+      body->SetAsleep(bodyState.mAsleep);
+
+    body->SetIntegratedTransform(bodyState.mCenterOfMass, bodyState.mRotation);
+    body->GenerateIntegrationUpdate();
+    body->mVelocity = bodyState.mVelocity;
+    body->mAngularVelocity = bodyState.mAngularVelocity;
+    body->mForceAccumulator = bodyState.mForce;
+    body->mTorqueAccumulator = bodyState.mTorque;
+    body->mSleepTimer = bodyState.mSleepTimer;
+    body->UpdateWorldInertiaTensor();
+
+    body->mState.SetFlag(RigidBodyStates::ResetInterpolation);
+    body->PublishTransform();
+  }
+
+  // Contacts that didn't exist in the state can't warm start from impulses of the future
+  ColliderList::range colliders = mDynamicColliders.All();
+  for(; !colliders.Empty(); colliders.PopFront())
+  {
+    Collider::ContactEdgeList::range edges = colliders.Front().mContactEdges.All();
+    for(; !edges.Empty(); edges.PopFront())
+    {
+      Physics::Manifold* manifold = edges.Front().mContact->GetManifold();
+      if(snapshot->RestoreManifold(manifold))
+        continue;
+
+      for(uint i = 0; i < manifold->ContactCount; ++i)
+        manifold->Contacts[i].AccumulatedImpulse.ZeroOut();
+    }
+  }
+
+  // Joints are usually still in the order they were saved in
+  uint jointIndex = 0;
+  JointList::range joints = mJoints.All();
+  for(; !joints.Empty(); joints.PopFront())
+  {
+    Joint& joint = joints.Front();
+    CogId cogId = joint.GetOwner()->GetId();
+
+    Physics::JointSnapshot* jointState = nullptr;
+    for(uint i = 0; i < snapshot->mJoints.Size() && jointState == nullptr; ++i)
+    {
+      Physics::JointSnapshot& candidate = snapshot->mJoints[(jointIndex + i) % snapshot->mJoints.Size()];
+      if(candidate.mCogId == cogId)
+        jointState = &candidate;
+    }
+    if(jointState == nullptr)
+      continue;
+
+    jointIndex = (uint)(jointState - snapshot->mJoints.Data()) + 1;
+    const real* impulses = snapshot->mJointImpulses.Data() + jointState->mImpulseStart;
+    joint.RestoreImpulsesVirtual(impulses, jointState->mImpulseCount);
+  }
+
+  PushBroadPhaseQueue();
+
+  mSavedStates.DiscardAfter(stateId);
+  mRestoredState = snapshot;
+  return true;
+}
+
 void PhysicsSpace::PushBroadPhaseQueue()
 {
   mNodeManager->CommitChanges(mBroadPhase);
@@ -654,6 +840,35 @@ void PhysicsSpace::UpdateTransformAndMassOfTree(PhysicsNode* node)
   mNodeManager->UpdateNodeTree(node);
 }
 
+void PhysicsSpace::IterateFixedTimesteps(real frameTime)
+{
+  mTimeAccumulator += frameTime;
+  uint stepCount = (uint)(mTimeAccumulator / mFixedTimestepLength);
+  // Drop the time we can't catch up on (a long hitch or a slow machine)
+  if(stepCount > mMaxStepsPerFrame)
+  {
+    stepCount = mMaxStepsPerFrame;
+    mTimeAccumulator = mFixedTimestepLength * real(stepCount);
+  }
+
+  real dt = mFixedTimestepLength / real(mSubStepCount);
+  for(uint step = 0; step < stepCount; ++step)
+  {
+    // Save where each body started the step so the published
+    // transforms can blend between the last two steps
+    RigidBodyList::range range = mRigidBodies.All();
+    for(; !range.Empty(); range.PopFront())
+      range.Front().SaveInterpolationState();
+
+    for(uint i = 0; i < mSubStepCount; ++i)
+      IterateTimestep(dt);
+    mTimeAccumulator -= mFixedTimestepLength;
+  }
+
+  mTimeAccumulator = Math::Max(mTimeAccumulator, real(0));
+  mInterpolationFactor = Math::Min(mTimeAccumulator / mFixedTimestepLength, real(1));
+}
+
 void PhysicsSpace::IterateTimestep(real dt)
 {
   mIterationDt = dt;
@@ -710,6 +925,7 @@ void PhysicsSpace::IterateTimestep(real dt)
 void PhysicsSpace::IntegrateBodiesVelocity(real dt)
 {
   ZoneScoped;
+  mBodyStates.Clear();
   RigidBodyList::range range = mRigidBodies.All();
 
   while(!range.Empty())
@@ -720,7 +936,6 @@ void PhysicsSpace::IntegrateBodiesVelocity(real dt)
     bool isKinematic = body.GetKinematic();
     ErrorIf(isKinematic, "Kinematic object should not be in the rigid body list.");
     
-    ApplyGlobalEffects(&body, dt);
     body.UpdateBodyEffects(dt);
 
     // Check for asleep bodies
@@ -729,19 +944,29 @@ void PhysicsSpace::IntegrateBodiesVelocity(real dt)
       // Change to the inactive list
       mRigidBodies.Erase(&body);
       mInactiveRigidBodies.PushBack(&body);
+      // Inactive bodies aren't published, so don't leave them at a blended transform
+      if(GetFixedTimestep())
+        body.PublishTransform();
       continue;
     }
 
     if(!body.GetStatic())
-      Physics::Integration::IntegrateVelocity(&body, dt);
+      mBodyStates.AddVelocityState(&body);
 
     body.mForceAccumulator.ZeroOut();
     body.mTorqueAccumulator.ZeroOut();
   }
+
+  ApplyGlobalEffects(dt);
+
+  // Integrate all of the awake bodies at once
+  mBodyStates.IntegrateVelocities(dt, mMaxVelocity);
+  mBodyStates.CommitVelocities();
 }
 
 void PhysicsSpace::IntegrateBodiesPosition(real dt)
 {
+  mBodyStates.Clear();
   RigidBodyList::range range = mRigidBodies.All();
 
   while(!range.Empty())
@@ -749,14 +974,14 @@ void PhysicsSpace::IntegrateBodiesPosition(real dt)
     RigidBody& body = range.Front();
 
     if(!body.GetStatic())
-    {
-      Physics::Integration::IntegratePosition(&body, dt);
-      // Attempt to sleep the body.
-      body.UpdateSleepTimer(dt);
-    }
+      mBodyStates.AddPositionState(&body);
 
     range.PopFront();
   }
+
+  mBodyStates.IntegratePositions(dt);
+  // Also attempts to sleep the bodies
+  mBodyStates.CommitPositions(dt);
 }
 
 void PhysicsSpace::BroadPhase()
@@ -800,54 +1025,162 @@ void PhysicsSpace::BroadPhase()
     Sort(mPossiblePairs.All(), &ClientPairSorter);
 }
 
-void PhysicsSpace::NarrowPhase()
+//Fewer possible pairs than this are tested on the calling thread.
+const uint cMinParallelNarrowPhasePairs = 256;
+
+//Tests the possible pairs for a range of buffers (used with JobSystem::ParallelFor).
+//Each buffer owns a contiguous range of pairs and the tests only write to that
+//buffer, so committing the buffers in order matches testing every pair in order.
+//Height maps fill in their internal edge info while they're tested, so when the
+//buffers are filled in parallel their pairs are deferred until the commit.
+struct NarrowPhaseTester
 {
-  ZoneScoped;
-  ProfileScopeTree("NarrowPhase", "Iteration", Color::Salmon);
+  void operator()(uint begin, uint end)
+  {
+    for(uint bufferIndex = begin; bufferIndex < end; ++bufferIndex)
+    {
+      Physics::NarrowPhaseBuffer& buffer = mBuffers[bufferIndex];
+      buffer.Clear();
 
-  HeapAllocator allocator(mHeap);
-  Physics::ManifoldArray tempManifolds;
-  tempManifolds.SetAllocator(allocator);
+      uint pairStart = (uint)((u64)mPairCount * bufferIndex / mBufferCount);
+      uint pairEnd = (uint)((u64)mPairCount * (bufferIndex + 1) / mBufferCount);
+      for(uint pairIndex = pairStart; pairIndex < pairEnd; ++pairIndex)
+      {
+        uint manifoldStart = buffer.mManifolds.Size();
+        bool deferred = mDeferHeightMaps && HasHeightMap(pairIndex);
+        if(!deferred && !TestPair(pairIndex, buffer.mManifolds))
+          continue;
+
+        Physics::NarrowPhaseBuffer::PairResult& result = buffer.mPairs.PushBack();
+        result.mPairIndex = pairIndex;
+        result.mManifoldStart = manifoldStart;
+        result.mManifoldCount = buffer.mManifolds.Size() - manifoldStart;
+        result.mDeferred = deferred;
+      }
+    }
+  }
 
-  Array<NodePointerPair> Collisions;
-  Collisions.SetAllocator(allocator);
+  bool HasHeightMap(uint pairIndex)
+  {
+    ClientPair& clientPair = mPairs[pairIndex];
+    Collider* collider1 = static_cast<Collider*>(clientPair.mClientData[0]);
+    Collider* collider2 = static_cast<Collider*>(clientPair.mClientData[1]);
+    return collider1->GetColliderType() == Collider::cHeightMap ||
+           collider2->GetColliderType() == Collider::cHeightMap;
+  }
 
-  size_t size = mPossiblePairs.Size();
-  for(size_t pairIndex = 0; pairIndex < size; ++pairIndex)
+  //Returns true if the pair collided (its manifolds are added to the end of the array).
+  bool TestPair(uint pairIndex, Physics::ManifoldArray& manifolds)
   {
-    ClientPair* clientPair = &mPossiblePairs[pairIndex];
-    Collider* collider1 = static_cast<Collider*>(clientPair->mClientData[0]);
-    Collider* collider2 = static_cast<Collider*>(clientPair->mClientData[1]);
+    ClientPair& clientPair = mPairs[pairIndex];
+    Collider* collider1 = static_cast<Collider*>(clientPair.mClientData[0]);
+    Collider* collider2 = static_cast<Collider*>(clientPair.mClientData[1]);
     // Convert the proxy to a collider
     ColliderPair pair(collider1, collider2);
 
-    // Test for collision
-    if(!mCollisionManager->TestCollision(pair, tempManifolds))
-    {
-      tempManifolds.Clear();
-      continue;
-    }
+    if(!pair.Top->ShouldCollide(pair.Bot))
+      return false;
 
-    // If tracking is enabled, we need to record the collision
-    if(mBroadPhase->IsTracking())
+    // Skip the full test if the axis that separated the pair last step still does
+    Physics::PairCacheEntry& cacheEntry = mPairCache->GetEntry(pairIndex);
+    if(mPairCache->IsSeparated(cacheEntry, collider1, collider2))
+      return false;
+
+    // Test for collision (a failed test can still have added manifolds)
+    uint manifoldStart = manifolds.Size();
+    if(!mCollisionManager->ForceTestCollision(pair, manifolds))
     {
-      NodePointerPair nodePair(clientPair->mClientData[0],
-                               clientPair->mClientData[1]);
-      Collisions.PushBack(nodePair);
+      manifolds.Resize(manifoldStart);
+      mPairCache->UpdateSeparatingAxis(cacheEntry, collider1, collider2);
+      return false;
     }
+    mPairCache->ClearSeparatingAxis(cacheEntry);
+    return true;
+  }
+
+  Physics::CollisionManager* mCollisionManager;
+  Physics::PairCache* mPairCache;
+  Physics::NarrowPhaseBuffer* mBuffers;
+  ClientPair* mPairs;
+  uint mPairCount;
+  uint mBufferCount;
+  bool mDeferHeightMaps;
+};
 
-    // Add all manifolds to the contact manager
-    for(size_t i = 0; i < tempManifolds.Size(); ++i)
+void PhysicsSpace::NarrowPhase()
+{
+  ZoneScoped;
+  ProfileScopeTree("NarrowPhase", "Iteration", Color::Salmon);
+
+  // Split the pairs between a few buffers per thread so threads that finish early can
+  // help with the rest (everything goes in one buffer when there isn't enough work)
+  uint pairCount = mPossiblePairs.Size();
+  uint bufferCount = 1;
+  uint workerCount = PL::gJobs->GetWorkerCount();
+  if(workerCount != 0 && pairCount >= cMinParallelNarrowPhasePairs)
+  {
+    uint maxBufferCount = JobSystem::cMaxParallelTasks;
+    uint pairBufferCount = pairCount / (cMinParallelNarrowPhasePairs / 4);
+    bufferCount = Math::Min(Math::Min((workerCount + 1) * 4, pairBufferCount), maxBufferCount);
+  }
+  if(mNarrowPhaseBuffers.Size() < bufferCount)
+    mNarrowPhaseBuffers.Resize(bufferCount);
+
+  // Entries for new pairs have to exist before the pairs are tested on other threads
+  mPairCache.BeginStep(mPossiblePairs);
+
+  // Test all pairs, writing the results into the buffers
+  NarrowPhaseTester tester;
+  tester.mCollisionManager = mCollisionManager;
+  tester.mPairCache = &mPairCache;
+  tester.mBuffers = mNarrowPhaseBuffers.Data();
+  tester.mPairs = mPossiblePairs.Data();
+  tester.mPairCount = pairCount;
+  tester.mBufferCount = bufferCount;
+  tester.mDeferHeightMaps = bufferCount > 1;
+  PL::gJobs->ParallelFor(0, bufferCount, tester, 1);
+
+  // Commit the results in pair order so the contacts (and everything built
+  // from them) don't depend on how the pairs were split up
+  FrameNodePointerPairArray Collisions;
+  bool tracking = mBroadPhase->IsTracking();
+  for(uint bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex)
+  {
+    Physics::NarrowPhaseBuffer& buffer = mNarrowPhaseBuffers[bufferIndex];
+    for(uint i = 0; i < buffer.mPairs.Size(); ++i)
     {
-      Physics::Manifold& manifold = tempManifolds[i];
-      mContactManager->AddManifold(tempManifolds[i]);
-      manifold.Clear();
-    }
+      Physics::NarrowPhaseBuffer::PairResult& result = buffer.mPairs[i];
+
+      // Test the pairs that couldn't be tested in parallel now (in the same order)
+      if(result.mDeferred)
+      {
+        result.mManifoldStart = buffer.mManifolds.Size();
+        if(!tester.TestPair(result.mPairIndex, buffer.mManifolds))
+          continue;
+        result.mManifoldCount = buffer.mManifolds.Size() - result.mManifoldStart;
+      }
+
+      // If tracking is enabled, we need to record the collision
+      if(tracking)
+      {
+        ClientPair& clientPair = mPossiblePairs[result.mPairIndex];
+        NodePointerPair nodePair(clientPair.mClientData[0],
+                                 clientPair.mClientData[1]);
+        Collisions.PushBack(nodePair);
+      }
 
-    tempManifolds.Clear();
+      // Add all manifolds to the contact manager
+      uint manifoldEnd = result.mManifoldStart + result.mManifoldCount;
+      for(uint j = result.mManifoldStart; j < manifoldEnd; ++j)
+        mContactManager->AddManifold(buffer.mManifolds[j]);
+    }
+    buffer.Clear();
   }
 
   mBroadPhase->RecordFrameResults(Collisions);
+  mPairCache.EndStep();
+  // Any contact from a restored state that came back has been re-created by now
+  mRestoredState = nullptr;
 
   // We have all connections for the frame so build the islands.
   mIslandManager->BuildIslands(mDynamicColliders);
@@ -877,33 +1210,58 @@ void PhysicsSpace::SolvePositions(real dt)
   mIslandManager->SolvePositions(dt);
 }
 
+//Fewer spring edges than this are solved on the calling thread.
+const uint cMinParallelSpringEdges = 1024;
+
+//Solves a range of spring groups (used with JobSystem::ParallelFor). Groups
+//don't share any points, so each one can be solved on any thread.
+struct SpringGroupSolver
+{
+  void operator()(uint begin, uint end)
+  {
+    for(uint groupIndex = begin; groupIndex < end; ++groupIndex)
+      mGroups[groupIndex].Solve(mDt);
+  }
+
+  SpringGroup* mGroups;
+  real mDt;
+};
+
 void PhysicsSpace::SolveSprings(real dt)
 {
-  // Make sure to solve a system only once
-  HashSet<SpringSystem*> systems;
-  SpringGroup group;
+  ZoneScoped;
+
+  // Systems are marked with the step they were grouped in so each one is only added once
+  ++mSpringStep;
+  mSpringGroupCount = 0;
 
   SpringSystems::range range = mSprings.All();
   for(; !range.Empty(); range.PopFront())
   {
-    group.mSystems.Clear();
-
     SpringSystem* system = &range.Front();
+    if(system->mSpringGroupStep == mSpringStep)
+      continue;
 
-    Array<SpringSystem*> stack;
-    stack.PushBack(system);
+    if(mSpringGroups.Size() == mSpringGroupCount)
+      mSpringGroups.PushBack();
+    SpringGroup& group = mSpringGroups[mSpringGroupCount];
+    ++mSpringGroupCount;
+    group.mSystems.Clear();
+
+    mSpringStack.Clear();
+    mSpringStack.PushBack(system);
 
     // Start a new grouping (until our stack is empty)
-    while(!stack.Empty())
+    while(!mSpringStack.Empty())
     {
-      system = stack.Back();
-      stack.PopBack();
+      system = mSpringStack.Back();
+      mSpringStack.PopBack();
 
       // We've already added this system
-      if(systems.Contains(system))
+      if(system->mSpringGroupStep == mSpringStep)
         continue;
 
-      systems.Insert(system);
+      system->mSpringGroupStep = mSpringStep;
       group.mSystems.PushBack(system);
 
       // Add all connected systems of edges this system owns
@@ -912,8 +1270,8 @@ void PhysicsSpace::SolveSprings(real dt)
       {
         SpringSystem::SystemConnection& connection = ownedRange.Front();
         
-        if(systems.Contains(connection.mOtherSystem) == false)
-          stack.PushBack(connection.mOtherSystem);
+        if(connection.mOtherSystem->mSpringGroupStep != mSpringStep)
+          mSpringStack.PushBack(connection.mOtherSystem);
       }
       // Add all connected systems of edges this system doesn't own
       SpringSystem::ConnectedEdgeList::range otherRange = system->mConnectedEdges.All();
@@ -921,15 +1279,35 @@ void PhysicsSpace::SolveSprings(real dt)
       {
         SpringSystem::SystemConnection& connection = otherRange.Front();
 
-        if(systems.Contains(connection.mOwningSystem) == false)
-          stack.PushBack(connection.mOwningSystem);
+        if(connection.mOwningSystem->mSpringGroupStep != mSpringStep)
+          mSpringStack.PushBack(connection.mOwningSystem);
       }
     }
+  }
 
-    // Solve the entire grouping of systems together
-    group.Solve(this, dt);
+  // Anchors and effects read other objects, so they're applied on this thread
+  uint edgeCount = 0;
+  for(uint i = 0; i < mSpringGroupCount; ++i)
+  {
+    SpringGroup& group = mSpringGroups[i];
+    group.PrepareSolve(this);
+    edgeCount += group.mSolver.GetEdgeCount();
   }
-  group.mSystems.Clear();
+
+  // Solve each grouping of systems together (separate groups in parallel). The
+  // edge count is from each group's last build, which is close enough to split on.
+  SpringGroupSolver solver;
+  solver.mGroups = mSpringGroups.Data();
+  solver.mDt = dt;
+  uint workerCount = PL::gJobs->GetWorkerCount();
+  if(workerCount == 0 || mSpringGroupCount < 2 || edgeCount < cMinParallelSpringEdges)
+    solver(0, mSpringGroupCount);
+  else
+    PL::gJobs->ParallelFor(0, mSpringGroupCount, solver, 1);
+
+  // Committing debug draws, so it also has to be on this thread
+  for(uint i = 0; i < mSpringGroupCount; ++i)
+    mSpringGroups[i].Commit();
 }
 
 //---------------------------------------------------------------- Ray Casting
@@ -1002,6 +1380,173 @@ CastResultsRange PhysicsSpace::CastSegment(const Segment& segment, uint maxCount
   return CastResultsRange(results);
 }
 
+//Batches with fewer casts than this are cast on the calling thread.
+const uint cMinParallelBatchCasts = 64;
+
+//Spreads the low 9 bits of value out so there are two zero bits between each bit.
+uint SpreadBatchCastBits(uint value)
+{
+  value &= 0x1ff;
+  value = (value | (value << 16)) & 0x030000ff;
+  value = (value | (value << 8)) & 0x0300f00f;
+  value = (value | (value << 4)) & 0x030c30c3;
+  value = (value | (value << 2)) & 0x09249249;
+  return value;
+}
+
+//Casts a range of chunks of a batch cast (used with JobSystem::ParallelFor).
+//Each chunk casts a contiguous range of the sorted casts into its own buffer.
+struct BatchCaster
+{
+  void operator()(uint begin, uint end)
+  {
+    CastResultArray castResults;
+    castResults.Resize(mMaxCount);
+    for(uint chunkIndex = begin; chunkIndex < end; ++chunkIndex)
+    {
+      CastResultArray& chunkResults = mChunkResults[chunkIndex];
+      chunkResults.Clear();
+
+      uint castStart = (uint)((u64)mCastCount * chunkIndex / mChunkCount);
+      uint castEnd = (uint)((u64)mCastCount * (chunkIndex + 1) / mChunkCount);
+      for(uint i = castStart; i < castEnd; ++i)
+      {
+        uint castIndex = (uint)mOrder[i];
+        ProxyCastResults proxyResults((ProxyCastResultArray&)castResults, *mFilter);
+        if(mRays != nullptr)
+          mBroadPhase->CastRay(mRays[castIndex].Start, mRays[castIndex].Direction.AttemptNormalized(), proxyResults);
+        else
+          mBroadPhase->CastSegment(mSegments[castIndex].Start, mSegments[castIndex].End, proxyResults);
+
+        //Same as CastResults::ConvertToColliders
+        mCounts[castIndex] = proxyResults.CurrSize;
+        for(uint j = 0; j < proxyResults.CurrSize; ++j)
+        {
+          chunkResults.PushBack(castResults[j]);
+          chunkResults.Back().mObjectHit = static_cast<Collider*>(proxyResults.Results[j].mObjectHit);
+        }
+      }
+    }
+  }
+
+  BroadPhasePackage* mBroadPhase;
+  BaseCastFilter* mFilter;
+  const Ray* mRays;
+  const Segment* mSegments;
+  //The sort key of each cast in the order they're cast (the cast index is in the low bits)
+  const u64* mOrder;
+  uint* mCounts;
+  CastResultArray* mChunkResults;
+  uint mCastCount;
+  uint mChunkCount;
+  uint mMaxCount;
+};
+
+void PhysicsSpace::CastRayBatch(const Array<Ray>& worldRays, uint maxCount, CastFilter& filter, CastBatchResults& results)
+{
+  CastBatch(worldRays.Data(), nullptr, worldRays.Size(), maxCount, filter, results);
+}
+
+void PhysicsSpace::CastSegmentBatch(const Array<Segment>& segments, uint maxCount, CastFilter& filter, CastBatchResults& results)
+{
+  filter.ClearFlag(BaseCastFilterFlags::IgnoreInternalCasts);
+  CastBatch(nullptr, segments.Data(), segments.Size(), maxCount, filter, results);
+}
+
+void PhysicsSpace::CastBatch(const Ray* rays, const Segment* segments, uint castCount, uint maxCount,
+                             CastFilter& filter, CastBatchResults& results)
+{
+  ZoneScoped;
+  results.Clear();
+  results.mOffsets.Resize(castCount + 1, 0);
+  if(castCount == 0)
+    return;
+  if(maxCount == 0)
+    maxCount = 1;
+
+  PushBroadPhaseQueue();
+
+  //Cast neighboring rays with the same direction octant one after another
+  //(ordered along a z-order curve of their start points) so they mostly
+  //touch the same parts of the broadphase
+  Aabb bounds;
+  bounds.SetInvalid();
+  for(uint i = 0; i < castCount; ++i)
+    bounds.Expand(rays != nullptr ? rays[i].Start : segments[i].Start);
+  Vec3 extents = bounds.GetExtents();
+  Vec3 scale;
+  for(uint axis = 0; axis < 3; ++axis)
+    scale[axis] = extents[axis] > real(0.0) ? real(511.0) / extents[axis] : real(0.0);
+
+  Array<u64> order;
+  order.Resize(castCount);
+  for(uint i = 0; i < castCount; ++i)
+  {
+    Vec3 start = rays != nullptr ? rays[i].Start : segments[i].Start;
+    Vec3 direction = rays != nullptr ? rays[i].Direction : segments[i].End - start;
+
+    //The octant is above the 27 bits of the z-order position
+    uint key = 0;
+    for(uint axis = 0; axis < 3; ++axis)
+    {
+      uint cell = (uint)((start[axis] - bounds.mMin[axis]) * scale[axis]);
+      key |= SpreadBatchCastBits(cell) << axis;
+      if(direction[axis] < real(0.0))
+        key |= 1u << (27 + axis);
+    }
+    order[i] = ((u64)key << 32) | i;
+  }
+  Sort(order.All());
+
+  //The filter's callback event can't be sent from the job workers
+  //(and a tracked broadphase records every cast)
+  uint chunkCount = 1;
+  uint workerCount = PL::gJobs->GetWorkerCount();
+  bool canSplit = filter.mCallbackObject == nullptr && !mBroadPhase->IsTracking();
+  if(canSplit && workerCount != 0 && castCount >= cMinParallelBatchCasts)
+  {
+    uint maxChunkCount = JobSystem::cMaxParallelTasks;
+    chunkCount = Math::Min(Math::Min((workerCount + 1) * 4, castCount / (cMinParallelBatchCasts / 4)), maxChunkCount);
+  }
+
+  Array<uint> counts;
+  counts.Resize(castCount);
+  Array<CastResultArray> chunkResults;
+  chunkResults.Resize(chunkCount);
+
+  BatchCaster caster;
+  caster.mBroadPhase = mBroadPhase;
+  caster.mFilter = &filter;
+  caster.mRays = rays;
+  caster.mSegments = segments;
+  caster.mOrder = order.Data();
+  caster.mCounts = counts.Data();
+  caster.mChunkResults = chunkResults.Data();
+  caster.mCastCount = castCount;
+  caster.mChunkCount = chunkCount;
+  caster.mMaxCount = maxCount;
+  PL::gJobs->ParallelFor(0, chunkCount, caster, 1);
+
+  //Lay the results out in the order the casts were given
+  for(uint i = 0; i < castCount; ++i)
+    results.mOffsets[i + 1] = results.mOffsets[i] + counts[i];
+  results.mResults.Resize(results.mOffsets[castCount]);
+
+  uint sortedIndex = 0;
+  for(uint chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+  {
+    CastResultArray& chunk = chunkResults[chunkIndex];
+    uint castEnd = (uint)((u64)castCount * (chunkIndex + 1) / chunkCount);
+    uint chunkResultIndex = 0;
+    for(; sortedIndex < castEnd; ++sortedIndex)
+    {
+      uint castIndex = (uint)order[sortedIndex];
+      for(uint j = 0; j < counts[castIndex]; ++j)
+        results.mResults[results.mOffsets[castIndex] + j] = chunk[chunkResultIndex++];
+    }
+  }
+}
+
 void PhysicsSpace::CastAabb(const Aabb& aabb, CastResults& results)
 {
   BaseCastFilter& filter = results.mResults.Filter;
@@ -1285,6 +1830,56 @@ void PhysicsSpace::SetSubStepCount(uint substeps)
   mSubStepCount = substeps;
 }
 
+bool PhysicsSpace::GetFixedTimestep() const
+{
+  return mStateFlags.IsSet(PhysicsSpaceFlags::FixedTimestep);
+}
+
+void PhysicsSpace::SetFixedTimestep(bool state)
+{
+  if(state == GetFixedTimestep())
+    return;
+
+  mStateFlags.SetState(PhysicsSpaceFlags::FixedTimestep, state);
+  mTimeAccumulator = real(0);
+  mInterpolationFactor = real(1);
+
+  // The saved states are out of date, publish the current transforms until the next step
+  RigidBodyList::range range = mRigidBodies.All();
+  for(; !range.Empty(); range.PopFront())
+    range.Front().mState.SetFlag(RigidBodyStates::ResetInterpolation);
+}
+
+real PhysicsSpace::GetFixedTimestepLength() const
+{
+  return mFixedTimestepLength;
+}
+
+void PhysicsSpace::SetFixedTimestepLength(real length)
+{
+  if(length < real(0.001) || real(1) < length)
+  {
+    length = Math::Clamp(length, real(0.001), real(1));
+    DoNotifyWarning("Invalid FixedTimestepLength", "The fixed timestep of physics must be between 0.001 and 1 seconds. The value has been clamped.");
+  }
+  mFixedTimestepLength = length;
+}
+
+uint PhysicsSpace::GetMaxStepsPerFrame() const
+{
+  return mMaxStepsPerFrame;
+}
+
+void PhysicsSpace::SetMaxStepsPerFrame(uint maxSteps)
+{
+  if(maxSteps < 1 || 20 < maxSteps)
+  {
+    maxSteps = Math::Clamp(maxSteps, 1u, 20u);
+    DoNotifyWarning("Invalid MaxStepsPerFrame", "The max steps per frame of physics must be between 1 and 20. The value has been clamped.");
+  }
+  mMaxStepsPerFrame = maxSteps;
+}
+
 bool PhysicsSpace::GetAllowSleep() const
 {
   return mStateFlags.IsSet(PhysicsSpaceFlags::AllowSleep);
@@ -1321,7 +1916,10 @@ void PhysicsSpace::Publish()
     RigidBody& r = range.Front();
     range.PopFront();
 
-    r.PublishTransform();
+    if(GetFixedTimestep())
+      r.PublishInterpolatedTransform(mInterpolationFactor);
+    else
+      r.PublishTransform();
   }
 
   // Now send out all events
@@ -1388,35 +1986,17 @@ void PhysicsSpace::ApplyHierarchyEffects(real dt)
   }
 }
 
-void PhysicsSpace::ApplyGlobalEffects(RigidBody* body, real dt)
+void PhysicsSpace::ApplyGlobalEffects(real dt)
 {
+  ZoneScoped;
+  // Global effects apply to every awake body, so each effect is applied to
+  // all of the gathered bodies in one pass (skipping the ones that ignore it)
   PhysicsEffectList::range range = mGlobalEffects.All();
-
-  // Deal with IgnoreSpaceEffects
-  IgnoreSpaceEffects* effectsToIgnore = body->mSpaceEffectsToIgnore;
-  if(effectsToIgnore)
-  {
-    while(!range.Empty())
-    {
-      PhysicsEffect& effect = range.Front();
-
-      // Skip if this effect type is ignored or not active
-      if(!effectsToIgnore->IsIgnored(&effect) && effect.GetActive())
-        effect.ApplyEffect(body, dt);
-
-      range.PopFront();
-    }
-    return;
-  }
-
-  while(!range.Empty())
+  for(; !range.Empty(); range.PopFront())
   {
     PhysicsEffect& effect = range.Front();
-
     if(effect.GetActive())
-      effect.ApplyEffect(body, dt);
-
-    range.PopFront();
+      effect.ApplyEffect(mBodyStates, dt);
   }
 }
 
@@ -1584,7 +2164,15 @@ void PhysicsSpace::ComponentStateChange(RigidBody* body)
   else if(body->GetKinematic())
     mMovingKinematicBodies.PushBack(body);
   else
+  {
     mRigidBodies.PushBack(body);
+    // The body may not have been stepped recently, so there's nothing to blend from
+    body->mState.SetFlag(RigidBodyStates::ResetInterpolation);
+  }
+
+  // Sleeping islands aren't built until one of their bodies wakes up
+  if(!body->IsAsleep())
+    mIslandManager->WakeBody(body);
 }
 
 void PhysicsSpace::AddComponent(Joint* joint)
@@ -1610,7 +2198,10 @@ void PhysicsSpace::RemoveComponent(Region* region)
 void PhysicsSpace::AddComponent(Collider* collider)
 {
   if(collider->GetActiveBody())
+  {
     mDynamicColliders.PushBack(collider);
+    mIslandManager->AddCollider(collider);
+  }
   else
     mStaticColliders.PushBack(collider);
 }
@@ -1646,11 +2237,16 @@ void PhysicsSpace::RemoveComponent(Collider* collider)
 void PhysicsSpace::ComponentStateChange(Collider* collider)
 {
   ColliderList::Unlink(collider);
+  // The collider's body changed so it has to be put on an island again
+  mIslandManager->RemoveCollider(collider);
 
   if(!collider->GetActiveBody())
     mStaticColliders.PushBack(collider);
   else
+  {
     mDynamicColliders.PushBack(collider);
+    mIslandManager->AddCollider(collider);
+  }
 }
 
 void PhysicsSpace::AddComponent(PhysicsCar* car)
@@ -1671,6 +2267,14 @@ void PhysicsSpace::AddComponent(SpringSystem* system)
 void PhysicsSpace::RemoveComponent(SpringSystem* system)
 {
   SpringSystems::Unlink(system);
+
+  // A new system could be created at the same address, so make sure
+  // no group thinks its edges were already built for it
+  for(uint i = 0; i < mSpringGroups.Size(); ++i)
+  {
+    mSpringGroups[i].mSystems.Clear();
+    mSpringGroups[i].mSolver.Invalidate();
+  }
 }
 
 PhysicsEffectList::range PhysicsSpace::GetGlobalEffects()
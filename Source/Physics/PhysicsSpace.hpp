@@ -6,7 +6,7 @@ namespace Plasma
 class BroadPhasePackage;
 typedef Array<Collider*> ColliderArray;
 
-DeclareBitField3(PhysicsSpaceFlags, AllowSleep, Mode2D, Deterministic);
+DeclareBitField4(PhysicsSpaceFlags, AllowSleep, Mode2D, Deterministic, FixedTimestep);
 
 namespace Tags
 {
@@ -99,6 +99,11 @@ public:
   void SetPostProcessIslands(bool postProcess);
   /// How many islands currently exist. For debugging.
   uint GetIslandCount() const;
+  /// How many possible pairs had a cached separating axis to check last step. For debugging.
+  uint GetPairCacheTestCount() const;
+  /// How many possible pairs skipped the collision test last step because
+  /// their cached separating axis still separated them. For debugging.
+  uint GetPairCacheHitCount() const;
   /// (Internal) Configures if one Solver is used across all islands. For performance testing.
   bool GetIsSolverShared() const;
   void SetIsSolverShared(bool shared);
@@ -148,6 +153,20 @@ public:
 
   /// Forces all queued computations in physics to be updated now. Should only be used for debugging.
   void FlushPhysicsQueue();
+
+  /// How many states SaveState keeps before the oldest one is overwritten.
+  /// Changing this discards all saved states. Defaults to 0 (saving is disabled).
+  uint GetSavedStateCount() const;
+  void SetSavedStateCount(uint count);
+  /// Saves the state of all dynamic rigid bodies along with the contact and joint
+  /// impulses used for warm starting. Meant to be called every frame (between
+  /// updates) for rewinding. Returns the id to pass to RestoreState (0 on failure).
+  uint SaveState();
+  /// Puts the bodies, contacts and joints back into a saved state so the following
+  /// frames can be simulated again. States saved after it are discarded (the next
+  /// SaveState continues from its id). Objects created or destroyed since the state
+  /// was saved are left alone. Returns false if the state was already overwritten.
+  bool RestoreState(uint stateId);
   /// Updates all queues for pending physics calculation. Beforehand, it also recomputes
   /// the world matrix values so that everything is in the right spot.
   void PushBroadPhaseQueue();
@@ -158,6 +177,8 @@ public:
   /// Iterates one timestep of physics with the given dt. Does not take care of
   /// batch insertion/removal in broadphases or debug drawing.
   void IterateTimestep(real dt);
+  /// Runs as many fixed timesteps as the accumulated frame time allows.
+  void IterateFixedTimesteps(real frameTime);
 
   /// Adds global effect to all bodies then integrates force to velocity.
   void IntegrateBodiesVelocity(real dt);
@@ -166,7 +187,8 @@ public:
   /// Updates all BroadPhases and then finds all possible collision pairs.
   void BroadPhase();
   /// Takes the possible collisions from the BroadPhase step and checks if they
-  /// actually collide. If they do collide then they are added to the IslandManager.
+  /// actually collide (in parallel when there are enough). The results are then
+  /// added to the ContactManager and IslandManager in pair order.
   void NarrowPhase();
   /// Sends out any pre-solve events so users can modify state before resolution.
   void PreSolve(real dt);
@@ -207,6 +229,15 @@ public:
   /// given filter. This returns up to maxCount number of objects.
   CastResultsRange CastSegment(const Segment& segment, uint maxCount, CastFilter& filter);
 
+  //------------------------------------------------------------- Batch Casting
+  /// Finds up to maxCount colliders hit by each of the rays using one filter.
+  /// The rays are cast in an order that keeps neighboring rays together and
+  /// large batches are split across the job workers (unless the filter uses a
+  /// callback event). The results are stored per ray in the order given.
+  void CastRayBatch(const Array<Ray>& worldRays, uint maxCount, CastFilter& filter, CastBatchResults& results);
+  /// Batch version of CastSegment, see CastRayBatch.
+  void CastSegmentBatch(const Array<Segment>& segments, uint maxCount, CastFilter& filter, CastBatchResults& results);
+
   //------------------------------------------------------------- Aabb Casting
   void CastAabb(const Aabb& aabb, CastResults& results);
   /// Finds all colliders in the space that an Aabb hits using the
@@ -252,6 +283,21 @@ public:
   /// Used to achieve higher accuracy and increase visual results.
   uint GetSubStepCount() const;
   void SetSubStepCount(uint substeps);
+  /// Steps physics with a constant timestep (FixedTimestepLength) instead of the
+  /// frame's dt. Time left over between steps is carried to the next frame and
+  /// rigid body transforms are published as a blend between the last two steps,
+  /// so they lag behind the simulation by up to one step. Steps still run on the
+  /// game thread during the logic update, so a slow step still delays the frame.
+  bool GetFixedTimestep() const;
+  void SetFixedTimestep(bool state);
+  /// The length of one step (in seconds) when FixedTimestep is enabled.
+  real GetFixedTimestepLength() const;
+  void SetFixedTimestepLength(real length);
+  /// The most fixed steps that will be taken in one frame. Any time past that is
+  /// dropped so that a slow frame doesn't make the following frames even slower
+  /// (this only limits catching up, it doesn't make a single step any cheaper).
+  uint GetMaxStepsPerFrame() const;
+  void SetMaxStepsPerFrame(uint maxSteps);
 
   /// Determines if anything in the space is allowed to fall sleep.
   bool GetAllowSleep() const;
@@ -324,8 +370,12 @@ private:
   void UpdateRegions(real dt);
   /// Apply misc. effects sitting in the middle of a hierarchy
   void ApplyHierarchyEffects(real dt);
-  /// Apply global effects (PhysicsSpace/LevelSettings) to the given body
-  void ApplyGlobalEffects(RigidBody* body, real dt);
+  /// Apply global effects (PhysicsSpace/LevelSettings) to all awake bodies
+  void ApplyGlobalEffects(real dt);
+
+  /// Casts a batch of rays or segments (only one of the arrays is given).
+  void CastBatch(const Ray* rays, const Segment* segments, uint castCount, uint maxCount,
+                 CastFilter& filter, CastBatchResults& results);
 
   /// Checks all inactive objects to see if they should be woken up.
   void WakeInactiveMovingBodies();
@@ -363,6 +413,24 @@ private:
   // Stores the objects returned from the broad phase for that frame.  It is
   // not created on the stack each frame to avoid allocations.
   ClientPairArray mPossiblePairs;
+  // The narrow phase results of the possible pairs, one buffer per task. Kept
+  // between frames to avoid allocations.
+  Array<Physics::NarrowPhaseBuffer> mNarrowPhaseBuffers;
+  // The separating axes of pairs that didn't collide, kept between frames to
+  // skip testing pairs that are still apart.
+  Physics::PairCache mPairCache;
+
+  // The state of the awake bodies during integration. Kept between
+  // frames to avoid allocations.
+  Physics::BodyStateArrays mBodyStates;
+
+  // The groups of connected spring systems. Only the first mSpringGroupCount are
+  // used this frame; the rest are kept (along with the traversal stack) to avoid
+  // allocations and so each group's solver can reuse its edges.
+  Array<SpringGroup> mSpringGroups;
+  uint mSpringGroupCount;
+  Array<SpringSystem*> mSpringStack;
+  uint mSpringStep;
 
   // Stores all broad phase information.
   BroadPhasePackage* mBroadPhase;
@@ -424,6 +492,19 @@ public:
   uint mSubStepCount;
   HashSet<u64> mFilteredPairs;
 
+  real mFixedTimestepLength;
+  uint mMaxStepsPerFrame;
+  // Frame time that hasn't been simulated yet when using a fixed timestep.
+  real mTimeAccumulator;
+  // How far the accumulated time is into the next fixed step (0 to 1).
+  real mInterpolationFactor;
+
+  // States kept for SaveState/RestoreState.
+  Physics::PhysicsSnapshotBuffer mSavedStates;
+  // The state restored since the last narrow phase. Contacts that existed in it but
+  // not when it was restored continue from their saved manifold when re-created.
+  Physics::PhysicsSnapshot* mRestoredState;
+
   // Dt of the current iteration. Stored for when I don't want to pass down dt
   // 20 layers to use in one place. The object can grab this from it's space
   // if it is operating during IterateTimestep.
@@ -109,6 +109,8 @@ public:
 #include "PhysicsCar.hpp"
 #include "PhysicsCarWheel.hpp"
 #include "DebugFlags.hpp"
+#include "SimdLanes.hpp"
+#include "SpringSolver.hpp"
 #include "SpringSystem.hpp"
 
 // Misc Joints Stuff
@@ -130,6 +132,7 @@ public:
 #include "Joints/JointMotor.hpp"
 #include "Joints/NormalSolver.hpp"
 #include "Joints/SerializationFragments.hpp"
+#include "Joints/SimdSolver.hpp"
 #include "Joints/SolverFragments.hpp"
 #include "Joints/JointSpring.hpp"
 #include "Joints/JointEvents.hpp"
@@ -139,6 +142,9 @@ public:
 
 #include "RayCast.hpp"
 #include "Manifold.hpp"
+#include "PairCache.hpp"
+#include "PhysicsSnapshot.hpp"
+#include "BodyStateArrays.hpp"
 #include "PhysicsSpace.hpp"
 
 // BroadPhase
@@ -315,6 +315,27 @@ void CastResults::ConvertToColliders()
   }
 }
 
+//------------------------------------------------------------CastBatchResults
+uint CastBatchResults::GetCastCount() const
+{
+  if(mOffsets.Empty())
+    return 0;
+  return mOffsets.Size() - 1;
+}
+
+CastResultArray::range CastBatchResults::GetResults(uint castIndex)
+{
+  ErrorIf(castIndex >= GetCastCount(), "Index out of range.");
+  uint start = mOffsets[castIndex];
+  return mResults.SubRange(start, mOffsets[castIndex + 1] - start);
+}
+
+void CastBatchResults::Clear()
+{
+  mResults.Clear();
+  mOffsets.Clear();
+}
+
 //------------------------------------------------------------CastResultsRange
 CastResultsRange::CastResultsRange(const CastResults& castResults)
 {
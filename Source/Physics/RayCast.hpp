@@ -162,6 +162,24 @@ private:
   ProxyCastResults mResults;
 };
 
+//-------------------------------------------------------------------CastBatchResults
+/// The results of a batch of casts on a PhysicsSpace. The results of every cast
+/// are stored in one array, in the order the casts were given and each cast's
+/// results sorted by time of collision.
+struct CastBatchResults
+{
+  /// Returns the number of casts in the batch.
+  uint GetCastCount() const;
+  /// Returns the results of the cast at the given index.
+  CastResultArray::range GetResults(uint castIndex);
+  void Clear();
+
+  CastResultArray mResults;
+  /// The index in mResults of the first result of each cast
+  /// (followed by the total number of results).
+  Array<uint> mOffsets;
+};
+
 //-------------------------------------------------------------------CastResultsRange
 struct CastResultsRange
 {
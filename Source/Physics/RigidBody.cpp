@@ -76,10 +76,13 @@ RigidBody::RigidBody()
   mCenterOfMass.ZeroOut();
   mPositionOffset.ZeroOut();
   mRotationQuat = Quat::cIdentity;
+  mPreviousTranslation.ZeroOut();
+  mPreviousRotation = Quat::cIdentity;
   mSleepTimer = real(0);
   mState.SetFlag(RigidBodyStates::AllowSleep);
   mState.SetFlag(RigidBodyStates::Inherit2DMode);
   mState.ClearFlag(RigidBodyStates::SleepAccumulated);
+  mState.SetFlag(RigidBodyStates::ResetInterpolation);
   SetAxisLock(false, false, false);
   mParentBody = nullptr;
   mPhysicsNode = nullptr;
@@ -152,6 +155,9 @@ void RigidBody::TransformUpdate(TransformUpdateInfo& info)
   if(mPhysicsNode == nullptr || mPhysicsNode->IsDying())
     return;
 
+  // The body was moved, so don't blend from where it was before the move
+  mState.SetFlag(RigidBodyStates::ResetInterpolation);
+
   // If we ever get a transform update but have no collider, that means we have
   // to handle queuing the transform update for this node
   if(mPhysicsNode->mCollider == nullptr)
@@ -1025,6 +1031,16 @@ void RigidBody::UpdateOrientation(QuatParam offset)
   InternalRecomputeOrientation();
 }
 
+void RigidBody::SetIntegratedTransform(Vec3Param centerOfMass, QuatParam rotation)
+{
+  // Clamp the center of mass to avoid getting to bad floating point positions
+  mCenterOfMass = Transform::ClampTranslation(GetSpace(), GetOwner(), centerOfMass);
+  mRotationQuat = rotation;
+
+  // Updates the cached world transform for both the rotation and the center of mass
+  InternalRecomputeOrientation();
+}
+
 void RigidBody::Rotate(QuatParam rotation)
 {
   // Perform a full rotation (no small angle approximation)
@@ -1095,6 +1111,31 @@ void RigidBody::PublishTransform()
   transform->UpdateAll(TransformUpdateFlags::Physics);
 }
 
+void RigidBody::SaveInterpolationState()
+{
+  mPreviousTranslation = mPhysicsNode->GetTransform()->GetPublishedTranslation();
+  mPreviousRotation = mRotationQuat;
+  mState.ClearFlag(RigidBodyStates::ResetInterpolation);
+}
+
+void RigidBody::PublishInterpolatedTransform(real t)
+{
+  // If the body was moved or just started moving then the saved state isn't
+  // from the last step, so snap to the current values instead of blending
+  if(mState.IsSet(RigidBodyStates::ResetInterpolation))
+  {
+    SaveInterpolationState();
+    PublishTransform();
+    return;
+  }
+
+  Vec3 translation = mPhysicsNode->GetTransform()->GetPublishedTranslation();
+  Transform* transform = GetOwner()->has(Transform);
+  transform->SetWorldTranslationInternal(Math::Lerp(mPreviousTranslation, translation, t));
+  transform->SetWorldRotationInternal(Math::Slerp(mPreviousRotation, mRotationQuat, t));
+  transform->UpdateAll(TransformUpdateFlags::Physics);
+}
+
 void RigidBody::AddBodyEffect(PhysicsEffect* effect)
 {
   mEffects.PushBack(effect);
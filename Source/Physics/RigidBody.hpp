@@ -12,14 +12,15 @@ class PhysicsNode;
 class IgnoreSpaceEffects;
 
 // Internal states of a rigid body.
-DeclareBitField8(RigidBodyStates, Static, 
+DeclareBitField9(RigidBodyStates, Static, 
                                   Asleep, 
                                   Kinematic, 
                                   RotationLocked, 
                                   Mode2D, 
                                   AllowSleep,
                                   Inherit2DMode,
-                                  SleepAccumulated);
+                                  SleepAccumulated,
+                                  ResetInterpolation);
 
 /// What kind of dynamics this body should have. Determines if forces are
 /// integrated and if collisions are resolved.
@@ -304,6 +305,9 @@ public:
   /// does a small angle approximation). This updates the body's cached world transform
   /// data as we not only rotate but the position might be rotating about the center of mass.
   void UpdateOrientation(QuatParam offset);
+  /// Sets the center of mass and rotation computed by integration (see UpdateCenterMass
+  /// and UpdateOrientation, the rotation must be normalized).
+  void SetIntegratedTransform(Vec3Param centerOfMass, QuatParam rotation);
   /// Applies a rotation to the rigid body.
   void Rotate(QuatParam rotation);
   /// Shared logic when updating orientation (assumes mRotationQuat was already set and normalized).
@@ -313,6 +317,11 @@ public:
   void GenerateIntegrationUpdate();
   /// Set the transform values from the current cached body-to-world values
   void PublishTransform();
+  /// Saves the current body-to-world values as the start of the next fixed timestep.
+  void SaveInterpolationState();
+  /// Set the transform values to a blend between the state saved before the last fixed
+  /// timestep (t = 0) and the current cached body-to-world values (t = 1).
+  void PublishInterpolatedTransform(real t);
   
   /// Adds an effect to be applied to this body.
   void AddBodyEffect(PhysicsEffect* effect);
@@ -344,6 +353,10 @@ public:
   Vec3 mPositionOffset;
   /// The rotation of the body. A quaternion is needed for integration.
   Quat mRotationQuat;
+  /// The translation and rotation before the last fixed timestep. Used to
+  /// interpolate the published transform when the space has a fixed timestep.
+  Vec3 mPreviousTranslation;
+  Quat mPreviousRotation;
   /// Mass and inertia are stored as inverses for efficiency.
   Physics::Mass mInvMass;
   Physics::Inertia mInvInertia;
@@ -0,0 +1,212 @@
+#pragma once
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+///How many values are processed together by the simd kernels.
+const uint cSimdLaneCount = 4;
+
+///A value for each lane of a simd kernel.
+struct SimdLanes
+{
+  real mLanes[cSimdLaneCount];
+};
+
+//Lane-wise math for the simd kernels. With sse each operation covers
+//every lane at once, otherwise the lanes are looped over.
+#if defined(USESSE)
+
+typedef Math::Simd::SimVec LaneValue;
+
+SimInline LaneValue LoadLanes(const SimdLanes& lanes)
+{
+  return Math::Simd::UnAlignedLoad(lanes.mLanes);
+}
+
+SimInline void StoreLanes(const LaneValue& value, SimdLanes& lanes)
+{
+  Math::Simd::UnAlignedStore(value, lanes.mLanes);
+}
+
+//Loads/stores cSimdLaneCount consecutive values (that don't have to be aligned).
+SimInline LaneValue LoadLanes(const real* values)
+{
+  return Math::Simd::UnAlignedLoad(values);
+}
+
+SimInline void StoreLanes(const LaneValue& value, real* values)
+{
+  Math::Simd::UnAlignedStore(value, values);
+}
+
+SimInline LaneValue SplatLanes(real value)
+{
+  return Math::Simd::Set(value);
+}
+
+SimInline LaneValue SetLanes(real lane0, real lane1, real lane2, real lane3)
+{
+  return Math::Simd::Set4(lane0, lane1, lane2, lane3);
+}
+
+SimInline LaneValue AddLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  return Math::Simd::Add(lhs, rhs);
+}
+
+SimInline LaneValue SubtractLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  return Math::Simd::Subtract(lhs, rhs);
+}
+
+SimInline LaneValue MultiplyLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  return Math::Simd::Multiply(lhs, rhs);
+}
+
+//Returns v0 * v1 + v2.
+SimInline LaneValue MultiplyAddLanes(const LaneValue& v0, const LaneValue& v1, const LaneValue& v2)
+{
+  return Math::Simd::MultiplyAdd(v0, v1, v2);
+}
+
+SimInline LaneValue ClampLanes(const LaneValue& value, const LaneValue& minValue, const LaneValue& maxValue)
+{
+  return Math::Simd::Clamp(value, minValue, maxValue);
+}
+
+SimInline LaneValue DivideLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  return Math::Simd::Divide(lhs, rhs);
+}
+
+SimInline LaneValue SqrtLanes(const LaneValue& value)
+{
+  return Math::Simd::Sqrt(value);
+}
+
+SimInline LaneValue MaxLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  return Math::Simd::Max(lhs, rhs);
+}
+
+#else
+
+typedef SimdLanes LaneValue;
+
+inline LaneValue LoadLanes(const SimdLanes& lanes)
+{
+  return lanes;
+}
+
+inline void StoreLanes(const LaneValue& value, SimdLanes& lanes)
+{
+  lanes = value;
+}
+
+//Loads/stores cSimdLaneCount consecutive values (that don't have to be aligned).
+inline LaneValue LoadLanes(const real* values)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = values[i];
+  return result;
+}
+
+inline void StoreLanes(const LaneValue& value, real* values)
+{
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    values[i] = value.mLanes[i];
+}
+
+inline LaneValue SetLanes(real lane0, real lane1, real lane2, real lane3)
+{
+  LaneValue result;
+  result.mLanes[0] = lane0;
+  result.mLanes[1] = lane1;
+  result.mLanes[2] = lane2;
+  result.mLanes[3] = lane3;
+  return result;
+}
+
+inline LaneValue SplatLanes(real value)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = value;
+  return result;
+}
+
+inline LaneValue AddLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = lhs.mLanes[i] + rhs.mLanes[i];
+  return result;
+}
+
+inline LaneValue SubtractLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = lhs.mLanes[i] - rhs.mLanes[i];
+  return result;
+}
+
+inline LaneValue MultiplyLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = lhs.mLanes[i] * rhs.mLanes[i];
+  return result;
+}
+
+//Returns v0 * v1 + v2.
+inline LaneValue MultiplyAddLanes(const LaneValue& v0, const LaneValue& v1, const LaneValue& v2)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = v0.mLanes[i] * v1.mLanes[i] + v2.mLanes[i];
+  return result;
+}
+
+inline LaneValue ClampLanes(const LaneValue& value, const LaneValue& minValue, const LaneValue& maxValue)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = Math::Clamp(value.mLanes[i], minValue.mLanes[i], maxValue.mLanes[i]);
+  return result;
+}
+
+inline LaneValue DivideLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = lhs.mLanes[i] / rhs.mLanes[i];
+  return result;
+}
+
+inline LaneValue SqrtLanes(const LaneValue& value)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = Math::Sqrt(value.mLanes[i]);
+  return result;
+}
+
+inline LaneValue MaxLanes(const LaneValue& lhs, const LaneValue& rhs)
+{
+  LaneValue result;
+  for(uint i = 0; i < cSimdLaneCount; ++i)
+    result.mLanes[i] = Math::Max(lhs.mLanes[i], rhs.mLanes[i]);
+  return result;
+}
+
+#endif
+
+}//namespace Physics
+
+}//namespace Plasma
@@ -0,0 +1,326 @@
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+//Points can't have more edges of different colors than there are bits in the
+//mask. Edges that don't fit are solved one at a time after the colored ones.
+const uint cMaxSpringColors = 64;
+//Keeps the relaxation from dividing by zero for edges with no length or no
+//mass (they get no correction either way, see SolveSerialEdge).
+const real cMinSpringDenominator = real(1e-12);
+
+SpringSolver::SpringSolver()
+{
+  mEdgeCount = 0;
+}
+
+void SpringSolver::Invalidate()
+{
+  mBuiltSystems.Clear();
+  mBuiltVersions.Clear();
+  mBuiltCorrections.Clear();
+}
+
+bool SpringSolver::IsBuiltFor(const Array<SpringSystem*>& systems)
+{
+  if(mBuiltSystems.Size() != systems.Size())
+    return false;
+
+  for(uint i = 0; i < systems.Size(); ++i)
+  {
+    SpringSystem* system = systems[i];
+    if(mBuiltSystems[i] != system || mBuiltVersions[i] != system->mTopologyVersion ||
+       mBuiltCorrections[i] != system->mCorrectionPercent)
+      return false;
+  }
+  return true;
+}
+
+void SpringSolver::Build(const Array<SpringSystem*>& systems)
+{
+  if(IsBuiltFor(systems))
+    return;
+
+  ZoneScoped;
+
+  mBuiltSystems.Clear();
+  mBuiltVersions.Clear();
+  mBuiltCorrections.Clear();
+  mPointStarts.Clear();
+
+  uint pointCount = 0;
+  for(uint i = 0; i < systems.Size(); ++i)
+  {
+    SpringSystem* system = systems[i];
+    mBuiltSystems.PushBack(system);
+    mBuiltVersions.PushBack(system->mTopologyVersion);
+    mBuiltCorrections.PushBack(system->mCorrectionPercent);
+    mPointStarts.PushBack(pointCount);
+    pointCount += (uint)system->mPointMasses.Size();
+  }
+
+  //one extra point for the unused lanes
+  for(uint axis = 0; axis < 3; ++axis)
+    mPositions[axis].Resize(pointCount + 1);
+  mInvMasses.Resize(pointCount + 1);
+
+  mPointColors.Resize(pointCount);
+  for(uint i = 0; i < pointCount; ++i)
+    mPointColors[i] = 0;
+  mColoredEdges.Clear();
+  mEdgeColors.Clear();
+  mSerialEdges.Clear();
+
+  //color the edges in the order the systems solved them in (internal edges
+  //and then owned connections) so a sorted system's edges stay mostly in order
+  for(uint i = 0; i < systems.Size(); ++i)
+  {
+    SpringSystem* system = systems[i];
+    uint pointStart = mPointStarts[i];
+    real correction = system->mCorrectionPercent;
+
+    for(uint edgeIndex = 0; edgeIndex < system->mEdges.Size(); ++edgeIndex)
+    {
+      SpringSystem::Edge& edge = system->mEdges[edgeIndex];
+      AddEdge(pointStart + edge.mIndex0, pointStart + edge.mIndex1, edge.mRestLength, correction);
+    }
+
+    SpringSystem::OwnedEdgeList::range range = system->mOwnedEdges.All();
+    for(; !range.Empty(); range.PopFront())
+    {
+      SpringSystem::SystemConnection& connection = range.Front();
+      size_t otherIndex = systems.FindIndex(connection.mOtherSystem);
+      ErrorIf(otherIndex == Array<SpringSystem*>::InvalidIndex, "Connected spring system is not in the group.");
+      uint otherStart = mPointStarts[otherIndex];
+
+      for(uint edgeIndex = 0; edgeIndex < connection.mEdges.Size(); ++edgeIndex)
+      {
+        SpringSystem::Edge& edge = connection.mEdges[edgeIndex];
+        AddEdge(pointStart + edge.mIndex0, otherStart + edge.mIndex1, edge.mRestLength, correction);
+      }
+    }
+  }
+
+  //count the edges of each color and pad every color out to whole lanes
+  mColorCounts.Resize(cMaxSpringColors);
+  for(uint color = 0; color < cMaxSpringColors; ++color)
+    mColorCounts[color] = 0;
+  for(uint i = 0; i < mEdgeColors.Size(); ++i)
+    ++mColorCounts[mEdgeColors[i]];
+
+  uint laneCount = 0;
+  for(uint color = 0; color < cMaxSpringColors; ++color)
+  {
+    uint colorLanes = (mColorCounts[color] + cSimdLaneCount - 1) / cSimdLaneCount;
+    //turn the counts into the index of the color's first lane
+    mColorCounts[color] = laneCount;
+    laneCount += colorLanes;
+  }
+
+  mEdgeLanes.Resize(laneCount);
+  for(uint i = 0; i < laneCount; ++i)
+  {
+    SpringEdgeLanes& lanes = mEdgeLanes[i];
+    for(uint lane = 0; lane < cSimdLaneCount; ++lane)
+    {
+      lanes.mIndices[0][lane] = pointCount;
+      lanes.mIndices[1][lane] = pointCount;
+      lanes.mRestLength.mLanes[lane] = real(0.0);
+      lanes.mCorrection.mLanes[lane] = real(0.0);
+    }
+  }
+
+  //fill the lanes of each color in edge order (the color's count is
+  //reused as the index of the next edge to write)
+  for(uint i = 0; i < mColoredEdges.Size(); ++i)
+  {
+    SpringSerialEdge& edge = mColoredEdges[i];
+    uint slot = mColorCounts[mEdgeColors[i]]++;
+    SpringEdgeLanes& lanes = mEdgeLanes[slot / cSimdLaneCount];
+    uint lane = slot % cSimdLaneCount;
+    lanes.mIndices[0][lane] = edge.mIndex0;
+    lanes.mIndices[1][lane] = edge.mIndex1;
+    lanes.mRestLength.mLanes[lane] = edge.mRestLength;
+    lanes.mCorrection.mLanes[lane] = edge.mCorrection;
+  }
+
+  mEdgeCount = (uint)(mColoredEdges.Size() + mSerialEdges.Size());
+}
+
+void SpringSolver::AddEdge(uint index0, uint index1, real restLength, real correction)
+{
+  SpringSerialEdge edge;
+  edge.mIndex0 = index0;
+  edge.mIndex1 = index1;
+  edge.mRestLength = restLength;
+  edge.mCorrection = correction;
+
+  u64 usedColors = mPointColors[index0] | mPointColors[index1];
+  if(usedColors == (u64)-1)
+  {
+    mSerialEdges.PushBack(edge);
+    return;
+  }
+
+  uint color = 0;
+  while(usedColors & ((u64)1 << color))
+    ++color;
+
+  mPointColors[index0] |= (u64)1 << color;
+  mPointColors[index1] |= (u64)1 << color;
+  mColoredEdges.PushBack(edge);
+  mEdgeColors.PushBack(color);
+}
+
+void SpringSolver::GatherPoints(const Array<SpringSystem*>& systems)
+{
+  for(uint i = 0; i < systems.Size(); ++i)
+  {
+    SpringSystem::PointMasses& points = systems[i]->mPointMasses;
+    uint pointStart = mPointStarts[i];
+    for(uint pointIndex = 0; pointIndex < points.Size(); ++pointIndex)
+    {
+      SpringSystem::PointMass& point = points[pointIndex];
+      mPositions[0][pointStart + pointIndex] = point.mPosition.x;
+      mPositions[1][pointStart + pointIndex] = point.mPosition.y;
+      mPositions[2][pointStart + pointIndex] = point.mPosition.z;
+      mInvMasses[pointStart + pointIndex] = point.mInvMass;
+    }
+  }
+
+  uint paddingIndex = (uint)mInvMasses.Size() - 1;
+  for(uint axis = 0; axis < 3; ++axis)
+    mPositions[axis][paddingIndex] = real(0.0);
+  mInvMasses[paddingIndex] = real(0.0);
+}
+
+void SpringSolver::ScatterPoints(const Array<SpringSystem*>& systems)
+{
+  for(uint i = 0; i < systems.Size(); ++i)
+  {
+    SpringSystem::PointMasses& points = systems[i]->mPointMasses;
+    uint pointStart = mPointStarts[i];
+    for(uint pointIndex = 0; pointIndex < points.Size(); ++pointIndex)
+    {
+      Vec3& position = points[pointIndex].mPosition;
+      position.x = mPositions[0][pointStart + pointIndex];
+      position.y = mPositions[1][pointStart + pointIndex];
+      position.z = mPositions[2][pointStart + pointIndex];
+    }
+  }
+}
+
+void SpringSolver::Relax(uint iterations)
+{
+  for(uint iteration = 0; iteration < iterations; ++iteration)
+  {
+    for(uint i = 0; i < mEdgeLanes.Size(); ++i)
+      SolveEdgeLanes(mEdgeLanes[i]);
+    for(uint i = 0; i < mSerialEdges.Size(); ++i)
+      SolveSerialEdge(mSerialEdges[i]);
+  }
+}
+
+uint SpringSolver::GetEdgeCount() const
+{
+  return mEdgeCount;
+}
+
+//The same math as SolveSerialEdge, just for several edges at once.
+void SpringSolver::SolveEdgeLanes(SpringEdgeLanes& lanes)
+{
+  //gather both points of each lane by component
+  SimdLanes gathered[8];
+  for(uint lane = 0; lane < cSimdLaneCount; ++lane)
+  {
+    uint index0 = lanes.mIndices[0][lane];
+    uint index1 = lanes.mIndices[1][lane];
+    for(uint axis = 0; axis < 3; ++axis)
+    {
+      gathered[axis].mLanes[lane] = mPositions[axis][index0];
+      gathered[axis + 3].mLanes[lane] = mPositions[axis][index1];
+    }
+    gathered[6].mLanes[lane] = mInvMasses[index0];
+    gathered[7].mLanes[lane] = mInvMasses[index1];
+  }
+
+  LaneValue invMass0 = LoadLanes(gathered[6]);
+  LaneValue invMass1 = LoadLanes(gathered[7]);
+  LaneValue posDiff[3];
+  LaneValue lengthSq = SplatLanes(real(0.0));
+  for(uint axis = 0; axis < 3; ++axis)
+  {
+    posDiff[axis] = SubtractLanes(LoadLanes(gathered[axis + 3]), LoadLanes(gathered[axis]));
+    lengthSq = MultiplyAddLanes(posDiff[axis], posDiff[axis], lengthSq);
+  }
+  LaneValue length = SqrtLanes(lengthSq);
+
+  //diff = -(length - restLength) / (length * invMassSum)
+  LaneValue denominator = MultiplyLanes(length, AddLanes(invMass0, invMass1));
+  denominator = MaxLanes(denominator, SplatLanes(cMinSpringDenominator));
+  LaneValue diff = SubtractLanes(LoadLanes(lanes.mRestLength), length);
+  diff = DivideLanes(diff, denominator);
+  diff = MultiplyLanes(diff, LoadLanes(lanes.mCorrection));
+
+  LaneValue impulseScale0 = MultiplyLanes(diff, invMass0);
+  LaneValue impulseScale1 = MultiplyLanes(diff, invMass1);
+  for(uint axis = 0; axis < 3; ++axis)
+  {
+    LaneValue position0 = SubtractLanes(LoadLanes(gathered[axis]), MultiplyLanes(posDiff[axis], impulseScale0));
+    LaneValue position1 = MultiplyAddLanes(posDiff[axis], impulseScale1, LoadLanes(gathered[axis + 3]));
+    StoreLanes(position0, gathered[axis]);
+    StoreLanes(position1, gathered[axis + 3]);
+  }
+
+  //no two lanes share a point so the scatter order doesn't matter
+  //(other than the padding point, which never moves)
+  for(uint lane = 0; lane < cSimdLaneCount; ++lane)
+  {
+    uint index0 = lanes.mIndices[0][lane];
+    uint index1 = lanes.mIndices[1][lane];
+    for(uint axis = 0; axis < 3; ++axis)
+    {
+      mPositions[axis][index0] = gathered[axis].mLanes[lane];
+      mPositions[axis][index1] = gathered[axis + 3].mLanes[lane];
+    }
+  }
+}
+
+//Solves one edge to be at its rest length based upon the mass ratio of the points.
+void SpringSolver::SolveSerialEdge(SpringSerialEdge& edge)
+{
+  real invMass0 = mInvMasses[edge.mIndex0];
+  real invMass1 = mInvMasses[edge.mIndex1];
+  real invMassSum = invMass0 + invMass1;
+  if(invMassSum == 0)
+    return;
+
+  Vec3 p0(mPositions[0][edge.mIndex0], mPositions[1][edge.mIndex0], mPositions[2][edge.mIndex0]);
+  Vec3 p1(mPositions[0][edge.mIndex1], mPositions[1][edge.mIndex1], mPositions[2][edge.mIndex1]);
+  //based up a Jakobsen spring which is corrected by just snapping each
+  //particle to be at the rest length (after doing mass ratios and whatnot)
+  Vec3 posDiff = p1 - p0;
+  real length = posDiff.Length();
+  if(length == real(0.0))
+    return;
+
+  real diff = -(length - edge.mRestLength);
+  diff /= length * invMassSum;
+  Vec3 impulse = posDiff * diff * edge.mCorrection;
+
+  p0 -= invMass0 * impulse;
+  p1 += invMass1 * impulse;
+  for(uint axis = 0; axis < 3; ++axis)
+  {
+    mPositions[axis][edge.mIndex0] = p0[axis];
+    mPositions[axis][edge.mIndex1] = p1[axis];
+  }
+}
+
+}//namespace Physics
+
+}//namespace Plasma
@@ -0,0 +1,86 @@
+#pragma once
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+///cSimdLaneCount edges of a spring group that don't share any point.
+///Unused lanes point at the group's padding point (which has no mass).
+struct SpringEdgeLanes
+{
+  uint mIndices[2][cSimdLaneCount];
+  SimdLanes mRestLength;
+  ///The correction percent of the system that owns each edge.
+  SimdLanes mCorrection;
+};
+
+///An edge that couldn't be given a color (too many edges share one of its points).
+struct SpringSerialEdge
+{
+  uint mIndex0;
+  uint mIndex1;
+  real mRestLength;
+  real mCorrection;
+};
+
+///Relaxes the edges of a group of connected spring systems. The points of all
+///of the systems are copied into one structure of arrays each step and the
+///edges (including the connections between the systems) are graph colored
+///so that each color's edges can be solved cSimdLaneCount at a time. The
+///colored edges only depend on the topology of the systems, so they're only
+///rebuilt when a system's edges, points or connections change.
+class SpringSolver
+{
+public:
+  SpringSolver();
+
+  ///Forgets the built edges so they're rebuilt on the next Build.
+  void Invalidate();
+  ///Builds the colored edges if the systems (or their topology) changed since
+  ///the last build. Every system's connections must be to systems in the list.
+  void Build(const Array<SpringSystem*>& systems);
+
+  ///Copies the positions and masses of the systems' points in and out.
+  void GatherPoints(const Array<SpringSystem*>& systems);
+  void ScatterPoints(const Array<SpringSystem*>& systems);
+  ///Runs the given number of relaxation iterations over all of the edges.
+  void Relax(uint iterations);
+
+  uint GetEdgeCount() const;
+
+private:
+  ///Returns true if the edges were built for exactly these systems.
+  bool IsBuiltFor(const Array<SpringSystem*>& systems);
+  ///Assigns an edge the lowest color none of its points already has.
+  void AddEdge(uint index0, uint index1, real restLength, real correction);
+  void SolveEdgeLanes(SpringEdgeLanes& lanes);
+  void SolveSerialEdge(SpringSerialEdge& edge);
+
+  ///The points of every system (by component) followed by the padding point.
+  Array<real> mPositions[3];
+  Array<real> mInvMasses;
+  ///Index of each system's first point.
+  Array<uint> mPointStarts;
+
+  ///The edges in color order.
+  Array<SpringEdgeLanes> mEdgeLanes;
+  Array<SpringSerialEdge> mSerialEdges;
+  uint mEdgeCount;
+
+  ///What the edges were built from (see IsBuiltFor).
+  Array<SpringSystem*> mBuiltSystems;
+  Array<uint> mBuiltVersions;
+  Array<real> mBuiltCorrections;
+
+  ///Scratch space for coloring (kept to avoid allocating on every build).
+  Array<u64> mPointColors;
+  Array<SpringSerialEdge> mColoredEdges;
+  Array<uint> mEdgeColors;
+  Array<uint> mColorCounts;
+};
+
+}//namespace Physics
+
+}//namespace Plasma
@@ -98,6 +98,9 @@ void SpringSystem::Serialize(Serializer& stream)
 
 void SpringSystem::Initialize(CogInitializer& initializer)
 {
+  mTopologyVersion = 0;
+  mSpringGroupStep = 0;
+
   PhysicsSpace* space = GetSpace()->has(PhysicsSpace);
   space->AddComponent(this);
 }
@@ -244,6 +247,7 @@ void SpringSystem::RemoveConnection(SystemConnection* connection)
   OwnedEdgeList::Unlink(connection);
   ConnectedEdgeList::Unlink(connection);
   delete connection;
+  ++mTopologyVersion;
 }
 
 void SpringSystem::UpdateConnections()
@@ -344,59 +348,6 @@ void SpringSystem::SolveSpringForces()
   //  }
 }
 
-void SpringSystem::RelaxSprings()
-{
-  //solve all internal edges
-  for(uint i = 0; i < mEdges.Size(); ++i)
-  {
-    Edge& edge = mEdges[i];
-
-    PointMass& p0 = mPointMasses[edge.mIndex0];
-    PointMass& p1 = mPointMasses[edge.mIndex1];
-
-    SolveEdge(p0, p1, edge.mRestLength);
-  }
-
-  //solve all connected edges (only the ones we own to avoid a double solve)
-  for(OwnedEdgeList::range range = mOwnedEdges.All(); !range.Empty(); range.PopFront())
-  {
-    SystemConnection& connection = range.Front();
-    
-    for(uint edgeIndex = 0; edgeIndex < connection.mEdges.Size(); ++edgeIndex)
-    {
-      Edge& edge = connection.mEdges[edgeIndex];
-      
-      PointMass& p0 = connection.mOwningSystem->mPointMasses[edge.mIndex0];
-      PointMass& p1 = connection.mOtherSystem->mPointMasses[edge.mIndex1];
-    
-      SolveEdge(p0, p1, edge.mRestLength);
-    }
-  }
-}
-
-void SpringSystem::SolveEdge(PointMass& p0, PointMass& p1, real restLength)
-{
-  real invMassSum = p1.mInvMass + p0.mInvMass;
-  //should pre-sort the edges so we don't solve ones with a zero inverse sum
-  if(invMassSum == 0)
-    return;
-
-  //based up a Jakobsen spring which is corrected by just snapping each
-  //particle to be at the rest length (after doing mass ratios and whatnot)
-  Vec3 posDiff = p1.mPosition - p0.mPosition;
-  real length = posDiff.Length();
-  if(length == real(0.0))
-    return;
-
-  real diff = -(length - restLength);
-  diff /= length * invMassSum;
-
-  Vec3 impulse = posDiff * diff * mCorrectionPercent;
-
-  p0.mPosition -= p0.mInvMass * impulse;
-  p1.mPosition += p1.mInvMass * impulse;
-}
-
 void SpringSystem::UpdateVelocities(real dt)
 {
   //since position was directly modified we have an incorrect velocity so
@@ -441,6 +392,7 @@ SpringSystem::Edge& SpringSystem::AddEdge(uint index0, uint index1, real errCorr
   Vec3 pos1 = mPointMasses[index1].mPosition;
   Edge& edge = mEdges.PushBack();
   edge.Set(index0, index1, pos0, pos1);
+  ++mTopologyVersion;
   //To help with certain systems (ropes) it's useful to add a correction term to improve stiffness.
   //This is because each link will have a small amount of error so shortening each
   //edge by a small percentage will help to mitigate that error.
@@ -453,6 +405,7 @@ void SpringSystem::AddPointMass(Vec3Param position)
   PointMass point;
   point.mOldPosition = point.mPosition = position;
   mPointMasses.PushBack(point);
+  ++mTopologyVersion;
 }
 
 void SpringSystem::SetPointMassAnchor(uint index, Cog* anchorCog)
@@ -521,6 +474,7 @@ void SpringSystem::AddConnection(SpringSystem* otherSystem, uint indexA, uint in
 
   Edge& edge = connection->mEdges.PushBack();
   edge.Set(indexA, indexB, pointA, pointB);
+  ++mTopologyVersion;
 }
 
 SpringSystem::SystemConnection* SpringSystem::FindConnection(SpringSystem* otherSystem)
@@ -673,6 +627,7 @@ void SpringSystem::SortEdges()
     newEdge.mIndex1AnchorDistance = edges[i].mPoint1->mDistanceFromAnchor;
   }
   mEdges.Swap(newEdges);
+  ++mTopologyVersion;
 }
 
 SpringDebugDrawMode::Enum SpringSystem::GetDebugDrawMode()
@@ -922,6 +877,7 @@ void DecorativeCloth::LoadPointMeshData(const Array<Vec3>& verts, bool clearOldD
 
   if(mPointMasses.Size() != verts.Size())
     mPointMasses.Resize(verts.Size());
+  ++mTopologyVersion;
 
   Transform* t = GetOwner()->has(Transform);
 
@@ -941,6 +897,7 @@ void DecorativeCloth::LoadFromMeshData(const Array<Vec3>& verts, const Array<uin
 
   mEdges.Clear();
   mFaces.Clear();
+  ++mTopologyVersion;
 
   PointGraph graph;
   graph.SetSize(mPointMasses.Size());
@@ -1174,6 +1131,7 @@ void DecorativeRope::CreateLinks()
 
   mPointMasses.Clear();
   mEdges.Clear();
+  ++mTopologyVersion;
 
   //Since we might connect to another object or a spring system, we might not actually
   //create all of the normal links. If we're connected to a spring system we'll
@@ -1239,44 +1197,42 @@ void DecorativeRope::SetNumberOfLinks(uint linkNumber)
   mNumberOfLinks = Math::Clamp(linkNumber, 2u, 100u);
 }
 
-void SpringGroup::Solve(PhysicsSpace* space, real dt)
+void SpringGroup::PrepareSolve(PhysicsSpace* space)
 {
   //update all anchors and effects (accumulate forces)
-  SpringSystems::range range = mSystems.All();
-  for(; !range.Empty(); range.PopFront())
+  for(uint i = 0; i < mSystems.Size(); ++i)
   {
-    SpringSystem& system = range.Front();
+    SpringSystem* system = mSystems[i];
 
-    system.UpdateAnchors();
-
-    ApplyGlobalEffects(space, &system);
-    system.IntegrateVelocity(dt);
-    system.IntegratePosition(dt);
+    system->UpdateAnchors();
+    ApplyGlobalEffects(space, system);
   }
+}
 
-  //solve the springs together (it's important that this is interleaved)
-  for(uint iteration = 0; iteration < 4; ++iteration)
+void SpringGroup::Solve(real dt)
+{
+  for(uint i = 0; i < mSystems.Size(); ++i)
   {
-    range = mSystems.All();
-    for(; !range.Empty(); range.PopFront())
-    {
-      SpringSystem& system = range.Front();
-      //if(system.mJakobsen)
-        system.RelaxSprings();
-      //else
-      //  system.SolveInternalForces();
-    }
+    SpringSystem* system = mSystems[i];
+    system->IntegrateVelocity(dt);
+    system->IntegratePosition(dt);
   }
-  
-  //now finish off with integration and committing
-  range = mSystems.All();
-  for(; !range.Empty(); range.PopFront())
-  {
-    SpringSystem& system = range.Front();
 
-    system.UpdateVelocities(dt);
-    system.Commit();
-  }
+  //solve the springs together (it's important that this is interleaved, so
+  //all of the group's edges are relaxed together by the solver)
+  mSolver.Build(mSystems);
+  mSolver.GatherPoints(mSystems);
+  mSolver.Relax(4);
+  mSolver.ScatterPoints(mSystems);
+
+  for(uint i = 0; i < mSystems.Size(); ++i)
+    mSystems[i]->UpdateVelocities(dt);
+}
+
+void SpringGroup::Commit()
+{
+  for(uint i = 0; i < mSystems.Size(); ++i)
+    mSystems[i]->Commit();
 }
 
 void SpringGroup::ApplyGlobalEffects(PhysicsSpace* space, SpringSystem* system)
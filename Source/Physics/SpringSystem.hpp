@@ -80,11 +80,6 @@ public:
   // Solving functions of the spring system
   void SolveInternalForces();
   void SolveSpringForces();
-  /// Iterate through all edges, iteratively solving them,
-  /// to try to relax the system to a better global solution.
-  void RelaxSprings();
-  /// Solve one edge to be at the exact rest length based upon the mass ratio of the points.
-  void SolveEdge(PointMass& p0, PointMass& p1, real restLength);
   /// Approximate the velocity of a point based upon its old position and new position.
   void UpdateVelocities(real dt);
   void IntegrateVelocity(real dt);
@@ -243,7 +238,12 @@ public:
   ConnectedEdgeList mConnectedEdges;
 
   Link<SpringSystem> SpaceLink;
-  Link<SpringSystem> mSpringGroupLink;
+
+  /// Changed whenever points, edges or owned connections are added or removed
+  /// (so the spring group knows to rebuild its solver's edges).
+  uint mTopologyVersion;
+  /// The last step the system was added to a spring group (so it's only added once).
+  uint mSpringGroupStep;
 
   real mCorrectionPercent;
   real mPointInvMass;
@@ -341,22 +341,29 @@ public:
   bool mAnchorB;
 
   Link<DecorativeRope> SpaceLink;
-  Link<DecorativeRope> mSpringGroupLink;
 };
 
 /// To correctly solve a collection of connected spring systems, their solve
 /// must be interleaved. This group is a collection of systems (found with a graph traversal)
 /// that are solved together to help guarantee a more correct global solution.
+/// Groups don't share any points, so different groups can be solved on different threads.
 class SpringGroup
 {
 public:
-  void Solve(PhysicsSpace* space, real dt);
+  /// Update all anchors and apply effects (accumulate forces). This
+  /// reads other objects and runs effects, so it has to be on the main thread.
+  void PrepareSolve(PhysicsSpace* space);
+  /// Integrate and relax the springs. Only touches this group's systems.
+  void Solve(real dt);
+  /// Commit all systems' results (such as debug drawing).
+  void Commit();
 
   /// Helper to apply the global physics effects to a spring system.
   void ApplyGlobalEffects(PhysicsSpace* space, SpringSystem* system);
 
-  typedef InList<SpringSystem, &SpringSystem::mSpringGroupLink> SpringSystems;
-  SpringSystems mSystems;
+  Array<SpringSystem*> mSystems;
+  /// Keeps the group's colored edges between steps.
+  Physics::SpringSolver mSolver;
 };
 
 }//namespace Plasma
@@ -148,8 +148,9 @@ void Semaphore::Increment()
 void Semaphore::Decrement()
 {
   PlasmaGetPrivateData(SemaphorePrivateData);
+  // Timing out just means the count was already zero.
   int result = SDL_SemTryWait(self->mSemaphore);
-  if (result != 0)
+  if (result < 0)
     Warn(SDL_GetError());
 }
 
@@ -322,6 +322,13 @@ void GetMemoryStatus(MemoryInfo& data)
   }
 }
 
+uint GetProcessorCount()
+{
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  return (uint)systemInfo.dwNumberOfProcessors;
+}
+
 typedef void(WINAPI* GetNativeSystemInfoPtr)(LPSYSTEM_INFO);
 
 String GetVersionString()
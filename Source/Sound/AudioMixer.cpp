@@ -28,6 +28,56 @@ AudioTask::~AudioTask()
     delete mFunction;
 }
 
+AudioTask& AudioTask::operator=(const AudioTask& other)
+{
+  if (&other == this)
+    return *this;
+
+  if (mFunction)
+    delete mFunction;
+
+  mFunction = other.mFunction;
+  mObject = other.mObject;
+  const_cast<AudioTask&>(other).mFunction = nullptr;
+  return *this;
+}
+
+// Audio Task Queue
+
+// Enough for the tasks of a few mixes before the overflow list is needed
+const unsigned cAudioTaskQueueSize = 1024;
+
+AudioTaskQueue::AudioTaskQueue() : mTasks(cAudioTaskQueueSize), mOverflowing(cFalse)
+{
+}
+
+void AudioTaskQueue::Push(const AudioTask& task)
+{
+  if (mOverflowing.Get() == cFalse && mTasks.TryPush(task))
+    return;
+
+  mOverflowLock.Lock();
+  mOverflowTasks.PushBack(task);
+  mOverflowing.Set(cTrue);
+  mOverflowLock.Unlock();
+}
+
+void AudioTaskQueue::Drain(Array<AudioTask>& tasks)
+{
+  // Tasks only overflow once the ring is full, so the ring's tasks come first
+  mTasks.Drain(tasks);
+  // Only take the lock when there's something to take out
+  if (mOverflowing.Get() == cFalse)
+    return;
+
+  mOverflowLock.Lock();
+  forRange (AudioTask& task, mOverflowTasks.All())
+    tasks.PushBack(task);
+  mOverflowTasks.Clear();
+  mOverflowing.Set(cFalse);
+  mOverflowLock.Unlock();
+}
+
 // Audio Mixer
 
 AudioMixer::AudioMixer() :
@@ -36,12 +86,12 @@ AudioMixer::AudioMixer() :
     mMinimumVolumeThresholdThreaded(0.015f),
     mSendMicrophoneInputData(cFalse),
     FinalOutputNode(nullptr),
-    mMixThreadTaskWriteIndex(0),
-    mGameThreadTaskWriteIndex(0),
     mShuttingDown(cFalse),
     mVolume(1.0f),
     mPeakVolumeLastMix(0.0f),
     mRmsVolumeLastMix(0.0f),
+    mLastMixTime(0.0f),
+    mMixCount(0),
     mPreviousPeakVolumeThreaded(0.0f),
     mPreviousRMSVolumeThreaded(0),
     mResamplingThreaded(false),
@@ -169,7 +219,10 @@ void AudioMixer::MixLoopThreaded()
 
     // Mix current sounds to output buffer
     // Will return false when it's okay to shut down
+    mMixTimerThreaded.Reset();
     running = MixCurrentInstancesThreaded();
+    mLastMixTime = (float)mMixTimerThreaded.UpdateAndGetTime();
+    ++mMixCount;
 
 #ifdef TRACK_TIME
     double timeDiff = (double)(clock() - time) / CLOCKS_PER_SEC;
@@ -196,16 +249,12 @@ void AudioMixer::MixLoopThreaded()
 
 void AudioMixer::AddTask(Functor* task, HandleOf<SoundNode> node)
 {
-  MixThreadTasksLock.Lock();
-  TasksForMixThread[mMixThreadTaskWriteIndex].PushBack(AudioTask(task, node));
-  MixThreadTasksLock.Unlock();
+  TasksForMixThread.Push(AudioTask(task, node));
 }
 
 void AudioMixer::AddTaskThreaded(Functor* task, HandleOf<SoundNode> node)
 {
-  GameThreadTasksLock.Lock();
-  TasksForGameThread[mGameThreadTaskWriteIndex].PushBack(AudioTask(task, node));
-  GameThreadTasksLock.Unlock();
+  TasksForGameThread.Push(AudioTask(task, node));
 }
 
 void AudioMixer::SetLatency(AudioLatency::Enum latency)
@@ -272,6 +321,16 @@ float AudioMixer::GetRMSOutputVolume()
   return mRmsVolumeLastMix.Get(AudioThreads::MainThread);
 }
 
+float AudioMixer::GetLastMixTime()
+{
+  return mLastMixTime;
+}
+
+int AudioMixer::GetMixCount()
+{
+  return mMixCount;
+}
+
 void AudioMixer::SetMinimumVolumeThreshold(const float volume)
 {
   AddTask(CreateFunctor(&AudioMixer::mMinimumVolumeThresholdThreaded, this, volume), nullptr);
@@ -494,18 +553,12 @@ bool AudioMixer::MixCurrentInstancesThreaded()
   return true;
 }
 
-int SwapBufferIndexes(int* index)
-{
-  int current = *index;
-  *index = (current + 1) % 2;
-  return current;
-}
-
 void AudioMixer::HandleTasksThreaded()
 {
-  MixThreadTasksLock.Lock();
-  TaskListType& list = TasksForMixThread[SwapBufferIndexes(&mMixThreadTaskWriteIndex)];
-  MixThreadTasksLock.Unlock();
+  // Pull out the current tasks first so tasks added while executing wait
+  // until the next update
+  TaskListType& list = MixThreadTasksToExecute;
+  TasksForMixThread.Drain(list);
 
   forRange (AudioTask& task, list.All())
   {
@@ -518,9 +571,10 @@ void AudioMixer::HandleTasksThreaded()
 
 void AudioMixer::HandleTasks()
 {
-  GameThreadTasksLock.Lock();
-  TaskListType& list = TasksForGameThread[SwapBufferIndexes(&mGameThreadTaskWriteIndex)];
-  GameThreadTasksLock.Unlock();
+  // Pull out the current tasks first so tasks added while executing wait
+  // until the next update
+  TaskListType& list = GameThreadTasksToExecute;
+  TasksForGameThread.Drain(list);
 
   forRange (AudioTask& task, list.All())
   {
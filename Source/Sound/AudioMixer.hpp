@@ -15,10 +15,38 @@ public:
   AudioTask(const AudioTask& other);
   ~AudioTask();
 
+  // Takes ownership of the other task's functor, like the copy constructor
+  AudioTask& operator=(const AudioTask& other);
+
   Functor* mFunction;
   HandleOf<SoundNode> mObject;
 };
 
+// Audio Task Queue
+
+// Tasks that any thread can add to and one thread executes. Adding a task
+// doesn't allocate (the mix thread adds tasks too): tasks go into a fixed size
+// lock-free ring, and only when it's full into a locked overflow list, which
+// only allocates when it grows.
+class AudioTaskQueue
+{
+public:
+  AudioTaskQueue();
+
+  // Safe to call from any thread
+  void Push(const AudioTask& task);
+  // Consumer thread only. Moves all queued tasks onto the end of the list.
+  void Drain(Array<AudioTask>& tasks);
+
+private:
+  BoundedMpscQueue<AudioTask> mTasks;
+  Array<AudioTask> mOverflowTasks;
+  ThreadLock mOverflowLock;
+  // Set while there are overflow tasks so later tasks also go there
+  // (keeping each thread's tasks in order)
+  ThreadedInt mOverflowing;
+};
+
 // Audio Mixer
 
 class AudioMixer : public EventObject
@@ -61,6 +89,10 @@ public:
   float GetPeakOutputVolume();
   // Returns the RMS volume of the last audio mix.
   float GetRMSOutputVolume();
+  // Returns how long the last audio mix took on the mix thread, in seconds.
+  float GetLastMixTime();
+  // Returns the number of audio mixes completed since mixing started.
+  int GetMixCount();
   // Sets the minimum volume at which SoundInstances will process audio.
   void SetMinimumVolumeThreshold(const float volume);
   // If true, events will be sent with microphone input data as float samples
@@ -130,14 +162,14 @@ private:
   // For low frequency channel on 5.1 or 7.1 mix
   // Must be pointer because relies on audio system in constructor
   LowPassFilter* LowPass;
-  // Read and write task buffers for the mix thread
-  TaskListType TasksForMixThread[2];
-  // Lock used for switching mix thread task buffers
-  ThreadLock MixThreadTasksLock;
-  // Read and write task buffers for the game thread
-  TaskListType TasksForGameThread[2];
-  // Lock used for switching game thread task buffers
-  ThreadLock GameThreadTasksLock;
+  // Tasks queued for the mix thread (any thread can add to this)
+  AudioTaskQueue TasksForMixThread;
+  // Tasks pulled off the mix thread queue to execute
+  TaskListType MixThreadTasksToExecute;
+  // Tasks queued for the game thread (any thread can add to this)
+  AudioTaskQueue TasksForGameThread;
+  // Tasks pulled off the game thread queue to execute
+  TaskListType GameThreadTasksToExecute;
   // Object to get MIDI data from the operating system.
   MidiInput MidiObject;
   // Resampler object used to resample mixed output
@@ -151,10 +183,6 @@ private:
   // Stored microphone input samples when sending compressed input
   Array<float> PreviousInputSamples;
 
-  // Index of the mix thread task buffer to write to
-  int mMixThreadTaskWriteIndex;
-  // Index of the game thread task buffer to write to
-  int mGameThreadTaskWriteIndex;
   // To tell the system to shut down once everything stops.
   ThreadedInt mShuttingDown;
   // Overall system volume.
@@ -163,6 +191,12 @@ private:
   Threaded<float> mPeakVolumeLastMix;
   // The RMS volume value from the last mix.
   Threaded<float> mRmsVolumeLastMix;
+  // Times each mix on the mix thread.
+  Timer mMixTimerThreaded;
+  // How long the last mix took, in seconds (set on the mix thread).
+  Atomic<float> mLastMixTime;
+  // Number of completed mixes (incremented on the mix thread).
+  Atomic<s32> mMixCount;
   // The peak volume from the last mix, used to check whether to create a task
   float mPreviousPeakVolumeThreaded;
   // The RMS volume from the last mix, used to check whether to create a task